@@ -0,0 +1,13 @@
+include(CheckSymbolExists)
+
+if(IO_URING_FOUND)
+
+else()
+  # IORING_FEAT_RW_CUR_POS appeared together with IORING_OP_READ (Linux 5.6)
+  CHECK_SYMBOL_EXISTS(__NR_io_uring_setup "sys/syscall.h" HAVE_IO_URING_SYSCALL_INTERNAL)
+  CHECK_SYMBOL_EXISTS(IORING_FEAT_RW_CUR_POS "linux/io_uring.h" HAVE_IO_URING_READ_INTERNAL)
+  if(HAVE_IO_URING_SYSCALL_INTERNAL AND HAVE_IO_URING_READ_INTERNAL)
+    message(STATUS "io_uring found")
+    set(IO_URING_FOUND TRUE)
+  endif()
+endif()
@@ -28,6 +28,7 @@
 #include "galois/config.h"
 #include "galois/gstl.h"
 #include "galois/runtime/Executor_OnEach.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/PerThreadStorage.h"
 #include "galois/gIO.h"
 #include "galois/runtime/Mem.h"
@@ -150,7 +151,14 @@ private:
     return H;
   }
 
+  static size_t blockBytes() {
+    return BlockSize ? BlockSize : galois::runtime::pagePoolSize();
+  }
+
   header* newHeader() {
+    galois::substrate::memAccount(galois::substrate::MemCategory::InsertBag,
+                                  blockBytes(),
+                                  galois::substrate::ThreadPool::getNumaNode());
     if (BlockSize) {
       return newHeaderFromHeap(heap.allocate(BlockSize), BlockSize);
     } else {
@@ -159,6 +167,17 @@ private:
     }
   }
 
+  //! Free a block of the given thread
+  void freeHeader(header* h, unsigned tid) {
+    galois::substrate::memAccount(
+        galois::substrate::MemCategory::InsertBag, -int64_t(blockBytes()),
+        galois::substrate::getThreadPool().getNumaNode(tid));
+    if (BlockSize)
+      heap.deallocate(h);
+    else
+      galois::runtime::pagePoolFree(h);
+  }
+
   void destruct_serial() {
     for (unsigned x = 0; x < heads.size(); ++x) {
       PerThread& hpair = *heads.getRemote(x);
@@ -167,10 +186,7 @@ private:
         uninitialized_destroy(h->dbegin, h->dend);
         header* h2 = h;
         h          = h->next;
-        if (BlockSize)
-          heap.deallocate(h2);
-        else
-          galois::runtime::pagePoolFree(h2);
+        freeHeader(h2, x);
       }
       hpair.second = 0;
     }
@@ -185,10 +201,7 @@ private:
             uninitialized_destroy(h->dbegin, h->dend);
             header* h2 = h;
             h          = h->next;
-            if (BlockSize)
-              heap.deallocate(h2);
-            else
-              galois::runtime::pagePoolFree(h2);
+            freeHeader(h2, tid);
           }
           hpair.second = 0;
         },
@@ -36,6 +36,7 @@
 #include "galois/ParallelSTL.h"
 #include "galois/runtime/Mem.h"
 #include "galois/substrate/NumaMem.h"
+#include "galois/substrate/PageAlloc.h"
 
 namespace galois {
 
@@ -288,6 +289,11 @@ public:
   template <typename U = T>
   std::enable_if_t<std::is_scalar<U>::value> destroyAt(size_type) {}
 
+  //! Number of huge pages backing this array
+  size_t numHugePages() const {
+    return m_data ? substrate::numHugePages(m_data, m_size * sizeof(T)) : 0;
+  }
+
   // The following methods are not shared with void specialization
   const_pointer data() const { return m_data; }
   pointer data() { return m_data; }
@@ -359,6 +365,8 @@ public:
   void destroy() {}
   void destroyAt(size_type) {}
 
+  size_t numHugePages() const { return 0; }
+
   const_pointer data() const { return 0; }
   pointer data() { return 0; }
 };
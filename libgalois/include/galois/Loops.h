@@ -23,6 +23,7 @@
 #include "galois/config.h"
 #include "galois/runtime/Executor_Deterministic.h"
 #include "galois/runtime/Executor_DoAll.h"
+#include "galois/runtime/Executor_EdgeTiled.h"
 #include "galois/runtime/Executor_ForEach.h"
 #include "galois/runtime/Executor_OnEach.h"
 #include "galois/runtime/Executor_Ordered.h"
@@ -73,6 +74,49 @@ void do_all(const RangeFunc& rangeMaker, FunctionTy&& fn, const Args&... args) {
   runtime::do_all_gen(rangeMaker(tpl), std::forward<FunctionTy>(fn), tpl);
 }
 
+/**
+ * Do-all loop over the out-edges of a range of graph nodes. Operator should
+ * conform to <code>fn(node, beg, end)</code> where [beg, end) is a range of
+ * edge iterators of node. Nodes with more edges than the tile size (@see
+ * edge_tile) are split into several ranges that are scheduled separately, so
+ * fn may be called concurrently for the same node with disjoint ranges.
+ *
+ * @param graph graph whose edges are visited
+ * @param rangeMaker an iterate range maker over nodes of graph
+ * @param fn operator
+ * @param args optional arguments to loop, e.g., {@see edge_tile}
+ */
+template <typename Graph, typename RangeFunc, typename FunctionTy,
+          typename... Args>
+void do_all_edges(Graph& graph, const RangeFunc& rangeMaker, FunctionTy&& fn,
+                  const Args&... args) {
+  auto tpl = std::make_tuple(args...);
+  runtime::do_all_edges_gen(graph, rangeMaker(tpl),
+                            std::forward<FunctionTy>(fn), tpl);
+}
+
+/**
+ * Unordered set iterator over the out-edges of graph nodes. Operator should
+ * conform to <code>fn(node, beg, end, ctx)</code> where [beg, end) is a range
+ * of edge iterators of node and ctx is a runtime::EdgeTileContext. Pushing a
+ * node on ctx schedules its edges, split into tiles as in {@link
+ * do_all_edges()}. Worklists given with {@see wl} hold runtime::EdgeTile
+ * items.
+ *
+ * @param graph graph whose edges are visited
+ * @param rangeMaker an iterate range maker over the initial nodes
+ * @param fn operator
+ * @param args optional arguments to loop, e.g., {@see edge_tile}
+ */
+template <typename Graph, typename RangeFunc, typename FunctionTy,
+          typename... Args>
+void for_each_edges(Graph& graph, const RangeFunc& rangeMaker,
+                    FunctionTy&& fn, const Args&... args) {
+  auto tpl = std::make_tuple(args...);
+  runtime::for_each_edges_gen(graph, rangeMaker(tpl),
+                              std::forward<FunctionTy>(fn), tpl);
+}
+
 /**
  * Low-level parallel loop. Operator is applied for each running thread.
  * Operator should confirm to <code>fn(tid, numThreads)</code> where tid is
@@ -36,6 +36,14 @@ typedef galois::runtime::ExternalHeapAllocator<char, IterAllocBaseTy>
     PerIterAllocTy;
 //! [PerIterAllocTy example]
 
+//! Base allocator for per-loop allocator
+typedef galois::runtime::ArenaHeap PerLoopAllocBaseTy;
+
+//! Per-loop allocator that conforms to STL allocator interface. Memory is
+//! only released, all at once, when the loop ends.
+typedef galois::runtime::ExternalHeapAllocator<char, PerLoopAllocBaseTy>
+    PerLoopAllocTy;
+
 //! Scalable fixed-sized allocator for T that conforms to STL allocator
 //! interface but does not support variable sized allocations
 template <typename Ty>
@@ -0,0 +1,130 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file galois/SetIntersection.h
+ *
+ * Intersection of sorted lists of node ids, the inner loop of triangle
+ * counting, k-truss and clique mining. Lists must be strictly increasing
+ * (sorted, without duplicates).
+ */
+
+#ifndef GALOIS_SETINTERSECTION_H
+#define GALOIS_SETINTERSECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "galois/config.h"
+
+namespace galois {
+
+//! Ways to intersect two sorted lists
+enum class IntersectKernel {
+  //! Choose by CPU features and the ratio of the list sizes
+  Auto,
+  //! Scalar merge
+  Merge,
+  //! Exponential then binary search of the shorter list's elements in the
+  //! longer list; best when the sizes are very different
+  Galloping,
+  //! Merge comparing blocks of 8 x 8 elements with AVX2
+  AVX2,
+  //! Merge comparing blocks of 16 x 16 elements with AVX-512; never chosen
+  //! by Auto because the 16 cross-lane rotations cost more than they save
+  AVX512
+};
+
+/**
+ * Size ratio from which Auto switches from the merge kernels to galloping.
+ */
+constexpr static const size_t INTERSECT_GALLOPING_RATIO = 128;
+
+//! True if this build and the CPU can run kernel k
+bool intersectKernelSupported(IntersectKernel k);
+
+//! Kernel that Auto resolves to for lists of sizes na and nb
+IntersectKernel selectIntersectKernel(size_t na, size_t nb);
+
+//! Name of kernel k, for output
+const char* intersectKernelName(IntersectKernel k);
+
+/**
+ * Returns the number of elements common to a[0, na) and b[0, nb).
+ *
+ * @param k kernel to use; must be supported (see intersectKernelSupported)
+ */
+size_t intersectCount(const uint32_t* a, size_t na, const uint32_t* b,
+                      size_t nb, IntersectKernel k = IntersectKernel::Auto);
+
+/**
+ * Finds the elements common to a[0, na) and b[0, nb). For the i-th common
+ * element (in increasing order), writes its index in a to posA[i] and its
+ * index in b to posB[i]. Both arrays need room for min(na, nb) entries.
+ *
+ * @returns the number of common elements
+ */
+size_t intersectPositions(const uint32_t* a, size_t na, const uint32_t* b,
+                          size_t nb, uint32_t* posA, uint32_t* posB,
+                          IntersectKernel k = IntersectKernel::Auto);
+
+/**
+ * Bitmap over node ids for intersecting many lists with one large (hub)
+ * list: set the hub's list once, then each intersection costs one bit test
+ * per element of the other list regardless of the hub's size. Not thread
+ * safe; keep one per thread.
+ */
+class IntersectBitmap {
+  std::vector<uint64_t> words;
+
+public:
+  //! Allows ids in [0, universe)
+  void resize(size_t universe) { words.assign((universe + 63) / 64, 0); }
+
+  //! True until the first resize
+  bool empty() const { return words.empty(); }
+
+  bool test(uint32_t x) const { return words[x / 64] >> (x % 64) & 1; }
+
+  //! Adds the elements of a[0, n)
+  void set(const uint32_t* a, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      words[a[i] / 64] |= uint64_t(1) << (a[i] % 64);
+  }
+
+  //! Clears the bitmap after set(a, n) without touching all of it. Also
+  //! clears other elements sharing a word with those of a.
+  void reset(const uint32_t* a, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      words[a[i] / 64] = 0;
+  }
+
+  //! Number of elements of b[0, nb) in the bitmap
+  size_t count(const uint32_t* b, size_t nb) const {
+    size_t c = 0;
+    for (size_t i = 0; i < nb; ++i)
+      c += test(b[i]);
+    return c;
+  }
+};
+
+} // namespace galois
+
+#endif
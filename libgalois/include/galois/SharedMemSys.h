@@ -1,6 +1,8 @@
 #ifndef GALOIS_SHAREDMEMSYS_H
 #define GALOIS_SHAREDMEMSYS_H
 
+#include <chrono>
+
 #include "galois/config.h"
 #include "galois/runtime/SharedMem.h"
 
@@ -14,6 +16,12 @@ class SharedMemSys : public runtime::SharedMem<runtime::StatManager> {
 
 public:
   explicit SharedMemSys();
+  /**
+   * @param idleSpin how long worker threads spin waiting for the next
+   * parallel loop before going to sleep. Longer spins reduce the start-up
+   * latency of back-to-back loops at the cost of idle CPU time.
+   */
+  explicit SharedMemSys(std::chrono::microseconds idleSpin);
   ~SharedMemSys();
 
   SharedMemSys(const SharedMemSys&) = delete;
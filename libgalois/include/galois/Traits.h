@@ -20,6 +20,7 @@
 #ifndef GALOIS_TRAITS_H
 #define GALOIS_TRAITS_H
 
+#include <cstddef>
 #include <tuple>
 #include <type_traits>
 
@@ -165,6 +166,27 @@ constexpr auto get_default_trait_values(S source, T tags, D defaults) {
   return get_default_trait_values(seq, source, tags, defaults);
 }
 
+template <typename T, typename... Tags>
+constexpr auto keep_trait(T trait) {
+  if constexpr ((at_least_base_of<Tags, T> || ...))
+    return std::make_tuple();
+  else
+    return std::make_tuple(trait);
+}
+
+/**
+ * Returns source without the elements matching any of the traits Tags, e.g.,
+ * to pass the remaining traits of a loop on to another loop.
+ */
+template <typename... Tags, typename... Ts>
+constexpr auto remove_traits(std::tuple<Ts...> source) {
+  return std::apply(
+      [](auto... traits) {
+        return std::tuple_cat(keep_trait<decltype(traits), Tags...>(traits)...);
+      },
+      source);
+}
+
 template <typename T>
 constexpr auto has_function_traits(int)
     -> decltype(std::declval<typename T::function_traits>(), bool()) {
@@ -240,6 +262,14 @@ struct no_pushes : public trait_has_type<bool>, no_pushes_tag {};
 struct per_iter_alloc_tag {};
 struct per_iter_alloc : public trait_has_type<bool>, per_iter_alloc_tag {};
 
+/**
+ * Indicates the operator may request the access to a per-loop allocator,
+ * whose memory is released in bulk when the loop finishes. Only supported by
+ * the non-deterministic {@link for_each()} executor.
+ */
+struct per_loop_alloc_tag {};
+struct per_loop_alloc : public trait_has_type<bool>, per_loop_alloc_tag {};
+
 /**
  * Indicates the operator doesn't need its execution stats recorded
  */
@@ -366,6 +396,37 @@ public:
   chunk_size(unsigned cs = SZ) : trait_has_value(clamp(cs)) {}
 };
 
+/**
+ * Indicates the loop should choose its chunk size at runtime, growing chunks
+ * that execute quickly and shrinking them when they are slow or when threads
+ * run out of local work. The static chunk size is used as the starting
+ * point.
+ *
+ * Applies to {@link do_all()} loops with {@link steal} and to {@link
+ * for_each()} loops whose worklist is chunked. The final chunk sizes are
+ * reported in the loop statistics.
+ */
+struct adaptive_chunk_size_tag {};
+struct adaptive_chunk_size : public trait_has_type<bool>,
+                             adaptive_chunk_size_tag {};
+
+/**
+ * Maximum number of edges of a node that {@link do_all_edges()} and {@link
+ * for_each_edges()} pass to one call of the operator. Nodes with more edges
+ * are split into tiles of this many edges, which are scheduled as independent
+ * work items. The default size of 0, e.g., galois::edge_tile<>(), chooses the
+ * size at runtime from the average degree of the graph.
+ *
+ * Explicit sizes are clamped to at least edge_tile_tag::MIN
+ */
+struct edge_tile_tag {
+  enum { MIN = 16 };
+};
+template <ptrdiff_t SZ = 0>
+struct edge_tile : public trait_has_value<ptrdiff_t>, edge_tile_tag {
+  edge_tile(ptrdiff_t sz = SZ) : trait_has_value(sz) {}
+};
+
 typedef worklists::PerSocketChunkFIFO<chunk_size<>::value> defaultWL;
 
 namespace internal {
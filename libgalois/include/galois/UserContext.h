@@ -45,6 +45,7 @@ protected:
   //! Allocator stuff
   IterAllocBaseTy IterationAllocatorBase;
   PerIterAllocTy PerIterationAllocator;
+  PerLoopAllocTy* PerLoopAllocator = nullptr;
 
   //! used by all
   bool* didBreak = nullptr;
@@ -56,6 +57,8 @@ protected:
 
   void __resetAlloc() { IterationAllocatorBase.clear(); }
 
+  void __setPerLoopAlloc(PerLoopAllocTy* a) { PerLoopAllocator = a; }
+
   void __setFirstPass(void) { firstPassFlag = true; }
 
   void __resetFirstPass(void) { firstPassFlag = false; }
@@ -80,6 +83,13 @@ public:
   //! Acquire a per-iteration allocator
   PerIterAllocTy& getPerIterAlloc() { return PerIterationAllocator; }
 
+  //! Acquire a per-loop allocator; requires the per_loop_alloc trait.
+  //! Memory from aborted iterations is also only released at loop exit.
+  PerLoopAllocTy& getPerLoopAlloc() {
+    assert(PerLoopAllocator);
+    return *PerLoopAllocator;
+  }
+
   //! Push new work
   template <typename... Args>
   void push(Args&&... args) {
@@ -0,0 +1,637 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_DELTAGRAPH_H
+#define GALOIS_GRAPHS_DELTAGRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/substrate/MemAccounting.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/SimpleLock.h"
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+
+/**
+ * Logged edge update; later entries for the same destination win. The
+ * entries a batch logs for a node form a run sorted by destination, with
+ * updates to the same destination kept in the order they were issued.
+ */
+template <typename EdgeTy>
+struct DeltaEntry {
+  uint32_t dst;
+  uint32_t epoch;
+  //! Position of the first entry of the run this entry belongs to
+  uint32_t runBegin;
+  bool removed;
+  StrictObject<EdgeTy> value;
+};
+
+//! Bit of the per-node filter that summarizes which destinations are logged
+inline uint64_t deltaFilterBit(uint32_t dst) {
+  return UINT64_C(1) << ((dst * UINT64_C(0x9E3779B97F4A7C15)) >> 58);
+}
+
+/**
+ * Iterates the edges of a node as seen by a snapshot: first the base edges
+ * whose destination has no visible log entry, then the visible inserts of
+ * the log that are not overridden by a later entry. Dereferencing yields the
+ * destination.
+ */
+template <typename EdgeTy>
+class DeltaEdgeIterator
+    : public boost::iterator_facade<DeltaEdgeIterator<EdgeTy>, uint32_t,
+                                    boost::forward_traversal_tag, uint32_t> {
+  friend class boost::iterator_core_access;
+  typedef DeltaEntry<EdgeTy> Entry;
+
+  const uint32_t* baseDst;
+  uint64_t cur;
+  uint64_t last;
+  const Entry* log;
+  uint32_t logCur;
+  uint32_t logCount;
+  uint64_t filter;
+
+  //! Whether a visible entry at or after position from is for dst; binary
+  //! searches each run, newest first
+  bool loggedFrom(uint32_t from, uint32_t dst) const {
+    for (uint32_t end = logCount; end > from;) {
+      uint32_t runBegin  = log[end - 1].runBegin;
+      const Entry* first = std::lower_bound(
+          log + std::max(runBegin, from), log + end, dst,
+          [](const Entry& e, uint32_t d) { return e.dst < d; });
+      if (first != log + end && first->dst == dst)
+        return true;
+      end = runBegin;
+    }
+    return false;
+  }
+
+  bool logged(uint32_t dst) const {
+    return (filter & deltaFilterBit(dst)) && loggedFrom(0, dst);
+  }
+
+  bool superseded(uint32_t i) const {
+    return log[i].removed || loggedFrom(i + 1, log[i].dst);
+  }
+
+  void settle() {
+    while (cur != last && logged(baseDst[cur]))
+      ++cur;
+    if (cur != last)
+      return;
+    while (logCur != logCount && superseded(logCur))
+      ++logCur;
+  }
+
+  void increment() {
+    if (cur != last)
+      ++cur;
+    else
+      ++logCur;
+    settle();
+  }
+
+  bool equal(const DeltaEdgeIterator& other) const {
+    return cur == other.cur && logCur == other.logCur;
+  }
+
+  uint32_t dereference() const { return getDst(); }
+
+public:
+  DeltaEdgeIterator()
+      : baseDst(nullptr), cur(0), last(0), log(nullptr), logCur(0),
+        logCount(0), filter(0) {}
+
+  /**
+   * @param d destinations of the base graph
+   * @param first first base edge of the node
+   * @param l one past the last base edge of the node
+   * @param lg log entries of the node
+   * @param count number of log entries visible to the snapshot
+   * @param f destination filter of the log
+   * @param atEnd construct the end iterator
+   */
+  DeltaEdgeIterator(const uint32_t* d, uint64_t first, uint64_t l,
+                    const Entry* lg, uint32_t count, uint64_t f, bool atEnd)
+      : baseDst(d), cur(atEnd ? l : first), last(l), log(lg),
+        logCur(atEnd ? count : 0), logCount(count), filter(f) {
+    if (!atEnd)
+      settle();
+  }
+
+  //! True if the current edge comes from the base graph
+  bool inBase() const { return cur != last; }
+  //! Base edge id of the current edge; only valid if inBase()
+  uint64_t baseEdge() const { return cur; }
+  //! Log entry of the current edge; only valid if !inBase()
+  const Entry& entry() const { return log[logCur]; }
+
+  uint32_t getDst() const {
+    return inBase() ? baseDst[cur] : log[logCur].dst;
+  }
+};
+
+} // namespace internal
+
+/**
+ * Graph with a fixed set of nodes whose edges change over time. Edges live
+ * in an immutable CSR base plus a per-node append-only log of inserts and
+ * removals, so updates do not touch the base and readers never block.
+ *
+ * Updates ({@link insertEdge}, {@link removeEdge}) may be issued from any
+ * thread, including from inside parallel loops; they are buffered per
+ * thread and become visible as one batch when {@link applyUpdates} is
+ * called. Algorithms run on a {@link Snapshot}, which exposes the usual
+ * graph API (edges, getEdgeDst, getEdgeData, getData) over the batches
+ * applied when it was taken and is not affected by later batches or
+ * compactions. {@link compact} folds the logs into a new CSR base in
+ * parallel; it runs automatically once the logs exceed a fraction of the
+ * base (see {@link setCompactionRatio}).
+ *
+ * applyUpdates, compact and snapshot must be called from one controlling
+ * thread outside parallel loops. A removal deletes all edges between the
+ * two nodes; an insert of an existing edge replaces its data. Node data is
+ * shared by all snapshots.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template <typename NodeTy, typename EdgeTy>
+class DeltaGraph : private boost::noncopyable {
+public:
+  typedef read_default_graph_tag read_tag;
+
+  typedef uint32_t GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef EdgeTy file_edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef boost::counting_iterator<uint32_t> iterator;
+  typedef iterator const_iterator;
+
+protected:
+  typedef internal::DeltaEntry<EdgeTy> Entry;
+  typedef internal::NodeInfoBaseTypes<NodeTy, false> NodeInfoTypes;
+  typedef internal::NodeInfoBase<NodeTy, false> NodeInfo;
+  typedef LargeArray<NodeInfo> NodeData;
+  typedef LargeArray<EdgeTy> EdgeData;
+
+  //! Immutable CSR part of the graph
+  struct Base {
+    LargeArray<uint64_t> edgeIndData;
+    LargeArray<uint32_t> edgeDst;
+    EdgeData edgeData;
+
+    uint64_t edgeBegin(GraphNode N) const {
+      return (N == 0) ? 0 : edgeIndData[N - 1];
+    }
+    uint64_t sizeEdges() const { return edgeDst.size(); }
+  };
+
+  //! Append-only log of one node; only one thread appends at a time
+  struct VertexLog {
+    std::atomic<Entry*> entries{nullptr};
+    std::atomic<uint32_t> size{0};
+    uint32_t capacity = 0;
+    std::atomic<uint64_t> filter{0};
+  };
+
+  /**
+   * Logs of all nodes. Readers load the size of a log before its entries, and
+   * arrays replaced while growing are kept until the logs are destroyed, so
+   * readers never see freed or unpublished entries.
+   */
+  struct Logs {
+    LargeArray<VertexLog> logs;
+    std::vector<Entry*> retired;
+    substrate::SimpleLock retiredLock;
+    std::atomic<uint64_t> numEntries{0};
+
+    explicit Logs(size_t numNodes) {
+      substrate::MemCategoryScope memScope(substrate::MemCategory::Graph);
+      logs.create(numNodes);
+    }
+
+    ~Logs() {
+      for (size_t n = 0; n < logs.size(); ++n)
+        delete[] logs[n].entries.load(std::memory_order_relaxed);
+      for (Entry* e : retired)
+        delete[] e;
+    }
+
+    void append(GraphNode src, const Entry& entry) {
+      VertexLog& l = logs[src];
+      uint32_t sz  = l.size.load(std::memory_order_relaxed);
+      Entry* arr   = l.entries.load(std::memory_order_relaxed);
+      if (sz == l.capacity) {
+        l.capacity = std::max(4u, 2 * l.capacity);
+        Entry* next = new Entry[l.capacity];
+        std::copy(arr, arr + sz, next);
+        if (arr) {
+          std::lock_guard<substrate::SimpleLock> lg(retiredLock);
+          retired.push_back(arr);
+        }
+        l.entries.store(next, std::memory_order_release);
+        arr = next;
+      }
+      arr[sz] = entry;
+      l.filter.fetch_or(internal::deltaFilterBit(entry.dst),
+                        std::memory_order_relaxed);
+      l.size.store(sz + 1, std::memory_order_release);
+    }
+  };
+
+  struct Update {
+    GraphNode src;
+    GraphNode dst;
+    bool removed;
+    uint64_t order;
+    StrictObject<EdgeTy> value;
+  };
+
+  struct PendingUpdates {
+    substrate::SimpleLock lock;
+    std::vector<Update> updates;
+  };
+
+public:
+  /**
+   * Consistent read-only view of a {@link DeltaGraph}. Copies are cheap and
+   * share the underlying storage, which stays alive as long as any snapshot
+   * refers to it.
+   */
+  class Snapshot {
+    friend class DeltaGraph;
+
+    DeltaGraph* graph = nullptr;
+    std::shared_ptr<const Base> base;
+    std::shared_ptr<const Logs> logs;
+    uint32_t epoch = 0;
+
+    Snapshot(DeltaGraph* g, std::shared_ptr<const Base> b,
+             std::shared_ptr<const Logs> l, uint32_t e)
+        : graph(g), base(std::move(b)), logs(std::move(l)), epoch(e) {}
+
+    //! Number of log entries of N visible to this snapshot
+    uint32_t visibleLog(GraphNode N, const Entry*& entries,
+                        uint64_t& filter) const {
+      const VertexLog& l = logs->logs[N];
+      uint32_t count     = l.size.load(std::memory_order_acquire);
+      entries            = l.entries.load(std::memory_order_acquire);
+      while (count && entries[count - 1].epoch > epoch)
+        --count;
+      filter = count ? l.filter.load(std::memory_order_relaxed) : 0;
+      return count;
+    }
+
+  public:
+    typedef DeltaGraph::GraphNode GraphNode;
+    typedef EdgeTy edge_data_type;
+    typedef NodeTy node_data_type;
+    typedef typename EdgeData::const_reference edge_data_reference;
+    typedef typename NodeInfoTypes::reference node_data_reference;
+    typedef internal::DeltaEdgeIterator<EdgeTy> edge_iterator;
+    typedef DeltaGraph::iterator iterator;
+    typedef iterator const_iterator;
+
+    Snapshot() = default;
+
+    //! Epoch of the last batch of updates visible to this snapshot
+    uint32_t getEpoch() const { return epoch; }
+
+    size_t size() const { return graph->numNodes; }
+
+    //! Number of edges; counts the edges of every node in parallel
+    size_t sizeEdges() const {
+      if (logs->numEntries == 0)
+        return base->sizeEdges();
+      galois::GAccumulator<size_t> count;
+      galois::do_all(
+          galois::iterate(begin(), end()),
+          [&](GraphNode n) { count += getDegree(n); }, galois::no_stats(),
+          galois::steal(), galois::loopname("DeltaGraphSizeEdges"));
+      return count.reduce();
+    }
+
+    iterator begin() const { return iterator(0); }
+    iterator end() const { return iterator(graph->numNodes); }
+
+    node_data_reference getData(GraphNode N,
+                                MethodFlag GALOIS_UNUSED(mflag) =
+                                    MethodFlag::UNPROTECTED) const {
+      return graph->nodeData[N].getData();
+    }
+
+    edge_data_reference getEdgeData(const edge_iterator& ni,
+                                    MethodFlag GALOIS_UNUSED(mflag) =
+                                        MethodFlag::UNPROTECTED) const {
+      if (ni.inBase())
+        return base->edgeData[ni.baseEdge()];
+      return ni.entry().value.get();
+    }
+
+    GraphNode getEdgeDst(const edge_iterator& ni) const { return ni.getDst(); }
+
+    edge_iterator edge_begin(GraphNode N,
+                             MethodFlag GALOIS_UNUSED(mflag) =
+                                 MethodFlag::UNPROTECTED) const {
+      const Entry* entries;
+      uint64_t filter;
+      uint32_t count = visibleLog(N, entries, filter);
+      return edge_iterator(base->edgeDst.data(), base->edgeBegin(N),
+                           base->edgeIndData[N], entries, count, filter,
+                           false);
+    }
+
+    edge_iterator edge_end(GraphNode N,
+                           MethodFlag GALOIS_UNUSED(mflag) =
+                               MethodFlag::UNPROTECTED) const {
+      const Entry* entries;
+      uint64_t filter;
+      uint32_t count = visibleLog(N, entries, filter);
+      return edge_iterator(base->edgeDst.data(), base->edgeBegin(N),
+                           base->edgeIndData[N], entries, count, filter, true);
+    }
+
+    runtime::iterable<NoDerefIterator<edge_iterator>>
+    edges(GraphNode N, MethodFlag mflag = MethodFlag::UNPROTECTED) const {
+      return internal::make_no_deref_range(edge_begin(N, mflag),
+                                           edge_end(N, mflag));
+    }
+
+    runtime::iterable<NoDerefIterator<edge_iterator>>
+    out_edges(GraphNode N, MethodFlag mflag = MethodFlag::UNPROTECTED) const {
+      return edges(N, mflag);
+    }
+
+    //! Out-degree of N; linear in the degree when N has logged updates
+    uint64_t getDegree(GraphNode N) const {
+      if (logs->logs[N].size.load(std::memory_order_acquire) == 0)
+        return base->edgeIndData[N] - base->edgeBegin(N);
+      return std::distance(edge_begin(N), edge_end(N));
+    }
+  };
+
+  typedef typename Snapshot::edge_data_reference edge_data_reference;
+  typedef typename NodeInfoTypes::reference node_data_reference;
+  typedef typename Snapshot::edge_iterator edge_iterator;
+
+protected:
+  NodeData nodeData;
+  uint64_t numNodes = 0;
+
+  std::mutex versionLock;
+  std::shared_ptr<Base> base;
+  std::shared_ptr<Logs> logs;
+  std::atomic<uint32_t> epoch{0};
+
+  substrate::PerThreadStorage<PendingUpdates> pending;
+  double compactionRatio = 0.25;
+
+  void push(const Update& u) {
+    PendingUpdates& p = *pending.getLocal();
+    std::lock_guard<substrate::SimpleLock> lg(p.lock);
+    p.updates.push_back(u);
+  }
+
+  void allocateBase(Base& b, uint64_t numEdges) {
+    b.edgeIndData.allocateInterleaved(numNodes);
+    b.edgeDst.allocateInterleaved(numEdges);
+    b.edgeData.allocateInterleaved(numEdges);
+  }
+
+public:
+  DeltaGraph() = default;
+
+  size_t size() const { return numNodes; }
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  node_data_reference getData(GraphNode N,
+                              MethodFlag GALOIS_UNUSED(mflag) =
+                                  MethodFlag::UNPROTECTED) {
+    return nodeData[N].getData();
+  }
+
+  //! Epoch of the last applied batch of updates
+  uint32_t getEpoch() const { return epoch.load(std::memory_order_acquire); }
+
+  //! Number of edges in the current base
+  size_t sizeBaseEdges() {
+    std::lock_guard<std::mutex> lg(versionLock);
+    return base->sizeEdges();
+  }
+
+  //! Number of log entries applied since the last compaction
+  size_t sizeDelta() {
+    std::lock_guard<std::mutex> lg(versionLock);
+    return logs->numEntries;
+  }
+
+  /**
+   * Sets the ratio of log entries to base edges above which
+   * {@link applyUpdates} compacts the graph; 0 disables compaction.
+   */
+  void setCompactionRatio(double ratio) { compactionRatio = ratio; }
+
+  //! Queues the insert of edge src -> dst; visible after applyUpdates()
+  template <typename... Args>
+  void insertEdge(GraphNode src, GraphNode dst, Args&&... args) {
+    push(Update{src, dst, false, 0,
+                StrictObject<EdgeTy>(std::forward<Args>(args)...)});
+  }
+
+  //! Queues the removal of all edges src -> dst; visible after applyUpdates()
+  void removeEdge(GraphNode src, GraphNode dst) {
+    push(Update{src, dst, true, 0, StrictObject<EdgeTy>()});
+  }
+
+  //! Current view of the graph
+  Snapshot snapshot() {
+    std::lock_guard<std::mutex> lg(versionLock);
+    return Snapshot(this, base, logs, getEpoch());
+  }
+
+  /**
+   * Makes all queued updates visible as one batch. Updates queued by the
+   * same thread are applied in order. Snapshots taken earlier do not see
+   * the batch.
+   *
+   * @returns epoch of the batch
+   */
+  uint32_t applyUpdates() {
+    std::vector<Update> batch;
+    for (unsigned t = 0; t < pending.size(); ++t) {
+      PendingUpdates& p = *pending.getRemote(t);
+      std::lock_guard<substrate::SimpleLock> lg(p.lock);
+      for (Update& u : p.updates) {
+        u.order = batch.size();
+        batch.push_back(u);
+      }
+      p.updates.clear();
+    }
+    if (batch.empty())
+      return getEpoch();
+
+    galois::ParallelSTL::sort(batch.begin(), batch.end(),
+                              [](const Update& a, const Update& b) {
+                                if (a.src != b.src)
+                                  return a.src < b.src;
+                                if (a.dst != b.dst)
+                                  return a.dst < b.dst;
+                                return a.order < b.order;
+                              });
+
+    std::shared_ptr<Logs> current;
+    {
+      std::lock_guard<std::mutex> lg(versionLock);
+      current = logs;
+    }
+    uint32_t next = getEpoch() + 1;
+    galois::do_all(
+        galois::iterate(size_t{0}, batch.size()),
+        [&](size_t i) {
+          if (i != 0 && batch[i - 1].src == batch[i].src)
+            return;
+          uint32_t runBegin = current->logs[batch[i].src].size.load(
+              std::memory_order_relaxed);
+          for (size_t j = i; j < batch.size() && batch[j].src == batch[i].src;
+               ++j) {
+            const Update& u = batch[j];
+            current->append(u.src,
+                            Entry{u.dst, next, runBegin, u.removed, u.value});
+          }
+        },
+        galois::no_stats(), galois::steal(),
+        galois::loopname("DeltaGraphApply"));
+
+    bool full;
+    {
+      std::lock_guard<std::mutex> lg(versionLock);
+      logs->numEntries.fetch_add(batch.size());
+      epoch.store(next, std::memory_order_release);
+      full = compactionRatio > 0 &&
+             logs->numEntries > compactionRatio * base->sizeEdges();
+    }
+    if (full)
+      compact();
+    return next;
+  }
+
+  /**
+   * Merges the logs into a new CSR base. Existing snapshots keep the old
+   * base and logs alive until they are destroyed.
+   */
+  void compact() {
+    substrate::MemCategoryScope memScope(substrate::MemCategory::Graph);
+    Snapshot s = snapshot();
+    auto next  = std::make_shared<Base>();
+
+    next->edgeIndData.allocateInterleaved(numNodes);
+    galois::do_all(
+        galois::iterate(s.begin(), s.end()),
+        [&](GraphNode n) { next->edgeIndData[n] = s.getDegree(n); },
+        galois::no_stats(), galois::steal(),
+        galois::loopname("DeltaGraphCompactDegree"));
+    galois::ParallelSTL::partial_sum(next->edgeIndData.begin(),
+                                     next->edgeIndData.end(),
+                                     next->edgeIndData.begin());
+
+    uint64_t numEdges = numNodes ? next->edgeIndData[numNodes - 1] : 0;
+    next->edgeDst.allocateInterleaved(numEdges);
+    next->edgeData.allocateInterleaved(numEdges);
+    galois::do_all(
+        galois::iterate(s.begin(), s.end()),
+        [&](GraphNode n) {
+          uint64_t e = next->edgeBegin(n);
+          for (auto ii : s.edges(n)) {
+            next->edgeDst[e] = s.getEdgeDst(ii);
+            if constexpr (EdgeData::has_value)
+              next->edgeData.set(e, s.getEdgeData(ii));
+            ++e;
+          }
+        },
+        galois::no_stats(), galois::steal(),
+        galois::loopname("DeltaGraphCompactFill"));
+
+    auto empty = std::make_shared<Logs>(numNodes);
+    std::lock_guard<std::mutex> lg(versionLock);
+    base = std::move(next);
+    logs = std::move(empty);
+  }
+
+  void allocateFrom(FileGraph& graph) {
+    substrate::MemCategoryScope memScope(substrate::MemCategory::Graph);
+    numNodes = graph.size();
+    nodeData.allocateInterleaved(numNodes);
+    base = std::make_shared<Base>();
+    allocateBase(*base, graph.sizeEdges());
+    logs = std::make_shared<Logs>(numNodes);
+  }
+
+  void constructFrom(FileGraph& graph, unsigned tid, unsigned total,
+                     const bool readUnweighted = false) {
+    auto r = graph
+                 .divideByNode(NodeData::size_of::value + sizeof(uint64_t),
+                               sizeof(uint32_t) + EdgeData::size_of::value,
+                               tid, total)
+                 .first;
+
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      GraphNode n = *ii;
+      nodeData.constructAt(n);
+      base->edgeIndData[n] = *graph.edge_end(n);
+      for (FileGraph::edge_iterator nn = graph.edge_begin(n),
+                                    en = graph.edge_end(n);
+           nn != en; ++nn) {
+        base->edgeDst[*nn] = graph.getEdgeDst(nn);
+        if constexpr (EdgeData::has_value) {
+          if (readUnweighted)
+            base->edgeData.set(*nn, {});
+          else
+            base->edgeData.set(*nn, graph.getEdgeData<EdgeTy>(nn));
+        }
+      }
+    }
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
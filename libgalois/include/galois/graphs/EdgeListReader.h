@@ -0,0 +1,362 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_EDGELISTREADER_H
+#define GALOIS_GRAPHS_EDGELISTREADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/utility.hpp>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/LazyObject.h"
+#include "galois/Reduction.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+
+//! Read-only mapping of a whole text file
+class MappedTextFile : private boost::noncopyable {
+  int fd              = -1;
+  const char* mapping = nullptr;
+  size_t length       = 0;
+
+  //! First line start at or after offset
+  size_t lineStart(size_t offset) const;
+
+public:
+  explicit MappedTextFile(const std::string& filename);
+  ~MappedTextFile();
+
+  const char* begin() const { return mapping; }
+  const char* end() const { return mapping + length; }
+  size_t size() const { return length; }
+
+  /**
+   * Splits the file into total byte ranges of about equal size and returns
+   * the lines that start in range tid. Every line belongs to exactly one
+   * range.
+   */
+  std::pair<const char*, const char*> lineRange(unsigned tid,
+                                                unsigned total) const;
+};
+
+//! Sets the high bit of every byte of w that is not an ASCII digit
+inline uint64_t nonDigitMask(uint64_t w) {
+  uint64_t x = w ^ UINT64_C(0x3030303030303030);
+  return (x | ((x & UINT64_C(0x7F7F7F7F7F7F7F7F)) +
+               UINT64_C(0x7676767676767676))) &
+         UINT64_C(0x8080808080808080);
+}
+
+/**
+ * Value of the first n (1 to 8) ASCII digits in w, first digit in the
+ * lowest byte. Converts all digits at once with three multiplications
+ * (SWAR) instead of one multiply-add per digit.
+ */
+inline uint64_t parseDigits(uint64_t w, unsigned n) {
+  // Borrows only move towards the bytes after the digits, which the shift
+  // drops; the zero bytes shifted in act as leading zeros
+  w = (w - UINT64_C(0x3030303030303030)) << (8 * (8 - n));
+  w = (w * 10) + (w >> 8);
+  return (((w & UINT64_C(0x000000FF000000FF)) * UINT64_C(0x000F424000000064)) +
+          (((w >> 16) & UINT64_C(0x000000FF000000FF)) *
+           UINT64_C(0x0000271000000001))) >>
+         32;
+}
+
+//! Parses the unsigned integer at p; false if p does not start with a digit
+inline bool parseUnsigned(const char*& p, const char* end, uint64_t& value) {
+  if (p == end || unsigned(*p - '0') > 9)
+    return false;
+
+  uint64_t v = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  constexpr uint64_t pow10[] = {1,      10,      100,      1000,     10000,
+                                100000, 1000000, 10000000, 100000000};
+  while (end - p >= 8) {
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    uint64_t mask = nonDigitMask(w);
+    unsigned n    = mask ? __builtin_ctzll(mask) / 8 : 8;
+    if (n == 0)
+      break;
+    v = v * pow10[n] + parseDigits(w, n);
+    p += n;
+    if (n < 8) {
+      value = v;
+      return true;
+    }
+  }
+#endif
+  for (; p != end && unsigned(*p - '0') <= 9; ++p)
+    v = v * 10 + (*p - '0');
+  value = v;
+  return true;
+}
+
+//! Parses an edge value at p; false if there is none
+template <typename T>
+bool parseValue(const char*& p, const char* end, T& value) {
+  if constexpr (std::is_integral<T>::value) {
+    bool negative = p != end && *p == '-';
+    if (negative || (p != end && *p == '+'))
+      ++p;
+    uint64_t v;
+    if (!parseUnsigned(p, end, v))
+      return false;
+    value = negative ? T(-int64_t(v)) : T(v);
+    return true;
+  } else {
+    // strtod needs a terminated string and the mapping is not
+    char buf[64];
+    size_t n = 0;
+    for (; p + n != end && n + 1 < sizeof(buf) &&
+           std::strchr("0123456789+-.eEinfaINFA", p[n]);
+         ++n)
+      buf[n] = p[n];
+    buf[n] = '\0';
+    char* last;
+    double v = std::strtod(buf, &last);
+    if (last == buf)
+      return false;
+    p += last - buf;
+    value = T(v);
+    return true;
+  }
+}
+
+inline void skipBlanks(const char*& p, const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    ++p;
+}
+
+//! Skips whitespace and, if delim is not 0, one delim surrounded by it
+inline bool skipSeparator(const char*& p, const char* end, char delim) {
+  skipBlanks(p, end);
+  if (delim) {
+    if (p == end || *p != delim)
+      return false;
+    ++p;
+    skipBlanks(p, end);
+  }
+  return true;
+}
+
+//! Whether edge data can break ties between edges to the same destination
+template <typename T, typename = void>
+struct HasLess : std::false_type {};
+
+template <typename T>
+struct HasLess<T, std::void_t<decltype(std::declval<const T&>() <
+                                       std::declval<const T&>())>>
+    : std::true_type {};
+
+template <typename EdgeTy>
+struct TextEdge {
+  uint64_t src;
+  uint64_t dst;
+  StrictObject<EdgeTy> data;
+};
+
+enum class TextLine { Edge, Blank, Malformed };
+
+/**
+ * Parses the line at p as "src dst [data]" and moves p to the next line.
+ * Lines starting with # or % are comments.
+ */
+template <typename EdgeTy>
+TextLine parseEdgeLine(const char*& p, const char* end, char delim,
+                       TextEdge<EdgeTy>& edge) {
+  TextLine kind;
+  skipBlanks(p, end);
+  if (p == end || *p == '\n' || *p == '#' || *p == '%') {
+    kind = TextLine::Blank;
+  } else if (!parseUnsigned(p, end, edge.src) ||
+             !skipSeparator(p, end, delim) ||
+             !parseUnsigned(p, end, edge.dst)) {
+    kind = TextLine::Malformed;
+  } else if constexpr (!std::is_void<EdgeTy>::value) {
+    kind = (skipSeparator(p, end, delim) && parseValue(p, end, edge.data.get()))
+               ? TextLine::Edge
+               : TextLine::Malformed;
+  } else {
+    kind = TextLine::Edge;
+  }
+
+  const void* nl = std::memchr(p, '\n', end - p);
+  p              = nl ? static_cast<const char*>(nl) + 1 : end;
+  return kind;
+}
+
+} // namespace internal
+
+//! True if filename has an extension of a text edge list (.el, .txt, .csv,
+//! .tsv)
+inline bool isEdgeListFile(const std::string& filename) {
+  size_t dot = filename.rfind('.');
+  if (dot == std::string::npos)
+    return false;
+  std::string ext = filename.substr(dot);
+  return ext == ".el" || ext == ".txt" || ext == ".csv" || ext == ".tsv";
+}
+
+/**
+ * Builds a graph from a text edge list with one "src dst [data]" per line.
+ * Node ids are zero-based and the graph has one node more than the largest
+ * id. Entries are separated by whitespace, or by delim surrounded by
+ * optional whitespace if delim is not 0. Empty lines and lines starting with
+ * # or % are ignored; other lines that do not match are skipped with a
+ * warning. If EdgeTy is not void, lines must carry edge data.
+ *
+ * The file is mapped and split into one byte range per thread. Threads
+ * parse their lines in parallel and the CSR is built with a parallel
+ * counting sort on the source. Edges of each node are sorted by
+ * destination, and by edge data when it has operator<, so the result does not
+ * depend on the number of threads.
+ *
+ * @param out graph to build; usable as a FileGraph afterwards
+ * @param filename text file to read
+ * @param skipFirstLine ignore the first line, e.g. a CSV header
+ * @param delim separator between entries or 0 for whitespace
+ */
+template <typename EdgeTy>
+void readEdgeList(FileGraphWriter& out, const std::string& filename,
+                  bool skipFirstLine = false, char delim = 0) {
+  typedef internal::TextEdge<EdgeTy> Edge;
+
+  internal::MappedTextFile file(filename);
+  substrate::PerThreadStorage<std::vector<Edge>> parsed;
+  galois::GReduceMax<uint64_t> maxNode;
+  galois::GAccumulator<uint64_t> numEdges;
+  galois::GAccumulator<uint64_t> malformed;
+
+  galois::on_each(
+      [&](unsigned tid, unsigned total) {
+        auto range    = file.lineRange(tid, total);
+        const char* p = range.first;
+        if (skipFirstLine && p == file.begin() && p != range.second) {
+          const void* nl = std::memchr(p, '\n', file.end() - p);
+          p = nl ? static_cast<const char*>(nl) + 1 : file.end();
+        }
+
+        std::vector<Edge>& edges = *parsed.getLocal();
+        Edge edge;
+        while (p < range.second) {
+          switch (internal::parseEdgeLine(p, file.end(), delim, edge)) {
+          case internal::TextLine::Edge:
+            maxNode.update(std::max(edge.src, edge.dst));
+            edges.push_back(edge);
+            break;
+          case internal::TextLine::Malformed:
+            malformed += 1;
+            break;
+          default:
+            break;
+          }
+        }
+        numEdges += edges.size();
+      },
+      galois::loopname("EdgeListParse"));
+
+  if (malformed.reduce()) {
+    galois::gWarn("ignored ", malformed.reduce(),
+                  " lines because they did not match the expected format\n");
+  }
+
+  uint64_t numNodes = numEdges.reduce() ? maxNode.reduce() + 1 : 0;
+  out.setNumNodes(numNodes);
+  out.setNumEdges<EdgeTy>(numEdges.reduce());
+  out.phase1();
+
+  // Counting sort on the source: count degrees, turn them into edge offsets
+  // and let every thread place its edges through per-node cursors
+  LargeArray<std::atomic<uint64_t>> cursor;
+  cursor.create(numNodes, 0);
+  galois::on_each([&](unsigned, unsigned) {
+    for (const Edge& e : *parsed.getLocal())
+      cursor[e.src].fetch_add(1, std::memory_order_relaxed);
+  });
+  galois::do_all(
+      galois::iterate(UINT64_C(0), numNodes),
+      [&](uint64_t n) { out.incrementDegree(n, cursor[n]); },
+      galois::no_stats());
+  out.phase2();
+  galois::do_all(
+      galois::iterate(UINT64_C(0), numNodes),
+      [&](uint64_t n) { cursor[n] = *out.edge_begin(n); }, galois::no_stats());
+
+  galois::on_each(
+      [&](unsigned, unsigned) {
+        std::vector<Edge>& edges = *parsed.getLocal();
+        for (const Edge& e : edges) {
+          uint64_t idx = cursor[e.src].fetch_add(1, std::memory_order_relaxed);
+          if constexpr (std::is_void<EdgeTy>::value)
+            out.setNeighbor(idx, e.dst);
+          else
+            out.setNeighbor<EdgeTy>(idx, e.dst, e.data.get());
+        }
+        std::vector<Edge>().swap(edges);
+      },
+      galois::loopname("EdgeListFill"));
+
+  galois::do_all(
+      galois::iterate(UINT64_C(0), numNodes),
+      [&](uint64_t n) {
+        out.sortEdges<EdgeTy>(n, [](const EdgeSortValue<uint64_t, EdgeTy>& a,
+                                    const EdgeSortValue<uint64_t, EdgeTy>& b) {
+          if constexpr (!internal::HasLess<EdgeTy>::value)
+            return a.dst < b.dst;
+          else
+            return a.dst < b.dst || (a.dst == b.dst && a.get() < b.get());
+        });
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("EdgeListSort"));
+  out.finish();
+}
+
+/**
+ * Reads a text edge list by extension: .csv files are comma separated with
+ * a header line, other edge lists are whitespace separated.
+ */
+template <typename EdgeTy>
+void readEdgeListFile(FileGraphWriter& out, const std::string& filename) {
+  bool csv = filename.size() >= 4 &&
+             filename.compare(filename.size() - 4, 4, ".csv") == 0;
+  readEdgeList<EdgeTy>(out, filename, csv, csv ? ',' : 0);
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -71,6 +71,8 @@ private:
   struct mapping {
     void* ptr;
     size_t len;
+    //! NUMA node the mapping is accounted on
+    unsigned node;
   };
 
 protected:
@@ -146,6 +148,14 @@ private:
    */
   void fromMem(void* m, uint64_t nodeOffset, uint64_t edgeOffset, uint64_t);
 
+  /**
+   * Allocates anonymous memory that is released with the graph.
+   *
+   * @param bytes Size of the allocation
+   * @returns Start of the allocation
+   */
+  char* allocateMapping(size_t bytes);
+
   /**
    * Loads a graph from another file graph
    *
@@ -569,6 +579,9 @@ public:
   //! Returns the size of an edge
   size_t edgeSize() const { return sizeofEdge; }
 
+  //! Returns the number of huge pages backing the memory mapped by the graph
+  size_t numHugePages() const;
+
   /**
    * Default file graph constructor which initializes fields to null values.
    */
@@ -739,6 +752,29 @@ public:
     return idx;
   }
 
+  /**
+   * Sets the destination of edge idx directly. After phase2(), threads may
+   * fill disjoint edges in parallel with this instead of addNeighbor, which
+   * keeps a per-node cursor.
+   */
+  void setNeighbor(size_t idx, size_t dst) {
+    assert(idx < numEdges);
+    if (numNodes <= std::numeric_limits<uint32_t>::max())
+      reinterpret_cast<uint32_t*>(outs)[idx] = dst; // version 1
+    else
+      reinterpret_cast<uint64_t*>(outs)[idx] = dst; // version 2
+  }
+
+  //! Sets the destination and data of edge idx directly
+  template <typename T>
+  void setNeighbor(
+      size_t idx, size_t dst,
+      const typename std::enable_if<!std::is_void<T>::value, T>::type& data) {
+    assert(edgeData);
+    setNeighbor(idx, dst);
+    reinterpret_cast<T*>(edgeData)[idx] = data;
+  }
+
   /**
    * Finish making graph.
    */
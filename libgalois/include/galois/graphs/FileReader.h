@@ -0,0 +1,89 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_FILEREADER_H
+#define GALOIS_GRAPHS_FILEREADER_H
+
+#include <cstdint>
+#include <string>
+
+#include <boost/utility.hpp>
+
+#include "galois/config.h"
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Reads ranges of a file into memory with large parallel reads instead of
+ * page faults on a mapping. A range is cut into blocks aligned to
+ * blockSize in the file, and active thread i reads blocks i, i + T, ...
+ * into the destination, so untouched destination pages are also first
+ * touched round robin across threads (and NUMA nodes).
+ *
+ * When built with io_uring support each thread keeps up to queueDepth
+ * reads in flight on its own ring; otherwise, or when the kernel refuses
+ * to create a ring or does not support IORING_OP_READ, or
+ * GALOIS_DO_NOT_USE_IO_URING is set, threads issue blocking preads. A
+ * thread whose ring rejects a read with EINVAL or EOPNOTSUPP reads the rest
+ * of its blocks with preads as well.
+ */
+class FileReader : private boost::noncopyable {
+  int fd;
+  uint64_t length;
+  bool ioUring;
+  uint64_t bytesRead = 0;
+  uint64_t readUsec  = 0;
+
+  void readBlocks(unsigned tid, unsigned total, char* dst, uint64_t offset,
+                  uint64_t len);
+
+public:
+  //! Bytes per read request
+  constexpr static uint64_t blockSize = 4 * 1024 * 1024;
+  //! Reads each thread keeps in flight with io_uring
+  constexpr static unsigned queueDepth = 8;
+
+  explicit FileReader(const std::string& filename);
+  ~FileReader();
+
+  //! Size of the file in bytes
+  uint64_t size() const { return length; }
+
+  //! True if reads are issued through io_uring
+  bool usesIoUring() const { return ioUring; }
+
+  /**
+   * Copies len bytes starting at offset in the file to dst using all active
+   * threads. Dies on I/O errors or reads past the end of the file. Cannot
+   * be called during parallel execution.
+   */
+  void read(void* dst, uint64_t offset, uint64_t len);
+
+  /**
+   * Reports the bytes read so far, the time spent reading them and the
+   * resulting throughput in GB/s under the given statistics region.
+   */
+  void reportStats(const char* region) const;
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
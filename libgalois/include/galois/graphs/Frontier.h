@@ -0,0 +1,291 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_FRONTIER_H
+#define GALOIS_GRAPHS_FRONTIER_H
+
+#include "galois/config.h"
+#include "galois/Bag.h"
+#include "galois/DynamicBitset.h"
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/runtime/Statistics.h"
+
+#include <cstdint>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Active nodes of a bulk-synchronous frontier algorithm. A sparse frontier
+ * keeps a bag of its nodes and is iterated in time proportional to its size;
+ * a dense frontier is only the bitset and is iterated by scanning all nodes.
+ * The bitset is kept in both representations, so contains() is always
+ * available and push() never adds a node twice.
+ */
+class Frontier {
+  size_t numNodes;
+  bool dense = false;
+  galois::InsertBag<uint32_t> nodes;
+  galois::DynamicBitSet bits;
+  galois::GAccumulator<size_t> count;
+
+public:
+  explicit Frontier(size_t n) : numNodes(n) { bits.resize(n); }
+
+  Frontier(const Frontier&) = delete;
+  Frontier& operator=(const Frontier&) = delete;
+
+  bool isDense() const { return dense; }
+
+  bool contains(uint32_t n) const { return bits.test(n); }
+
+  //! Number of nodes; call outside of parallel loops that push
+  size_t size() { return count.reduce(); }
+
+  bool empty() { return size() == 0; }
+
+  //! Adds node n; thread safe
+  void push(uint32_t n) {
+    if (!bits.set(n)) {
+      count += 1;
+      if (!dense)
+        nodes.push(n);
+    }
+  }
+
+  //! Removes all nodes and switches to the given representation
+  void clear(bool toDense) {
+    if (dense) {
+      bits.reset();
+    } else {
+      galois::do_all(
+          galois::iterate(nodes), [&](uint32_t n) { bits.reset(n); },
+          galois::no_stats());
+    }
+    nodes.clear();
+    count.reset();
+    dense = toDense;
+  }
+
+  //! Makes every node active; the frontier becomes dense
+  void fill() {
+    clear(true);
+    galois::do_all(
+        galois::iterate(size_t{0}, numNodes), [&](size_t n) { bits.set(n); },
+        galois::no_stats());
+    count += numNodes;
+  }
+
+  //! Switches to the sparse representation, collecting the nodes in the bag
+  void toSparse() {
+    if (!dense)
+      return;
+    galois::do_all(
+        galois::iterate(size_t{0}, numNodes),
+        [&](size_t n) {
+          if (bits.test(n))
+            nodes.push(n);
+        },
+        galois::no_stats());
+    dense = false;
+  }
+
+  //! Switches to the dense representation
+  void toDense() {
+    nodes.clear();
+    dense = true;
+  }
+
+  //! Calls fn(n) on every node in parallel
+  template <typename Fn, typename... Args>
+  void forEach(Fn fn, Args&&... args) {
+    if (dense) {
+      galois::do_all(
+          galois::iterate(size_t{0}, numNodes),
+          [&](size_t n) {
+            if (bits.test(n))
+              fn(uint32_t(n));
+          },
+          std::forward<Args>(args)...);
+    } else {
+      galois::do_all(galois::iterate(nodes), fn, std::forward<Args>(args)...);
+    }
+  }
+};
+
+/**
+ * Runs rounds of a frontier algorithm over a graph with in and out edges
+ * (LC_CSR_CSC_Graph), choosing per round between pushing along the out
+ * edges of the frontier and pulling over the in edges of every node, as in
+ *
+ * Scott Beamer, Krste Asanovic, David Patterson. Direction-Optimizing
+ * Breadth-First Search. SC 2012.
+ *
+ * Pushing costs the out edges of the frontier, m_f; pulling costs up to all
+ * edges but stops scanning a node as soon as it no longer needs updates. The
+ * engine switches to pull once m_f exceeds m_u / alpha, where m_u is the
+ * number of edges left to explore, and back to push once the frontier is
+ * shrinking and has fewer than n / beta nodes. Sparse frontiers are used
+ * when pushing and dense ones when pulling.
+ *
+ * An operator supplies:
+ * - bool cond(GNode dst): whether dst may still be updated
+ * - bool push(GNode src, GNode dst): update of dst along an out edge of src;
+ *   called concurrently for the same dst, so it must be atomic
+ * - bool pull(GNode src, GNode dst): the same update, made by the only
+ *   thread working on dst
+ * Updates return true to put dst in the next frontier.
+ *
+ * For monotone operators, where a node enters the frontier at most once
+ * (e.g., BFS, or k-core peeling, which updates a node many times but
+ * removes it once), the out edges of every node are pushed at most once, so
+ * m_u shrinks by m_f every round; otherwise it stays at the number of edges
+ * (the threshold used by Ligra).
+ */
+template <typename Graph>
+class FrontierEngine {
+public:
+  using GNode = typename Graph::GraphNode;
+
+  enum Direction { Auto, Push, Pull };
+
+private:
+  constexpr static const unsigned CHUNK_SIZE = 64U;
+
+  Graph& graph;
+  bool monotone;
+  unsigned alpha;
+  unsigned beta;
+  Direction forced;
+  bool pulling         = false;
+  size_t lastSize      = 0;
+  int64_t edgesToCheck = 0;
+  uint64_t pushRounds  = 0;
+  uint64_t pullRounds  = 0;
+
+  //! m_f: out edges of the frontier
+  uint64_t frontierEdges(Frontier& frontier) {
+    galois::GAccumulator<uint64_t> edges;
+    frontier.forEach(
+        [&](GNode n) {
+          edges += std::distance(
+              graph.edge_begin(n, galois::MethodFlag::UNPROTECTED),
+              graph.edge_end(n, galois::MethodFlag::UNPROTECTED));
+        },
+        galois::no_stats());
+    return edges.reduce();
+  }
+
+  bool choosePull(Frontier& frontier) {
+    if (forced != Auto)
+      return forced == Pull;
+
+    size_t size    = frontier.size();
+    uint64_t edges = frontierEdges(frontier);
+    int64_t unexplored =
+        monotone ? edgesToCheck : static_cast<int64_t>(graph.sizeEdges());
+    if (monotone)
+      edgesToCheck -= edges;
+
+    if (!pulling)
+      pulling = static_cast<int64_t>(edges) > unexplored / alpha;
+    else
+      pulling = size >= lastSize || size > graph.size() / beta;
+    lastSize = size;
+    return pulling;
+  }
+
+public:
+  /**
+   * @param g graph with in edges constructed
+   * @param isMonotone true if each node enters the frontier at most once
+   * @param a alpha of the push to pull switch
+   * @param b beta of the pull to push switch
+   * @param d forces a direction instead of choosing per round
+   */
+  FrontierEngine(Graph& g, bool isMonotone, unsigned a = 15, unsigned b = 18,
+                 Direction d = Auto)
+      : graph(g), monotone(isMonotone), alpha(a), beta(b), forced(d),
+        edgesToCheck(g.sizeEdges()) {}
+
+  /**
+   * Applies op along every edge (src, dst) with src in cur and op.cond(dst),
+   * collecting the destinations of successful updates in next, which is
+   * cleared first.
+   *
+   * @returns the direction used
+   */
+  template <typename Op>
+  Direction edgeMap(Frontier& cur, Frontier& next, Op& op,
+                    const char* loopname = "FrontierEngine") {
+    constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+    bool pull = choosePull(cur);
+    next.clear(pull);
+    if (pull) {
+      ++pullRounds;
+      galois::do_all(
+          galois::iterate(graph),
+          [&](GNode dst) {
+            if (!op.cond(dst))
+              return;
+            for (auto e : graph.in_edges(dst, flag)) {
+              GNode src = graph.getInEdgeDst(e);
+              if (cur.contains(src) && op.pull(src, dst))
+                next.push(dst);
+              if (!op.cond(dst))
+                break;
+            }
+          },
+          galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+          galois::loopname(loopname));
+      return Pull;
+    }
+
+    ++pushRounds;
+    cur.toSparse();
+    cur.forEach(
+        [&](GNode src) {
+          for (auto e : graph.edges(src, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (op.cond(dst) && op.push(src, dst))
+              next.push(dst);
+          }
+        },
+        galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname(loopname));
+    return Push;
+  }
+
+  /**
+   * Reports the number of push and pull rounds.
+   *
+   * @param region Region name to report the statistics under
+   */
+  void reportStats(const char* region) const {
+    galois::runtime::reportStat_Single(region, "PushRounds", pushRounds);
+    galois::runtime::reportStat_Single(region, "PullRounds", pullRounds);
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
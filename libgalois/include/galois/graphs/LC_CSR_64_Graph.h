@@ -513,6 +513,8 @@ public:
   }
 
   void allocateFrom(const FileGraph& graph) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
     if (UseNumaAlloc) {
@@ -531,6 +533,8 @@ public:
   }
 
   void allocateFrom(uint64_t nNodes, uint64_t nEdges) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = nNodes;
     numEdges = nEdges;
 
@@ -550,6 +554,8 @@ public:
   }
 
   void destroyAndAllocateFrom(uint64_t nNodes, uint64_t nEdges) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = nNodes;
     numEdges = nEdges;
 
@@ -33,6 +33,7 @@
 #include "galois/Galois.h"
 #include "galois/graphs/Details.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/FileReader.h"
 #include "galois/graphs/GraphHelpers.h"
 #include "galois/PODResizeableArray.h"
 
@@ -402,9 +403,36 @@ public:
 
   GraphNode getEdgeDst(edge_iterator ni) { return edgeDst[*ni]; }
 
+  /**
+   * Destinations of the edges from ni onwards as a raw array, e.g. for the
+   * set intersection kernels (galois/SetIntersection.h); the edges of node N
+   * are getEdgeDstPtr(edge_begin(N))[0, std::distance(edge_begin(N),
+   * edge_end(N))).
+   */
+  const uint32_t* getEdgeDstPtr(edge_iterator ni) const {
+    return edgeDst.data() + *ni;
+  }
+
   size_t size() const { return numNodes; }
   size_t sizeEdges() const { return numEdges; }
 
+  /**
+   * Reports the number of huge pages backing each array of the graph.
+   * readGraph and readGraphFromGRFile call this once the graph is loaded.
+   *
+   * @param region Region name to report the statistics under
+   */
+  void reportHugePages(const char* region) const {
+    galois::runtime::reportStat_Single(region, "NodeDataHugePages",
+                                       nodeData.numHugePages());
+    galois::runtime::reportStat_Single(region, "EdgeIndexHugePages",
+                                       edgeIndData.numHugePages());
+    galois::runtime::reportStat_Single(region, "EdgeDstHugePages",
+                                       edgeDst.numHugePages());
+    galois::runtime::reportStat_Single(region, "EdgeDataHugePages",
+                                       edgeData.numHugePages());
+  }
+
   iterator begin() const { return iterator(0); }
   iterator end() const { return iterator(numNodes); }
 
@@ -513,6 +541,8 @@ public:
   }
 
   void allocateFrom(const FileGraph& graph) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
     if (UseNumaAlloc) {
@@ -531,6 +561,8 @@ public:
   }
 
   void allocateFrom(uint32_t nNodes, uint64_t nEdges) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = nNodes;
     numEdges = nEdges;
 
@@ -550,6 +582,8 @@ public:
   }
 
   void destroyAndAllocateFrom(uint32_t nNodes, uint64_t nEdges) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = nNodes;
     numEdges = nEdges;
 
@@ -870,144 +904,45 @@ public:
   }
 
   /**
-   * Reads the GR files directly into in-memory
-   * data-structures of LC_CSR graphs using freads.
-   *
-   * Edge is not void.
-   *
+   * Reads a version 1 gr file directly into the arrays of the graph with
+   * large parallel reads (see FileReader). Edge data is read as is, so the
+   * file must store edges of type EdgeTy (or is ignored if EdgeTy is void).
    */
-  template <
-      typename U                                                      = void,
-      typename std::enable_if<!std::is_void<EdgeTy>::value, U>::type* = nullptr>
   void readGraphFromGRFile(const std::string& filename) {
-    std::ifstream graphFile(filename.c_str());
-    if (!graphFile.is_open()) {
-      GALOIS_DIE("failed to open file");
-    }
+    FileReader reader(filename);
     uint64_t header[4];
-    graphFile.read(reinterpret_cast<char*>(header), sizeof(uint64_t) * 4);
+    if (reader.size() < sizeof(header))
+      GALOIS_DIE("'", filename, "' is not a gr file");
+    reader.read(header, 0, sizeof(header));
     uint64_t version = header[0];
     numNodes         = header[2];
     numEdges         = header[3];
+    // edgeDst holds 32-bit destinations
+    if (version != 1)
+      GALOIS_DIE("unsupported file version: ", version);
+    if (EdgeData::has_value && header[1] != EdgeData::size_of::value)
+      GALOIS_DIE("edge data size mismatch: ", header[1], " in file");
     galois::gPrint("Number of Nodes: ", numNodes,
                    ", Number of Edges: ", numEdges, "\n");
     allocateFrom(numNodes, numEdges);
     constructNodes();
-    /**
-     * Load outIndex array
-     **/
-    assert(edgeIndData.data());
-    if (!edgeIndData.data()) {
-      GALOIS_DIE("out of memory");
-    }
-
-    // start position to read index data
-    uint64_t readPosition = (4 * sizeof(uint64_t));
-    graphFile.seekg(readPosition);
-    graphFile.read(reinterpret_cast<char*>(edgeIndData.data()),
-                   sizeof(uint64_t) * numNodes);
-    /**
-     * Load edgeDst array
-     **/
-    assert(edgeDst.data());
-    if (!edgeDst.data()) {
-      GALOIS_DIE("out of memory");
-    }
-
-    readPosition = ((4 + numNodes) * sizeof(uint64_t));
-    graphFile.seekg(readPosition);
-    if (version == 1) {
-      graphFile.read(reinterpret_cast<char*>(edgeDst.data()),
-                     sizeof(uint32_t) * numEdges);
-      readPosition =
-          ((4 + numNodes) * sizeof(uint64_t) + numEdges * sizeof(uint32_t));
-      // version 1 padding TODO make version agnostic
-      if (numEdges % 2) {
-        readPosition += sizeof(uint32_t);
-      }
-    } else if (version == 2) {
-      graphFile.read(reinterpret_cast<char*>(edgeDst.data()),
-                     sizeof(uint64_t) * numEdges);
-      readPosition =
-          ((4 + numNodes) * sizeof(uint64_t) + numEdges * sizeof(uint64_t));
-      if (numEdges % 2) {
-        readPosition += sizeof(uint64_t);
-      }
-    } else {
-      GALOIS_DIE("unknown file version: ", version);
-    }
-    /**
-     * Load edge data array
-     **/
-    assert(edgeData.data());
-    if (!edgeData.data()) {
-      GALOIS_DIE("out of memory");
-    }
-    graphFile.seekg(readPosition);
-    graphFile.read(reinterpret_cast<char*>(edgeData.data()),
-                   sizeof(EdgeTy) * numEdges);
 
-    initializeLocalRanges();
-    graphFile.close();
-  }
-
-  /**
-   * Reads the GR files directly into in-memory
-   * data-structures of LC_CSR graphs using freads.
-   *
-   * Edge is void.
-   *
-   */
-  template <
-      typename U                                                     = void,
-      typename std::enable_if<std::is_void<EdgeTy>::value, U>::type* = nullptr>
-  void readGraphFromGRFile(const std::string& filename) {
-    std::ifstream graphFile(filename.c_str());
-    if (!graphFile.is_open()) {
-      GALOIS_DIE("failed to open file");
-    }
-    uint64_t header[4];
-    graphFile.read(reinterpret_cast<char*>(header), sizeof(uint64_t) * 4);
-    uint64_t version = header[0];
-    numNodes         = header[2];
-    numEdges         = header[3];
-    galois::gPrint("Number of Nodes: ", numNodes,
-                   ", Number of Edges: ", numEdges, "\n");
-    allocateFrom(numNodes, numEdges);
-    constructNodes();
-    /**
-     * Load outIndex array
-     **/
-    assert(edgeIndData.data());
-    if (!edgeIndData.data()) {
-      GALOIS_DIE("out of memory");
+    uint64_t readPosition = sizeof(header);
+    reader.read(edgeIndData.data(), readPosition, sizeof(uint64_t) * numNodes);
+    readPosition += sizeof(uint64_t) * numNodes;
+    reader.read(edgeDst.data(), readPosition, sizeof(uint32_t) * numEdges);
+    readPosition += sizeof(uint32_t) * numEdges;
+    // version 1 padding
+    if (numEdges % 2) {
+      readPosition += sizeof(uint32_t);
     }
-    // start position to read index data
-    uint64_t readPosition = (4 * sizeof(uint64_t));
-    graphFile.seekg(readPosition);
-    graphFile.read(reinterpret_cast<char*>(edgeIndData.data()),
-                   sizeof(uint64_t) * numNodes);
-    /**
-     * Load edgeDst array
-     **/
-    assert(edgeDst.data());
-    if (!edgeDst.data()) {
-      GALOIS_DIE("out of memory");
-    }
-    readPosition = ((4 + numNodes) * sizeof(uint64_t));
-    graphFile.seekg(readPosition);
-    if (version == 1) {
-      graphFile.read(reinterpret_cast<char*>(edgeDst.data()),
-                     sizeof(uint32_t) * numEdges);
-    } else if (version == 2) {
-      graphFile.read(reinterpret_cast<char*>(edgeDst.data()),
-                     sizeof(uint64_t) * numEdges);
-    } else {
-      GALOIS_DIE("unknown file version: ", version);
+    if constexpr (EdgeData::has_value) {
+      reader.read(edgeData.data(), readPosition, sizeof(EdgeTy) * numEdges);
     }
+    reader.reportStats("LC_CSR_Graph");
+    reportHugePages("LC_CSR_Graph");
 
     initializeLocalRanges();
-    graphFile.close();
   }
 
   /**
@@ -518,6 +518,8 @@ public:
   }
 
   void allocateFrom(FileGraph& graph) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
     if (UseNumaAlloc) {
@@ -536,6 +538,8 @@ public:
   }
 
   void allocateFrom(uint32_t nNodes, uint64_t nEdges) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = nNodes;
     numEdges = nEdges;
 
@@ -0,0 +1,608 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_LC_COMPRESSED_GRAPH_H
+#define GALOIS_GRAPHS_LC_COMPRESSED_GRAPH_H
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/GraphHelpers.h"
+#include "galois/substrate/MemAccounting.h"
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+
+//! Number of destinations in an independently decodable block
+constexpr uint64_t compressedBlockSize = 64;
+
+//! First word of a compressed graph file
+constexpr uint64_t compressedGraphMagic = 0x315247434c61470aULL;
+
+inline uint64_t zigzagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline size_t varintSize(uint64_t v) {
+  size_t size = 1;
+  for (; v >= 0x80; v >>= 7)
+    ++size;
+  return size;
+}
+
+inline uint8_t* encodeVarint(uint64_t v, uint8_t* out) {
+  for (; v >= 0x80; v >>= 7)
+    *out++ = static_cast<uint8_t>(v) | 0x80;
+  *out++ = static_cast<uint8_t>(v);
+  return out;
+}
+
+inline const uint8_t* decodeVarint(const uint8_t* in, uint64_t& v) {
+  uint64_t b = *in++;
+  v          = b & 0x7f;
+  for (unsigned shift = 7; b & 0x80; shift += 7) {
+    b = *in++;
+    v |= (b & 0x7f) << shift;
+  }
+  return in;
+}
+
+/**
+ * Encoded size of a sorted adjacency list.
+ *
+ * A list of degree d is split into blocks of compressedBlockSize
+ * destinations. It starts with a table of d / compressedBlockSize uint32
+ * byte offsets locating blocks 1 and up; block 0 follows the table. The
+ * first destination of a block is zigzag encoded relative to the source and
+ * the rest are encoded as gaps from their predecessor, all as varints.
+ *
+ * @param src source node of the list
+ * @param degree number of destinations
+ * @param dst function returning the i-th sorted destination
+ */
+template <typename DstFn>
+uint64_t compressedSize(uint32_t src, uint64_t degree, DstFn dst) {
+  if (degree == 0)
+    return 0;
+  uint64_t size = (degree - 1) / compressedBlockSize * sizeof(uint32_t);
+  for (uint64_t i = 0; i < degree; ++i) {
+    if (i % compressedBlockSize == 0)
+      size += varintSize(zigzagEncode(int64_t(dst(i)) - int64_t(src)));
+    else
+      size += varintSize(dst(i) - dst(i - 1));
+  }
+  return size;
+}
+
+//! Encodes a sorted adjacency list in the layout of {@link compressedSize}
+template <typename DstFn>
+uint8_t* encodeAdjacency(uint32_t src, uint64_t degree, DstFn dst,
+                         uint8_t* out) {
+  if (degree == 0)
+    return out;
+  uint8_t* start  = out;
+  uint8_t* offset = out;
+  out += (degree - 1) / compressedBlockSize * sizeof(uint32_t);
+  for (uint64_t i = 0; i < degree; ++i) {
+    if (i % compressedBlockSize == 0) {
+      if (i) {
+        // lists are byte aligned, so the table may be unaligned
+        uint32_t blockOffset = out - start;
+        std::memcpy(offset, &blockOffset, sizeof(blockOffset));
+        offset += sizeof(blockOffset);
+      }
+      out = encodeVarint(zigzagEncode(int64_t(dst(i)) - int64_t(src)), out);
+    } else {
+      out = encodeVarint(dst(i) - dst(i - 1), out);
+    }
+  }
+  return out;
+}
+
+/**
+ * Forward iterator over a compressed adjacency list. Dereferencing gives the
+ * edge id, like the counting iterators of the other local computation graphs;
+ * the destination is decoded as the iterator advances.
+ */
+class CompressedEdgeIterator
+    : public boost::iterator_facade<CompressedEdgeIterator, uint64_t,
+                                    boost::forward_traversal_tag, uint64_t> {
+  const uint8_t* pos;
+  uint64_t edge;
+  uint64_t last;
+  uint32_t src;
+  uint32_t dst;
+  uint32_t left;
+
+  friend class boost::iterator_core_access;
+
+  void decodeFirst() {
+    uint64_t v;
+    pos  = decodeVarint(pos, v);
+    dst  = static_cast<uint32_t>(int64_t(src) + zigzagDecode(v));
+    left = compressedBlockSize - 1;
+  }
+
+  void increment() {
+    if (++edge == last)
+      return;
+    if (left == 0) {
+      decodeFirst();
+      return;
+    }
+    uint64_t v;
+    pos = decodeVarint(pos, v);
+    dst += v;
+    --left;
+  }
+
+  bool equal(const CompressedEdgeIterator& other) const {
+    return edge == other.edge;
+  }
+
+  uint64_t dereference() const { return edge; }
+
+public:
+  CompressedEdgeIterator()
+      : pos(nullptr), edge(0), last(0), src(0), dst(0), left(0) {}
+
+  /**
+   * @param p start of the encoded block that contains edge e
+   * @param e edge id the iterator starts at; must begin a block
+   * @param l edge id one past the last edge that may be decoded
+   * @param s source node of the adjacency list
+   */
+  CompressedEdgeIterator(const uint8_t* p, uint64_t e, uint64_t l, uint32_t s)
+      : pos(p), edge(e), last(l), src(s), dst(0), left(0) {
+    if (edge != last)
+      decodeFirst();
+  }
+
+  uint32_t getDst() const { return dst; }
+};
+
+} // namespace internal
+
+/**
+ * Read-only local computation graph that keeps its adjacency lists
+ * compressed. Destinations of each node are sorted and stored as
+ * variable-length byte gaps (Ligra+ byte coding) in blocks of 64 that can be
+ * decoded independently, so neighbor lists typically take a third to a half
+ * of the memory of {@link LC_CSR_Graph} and kernels bound by memory
+ * bandwidth stream fewer bytes.
+ *
+ * Edges are only reachable through forward iteration; edge ids (and edge
+ * data) follow the sorted destination order rather than the order of the
+ * input file. The graph can be loaded from a binary gr file, in which case it
+ * is compressed while loading, or from a file written by {@link toFile} or
+ * by graph-convert -gr2compressedgr.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template <typename NodeTy, typename EdgeTy, bool UseNumaAlloc = false>
+class LC_Compressed_Graph : private boost::noncopyable,
+                            private internal::LocalIteratorFeature<
+                                UseNumaAlloc> {
+public:
+  template <bool _has_id>
+  struct with_id {
+    typedef LC_Compressed_Graph type;
+  };
+
+  template <typename _node_data>
+  struct with_node_data {
+    typedef LC_Compressed_Graph<_node_data, EdgeTy, UseNumaAlloc> type;
+  };
+
+  template <typename _edge_data>
+  struct with_edge_data {
+    typedef LC_Compressed_Graph<NodeTy, _edge_data, UseNumaAlloc> type;
+  };
+
+  template <typename _file_edge_data>
+  struct with_file_edge_data {
+    typedef LC_Compressed_Graph type;
+  };
+
+  //! The graph never uses abstract locks
+  template <bool _has_no_lockable>
+  struct with_no_lockable {
+    typedef LC_Compressed_Graph type;
+  };
+
+  //! If true, use NUMA-aware graph allocation; otherwise, use NUMA interleaved
+  //! allocation.
+  template <bool _use_numa_alloc>
+  struct with_numa_alloc {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, _use_numa_alloc> type;
+  };
+
+  typedef read_compressed_graph_tag read_tag;
+
+protected:
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef LargeArray<uint8_t> EdgeBytes;
+  typedef LargeArray<uint64_t> EdgeIndData;
+  typedef internal::NodeInfoBaseTypes<NodeTy, false> NodeInfoTypes;
+  typedef internal::NodeInfoBase<NodeTy, false> NodeInfo;
+  typedef LargeArray<NodeInfo> NodeData;
+  typedef std::vector<std::pair<uint32_t, uint64_t>> FileEdges;
+
+public:
+  typedef uint32_t GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef EdgeTy file_edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef typename EdgeData::reference edge_data_reference;
+  typedef typename NodeInfoTypes::reference node_data_reference;
+  typedef internal::CompressedEdgeIterator edge_iterator;
+  typedef boost::counting_iterator<uint32_t> iterator;
+  typedef iterator const_iterator;
+  typedef iterator local_iterator;
+  typedef iterator const_local_iterator;
+
+protected:
+  NodeData nodeData;
+  //! End edge id of each node
+  EdgeIndData edgeIndData;
+  //! End byte offset of each node's encoded adjacency list
+  EdgeIndData byteIndData;
+  EdgeBytes edgeBytes;
+  EdgeData edgeData;
+
+  uint64_t numNodes = 0;
+  uint64_t numEdges = 0;
+
+  uint64_t edgeBegin(GraphNode N) const {
+    return (N == 0) ? 0 : edgeIndData[N - 1];
+  }
+
+  uint64_t byteBegin(GraphNode N) const {
+    return (N == 0) ? 0 : byteIndData[N - 1];
+  }
+
+  const uint8_t* adjacency(GraphNode N) const {
+    return edgeBytes.data() + byteBegin(N);
+  }
+
+  //! Out-edges of N in the input graph as (destination, edge) sorted pairs
+  static void sortedFileEdges(FileGraph& graph, GraphNode N, FileEdges& out) {
+    out.clear();
+    for (FileGraph::edge_iterator nn = graph.edge_begin(N),
+                                  en = graph.edge_end(N);
+         nn != en; ++nn) {
+      out.emplace_back(graph.getEdgeDst(nn), *nn);
+    }
+    std::sort(out.begin(), out.end());
+  }
+
+  void allocateArrays() {
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      edgeIndData.allocateBlocked(numNodes);
+      byteIndData.allocateBlocked(numNodes);
+      edgeData.allocateBlocked(numEdges);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeIndData.allocateInterleaved(numNodes);
+      byteIndData.allocateInterleaved(numNodes);
+      edgeData.allocateInterleaved(numEdges);
+    }
+  }
+
+  void allocateBytes(uint64_t numBytes) {
+    if (UseNumaAlloc)
+      edgeBytes.allocateBlocked(numBytes);
+    else
+      edgeBytes.allocateInterleaved(numBytes);
+  }
+
+public:
+  LC_Compressed_Graph() = default;
+
+  node_data_reference getData(GraphNode N,
+                              MethodFlag GALOIS_UNUSED(mflag) =
+                                  MethodFlag::UNPROTECTED) {
+    return nodeData[N].getData();
+  }
+
+  edge_data_reference
+  getEdgeData(const edge_iterator& ni,
+              MethodFlag GALOIS_UNUSED(mflag) = MethodFlag::UNPROTECTED) {
+    return edgeData[*ni];
+  }
+
+  GraphNode getEdgeDst(const edge_iterator& ni) const { return ni.getDst(); }
+
+  size_t size() const { return numNodes; }
+  size_t sizeEdges() const { return numEdges; }
+
+  //! Number of bytes used to encode all adjacency lists
+  size_t sizeEdgeBytes() const { return edgeBytes.size(); }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  const_local_iterator local_begin() const {
+    return const_local_iterator(this->localBegin(numNodes));
+  }
+
+  const_local_iterator local_end() const {
+    return const_local_iterator(this->localEnd(numNodes));
+  }
+
+  local_iterator local_begin() {
+    return local_iterator(this->localBegin(numNodes));
+  }
+
+  local_iterator local_end() {
+    return local_iterator(this->localEnd(numNodes));
+  }
+
+  edge_iterator edge_begin(GraphNode N,
+                           MethodFlag GALOIS_UNUSED(mflag) =
+                               MethodFlag::UNPROTECTED) const {
+    uint64_t first = edgeBegin(N);
+    uint64_t last  = edgeIndData[N];
+    uint64_t skip  = (last > first)
+                        ? (last - first - 1) / internal::compressedBlockSize
+                        : 0;
+    return edge_iterator(adjacency(N) + skip * sizeof(uint32_t), first, last,
+                         N);
+  }
+
+  edge_iterator edge_end(GraphNode N,
+                         MethodFlag GALOIS_UNUSED(mflag) =
+                             MethodFlag::UNPROTECTED) const {
+    uint64_t last = edgeIndData[N];
+    return edge_iterator(nullptr, last, last, N);
+  }
+
+  uint64_t getDegree(GraphNode N) const {
+    return edgeIndData[N] - edgeBegin(N);
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  edges(GraphNode N, MethodFlag mflag = MethodFlag::UNPROTECTED) const {
+    return internal::make_no_deref_range(edge_begin(N, mflag),
+                                         edge_end(N, mflag));
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  out_edges(GraphNode N, MethodFlag mflag = MethodFlag::UNPROTECTED) const {
+    return edges(N, mflag);
+  }
+
+  //! Number of independently decodable blocks in the edges of N
+  uint64_t numEdgeBlocks(GraphNode N) const {
+    return (getDegree(N) + internal::compressedBlockSize - 1) /
+           internal::compressedBlockSize;
+  }
+
+  /**
+   * Edges of the given block of N. Blocks can be decoded in parallel, which
+   * is useful to split up the edges of high-degree nodes.
+   */
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  edgeBlock(GraphNode N, uint64_t block) const {
+    const uint8_t* pos = adjacency(N);
+    if (block == 0) {
+      pos += (numEdgeBlocks(N) - 1) * sizeof(uint32_t);
+    } else {
+      uint32_t blockOffset;
+      std::memcpy(&blockOffset, pos + (block - 1) * sizeof(uint32_t),
+                  sizeof(blockOffset));
+      pos += blockOffset;
+    }
+    uint64_t first = edgeBegin(N) + block * internal::compressedBlockSize;
+    uint64_t last =
+        std::min(first + internal::compressedBlockSize, edgeIndData[N]);
+    return internal::make_no_deref_range(edge_iterator(pos, first, last, N),
+                                         edge_iterator(nullptr, last, last, N));
+  }
+
+  //! Finds the edge from N1 to N2 by scanning the sorted edges of N1
+  edge_iterator findEdge(GraphNode N1, GraphNode N2) const {
+    edge_iterator ii = edge_begin(N1), ei = edge_end(N1);
+    for (; ii != ei && ii.getDst() < N2; ++ii)
+      ;
+    return (ii != ei && ii.getDst() == N2) ? ii : ei;
+  }
+
+  edge_iterator findEdgeSortedByDst(GraphNode N1, GraphNode N2) const {
+    return findEdge(N1, N2);
+  }
+
+  /**
+   * Sizes the compressed adjacency lists of a file graph and allocates the
+   * graph; {@link constructFrom} fills it in afterwards.
+   */
+  void allocateFrom(FileGraph& graph) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
+    numNodes = graph.size();
+    numEdges = graph.sizeEdges();
+    allocateArrays();
+
+    galois::substrate::PerThreadStorage<FileEdges> scratch;
+    galois::do_all(
+        galois::iterate(UINT64_C(0), numNodes),
+        [&](uint64_t n) {
+          FileEdges& sorted = *scratch.getLocal();
+          sortedFileEdges(graph, n, sorted);
+          uint64_t bytes =
+              internal::compressedSize(n, sorted.size(), [&](uint64_t i) {
+                return sorted[i].first;
+              });
+          if (bytes > std::numeric_limits<uint32_t>::max())
+            GALOIS_DIE("edges of node ", n, " too large to compress");
+          byteIndData[n] = bytes;
+        },
+        galois::no_stats(), galois::steal(),
+        galois::loopname("CompressedGraphSize"));
+
+    galois::ParallelSTL::partial_sum(byteIndData.begin(), byteIndData.end(),
+                                     byteIndData.begin());
+    allocateBytes(numNodes ? byteIndData[numNodes - 1] : 0);
+  }
+
+  void constructFrom(FileGraph& graph, unsigned tid, unsigned total,
+                     const bool readUnweighted = false) {
+    auto r = graph
+                 .divideByNode(NodeData::size_of::value +
+                                   2 * EdgeIndData::size_of::value,
+                               EdgeData::size_of::value + 2, tid, total)
+                 .first;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    FileEdges sorted;
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      GraphNode n = *ii;
+      nodeData.constructAt(n);
+      edgeIndData[n] = *graph.edge_end(n);
+
+      sortedFileEdges(graph, n, sorted);
+      internal::encodeAdjacency(
+          n, sorted.size(), [&](uint64_t i) { return sorted[i].first; },
+          edgeBytes.data() + byteBegin(n));
+
+      if constexpr (EdgeData::has_value) {
+        uint64_t e = edgeBegin(n);
+        for (auto& s : sorted) {
+          if (readUnweighted)
+            edgeData.set(e++, {});
+          else
+            edgeData.set(e++, graph.getEdgeData<EdgeTy>(
+                                  FileGraph::edge_iterator(s.second)));
+        }
+      }
+    }
+  }
+
+  //! True if filename starts with the magic word of a compressed graph
+  static bool isCompressedFile(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    uint64_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return in && magic == internal::compressedGraphMagic;
+  }
+
+  /**
+   * Writes the graph in the compressed file format: a header of five
+   * uint64_t (magic, sizeof edge data, nodes, edges, encoded bytes), the end
+   * edge of each node, the end byte of each node, the encoded adjacency
+   * lists padded to 8 bytes, and finally the edge data.
+   */
+  void toFile(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out)
+      GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+    uint64_t numBytes  = edgeBytes.size();
+    uint64_t header[5] = {internal::compressedGraphMagic,
+                          EdgeData::size_of::value, numNodes, numEdges,
+                          numBytes};
+    uint64_t padding   = 0;
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(edgeIndData.data()),
+              sizeof(uint64_t) * numNodes);
+    out.write(reinterpret_cast<const char*>(byteIndData.data()),
+              sizeof(uint64_t) * numNodes);
+    out.write(reinterpret_cast<const char*>(edgeBytes.data()), numBytes);
+    out.write(reinterpret_cast<const char*>(&padding), -numBytes & 7);
+    if constexpr (EdgeData::has_value) {
+      out.write(reinterpret_cast<const char*>(edgeData.data()),
+                EdgeData::size_of::value * numEdges);
+    }
+    if (!out)
+      GALOIS_SYS_DIE("failed writing ", "'", filename, "'");
+  }
+
+  //! Reads a graph written by {@link toFile}
+  void fromFile(const std::string& filename) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+      GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+    uint64_t header[5];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != internal::compressedGraphMagic)
+      GALOIS_DIE("not a compressed graph: ", filename);
+    if (EdgeData::has_value && header[1] != EdgeData::size_of::value)
+      GALOIS_DIE("edge data size mismatch: ", header[1], " in ", filename);
+
+    numNodes          = header[2];
+    numEdges          = header[3];
+    uint64_t numBytes = header[4];
+    allocateArrays();
+    allocateBytes(numBytes);
+
+    in.read(reinterpret_cast<char*>(edgeIndData.data()),
+            sizeof(uint64_t) * numNodes);
+    in.read(reinterpret_cast<char*>(byteIndData.data()),
+            sizeof(uint64_t) * numNodes);
+    in.read(reinterpret_cast<char*>(edgeBytes.data()), numBytes);
+    in.ignore(-numBytes & 7);
+    if constexpr (EdgeData::has_value) {
+      in.read(reinterpret_cast<char*>(edgeData.data()),
+              EdgeData::size_of::value * numEdges);
+    }
+    if (!in)
+      GALOIS_DIE("truncated compressed graph: ", filename);
+
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideNodesBinarySearch(numNodes, numBytes,
+                                       NodeData::size_of::value, 1, tid,
+                                       total, byteIndData)
+                   .first;
+      this->setLocalRange(*r.first, *r.second);
+      for (auto ii = r.first, ei = r.second; ii != ei; ++ii)
+        nodeData.constructAt(*ii);
+    });
+  }
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -327,6 +327,8 @@ public:
 #endif
 
   void allocateFrom(FileGraph& graph) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
 
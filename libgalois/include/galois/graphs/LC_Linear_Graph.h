@@ -310,6 +310,8 @@ public:
   }
 
   void allocateFrom(FileGraph& graph, const ReadGraphAuxData&) {
+    galois::substrate::MemCategoryScope memScope(
+        galois::substrate::MemCategory::Graph);
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
     if (UseNumaAlloc) {
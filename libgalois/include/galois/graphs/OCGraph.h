@@ -21,7 +21,9 @@
 #define GALOIS_GRAPHS_OCGRAPH_H
 
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
 #include <boost/utility.hpp>
@@ -578,6 +580,54 @@ public:
   }
 };
 
+/**
+ * Splits a segmented graph into consecutive segments of about segmentEdges
+ * edges each (see OCImmutableEdgeGraph::nextSegment). Nothing is loaded.
+ */
+template <typename Graph>
+std::vector<typename Graph::segment_type> makeSegments(Graph& graph,
+                                                       size_t segmentEdges) {
+  std::vector<typename Graph::segment_type> segments;
+  for (auto s = graph.nextSegment(segmentEdges); s;
+       s = graph.nextSegment(s, segmentEdges))
+    segments.push_back(s);
+  return segments;
+}
+
+/**
+ * Loads each segment in [begin, end) in turn, calls fn on it and unloads it
+ * again. The next segment is loaded on a separate thread while fn runs, so
+ * reading from disk overlaps with computation and at most two segments are
+ * resident at a time. Segments are visited in the given order; passing them
+ * in file order keeps the reads sequential.
+ *
+ * fn may run parallel loops. Cannot be called during parallel execution.
+ */
+template <typename Graph, typename SegmentIter, typename Fn>
+void forEachSegment(Graph& graph, SegmentIter begin, SegmentIter end, Fn fn) {
+  typedef typename Graph::segment_type segment_type;
+  if (begin == end)
+    return;
+
+  segment_type cur = *begin;
+  graph.load(cur);
+  for (++begin;; ++begin) {
+    segment_type next;
+    std::thread loader;
+    if (begin != end) {
+      next   = *begin;
+      loader = std::thread([&]() { graph.load(next); });
+    }
+    fn(cur);
+    if (loader.joinable())
+      loader.join();
+    graph.unload(cur);
+    if (begin == end)
+      return;
+    cur = next;
+  }
+}
+
 template <typename GraphTy, typename... Args>
 void readGraphDispatch(GraphTy& graph, read_oc_immutable_edge_graph_tag,
                        Args&&... args) {
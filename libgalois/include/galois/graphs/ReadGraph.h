@@ -23,6 +23,7 @@
 #include "galois/config.h"
 #include "galois/Galois.h"
 #include "galois/graphs/Details.h"
+#include "galois/graphs/EdgeListReader.h"
 #include "galois/graphs/FileGraph.h"
 #include "galois/Timer.h"
 
@@ -40,6 +41,21 @@ void readGraph(GraphTy& graph, Args&&... args) {
   readGraphDispatch(graph, tag, std::forward<Args>(args)...);
 }
 
+/**
+ * Loads a file graph. Text edge lists (see isEdgeListFile) are parsed in
+ * parallel; any other file is mapped as a binary gr file.
+ */
+template <typename EdgeTy>
+void readFileGraph(FileGraph& f, const std::string& filename) {
+  if (isEdgeListFile(filename)) {
+    FileGraphWriter w;
+    readEdgeListFile<EdgeTy>(w, filename);
+    f = std::move(w);
+  } else {
+    f.fromFileInterleaved<EdgeTy>(filename);
+  }
+}
+
 template <typename GraphTy>
 void readGraphDispatch(GraphTy& graph, read_default_graph_tag tag,
                        const std::string& filename,
@@ -49,9 +65,9 @@ void readGraphDispatch(GraphTy& graph, read_default_graph_tag tag,
     //! If user specifies that the input graph is unweighted,
     //! the file graph also should be aware of this.
     //! Note that the application still could use the edge data array.
-    f.fromFileInterleaved<void>(filename);
+    readFileGraph<void>(f, filename);
   } else {
-    f.fromFileInterleaved<typename GraphTy::file_edge_data_type>(filename);
+    readFileGraph<typename GraphTy::file_edge_data_type>(f, filename);
   }
   readGraphDispatch(graph, tag, f, readUnweighted);
 }
@@ -69,6 +85,16 @@ struct ReadGraphConstructFrom {
   }
 };
 
+//! Reports the huge pages backing a loaded graph if the graph can count them
+template <typename GraphTy>
+auto reportGraphHugePages(GraphTy& graph, int)
+    -> decltype(graph.reportHugePages(""), void()) {
+  graph.reportHugePages("ReadGraph");
+}
+
+template <typename GraphTy>
+void reportGraphHugePages(GraphTy&, long) {}
+
 template <typename GraphTy>
 void readGraphDispatch(GraphTy& graph, read_default_graph_tag, FileGraph& f,
                        const bool readUnweighted = false) {
@@ -76,6 +102,7 @@ void readGraphDispatch(GraphTy& graph, read_default_graph_tag, FileGraph& f,
 
   ReadGraphConstructFrom<GraphTy> reader(graph, f, readUnweighted);
   galois::on_each(reader);
+  reportGraphHugePages(graph, 0);
 }
 
 template <typename GraphTy, typename Aux>
@@ -106,7 +133,7 @@ template <typename GraphTy>
 void readGraphDispatch(GraphTy& graph, read_with_aux_graph_tag tag,
                        const std::string& filename) {
   FileGraph f;
-  f.fromFileInterleaved<typename GraphTy::file_edge_data_type>(filename);
+  readFileGraph<typename GraphTy::file_edge_data_type>(f, filename);
   readGraphDispatch(graph, tag, f);
 }
 
@@ -188,10 +215,38 @@ template <typename GraphTy>
 void readGraphDispatch(GraphTy& graph, read_with_aux_first_graph_tag tag,
                        const std::string& filename) {
   FileGraph f;
-  f.fromFileInterleaved<typename GraphTy::file_edge_data_type>(filename);
+  readFileGraph<typename GraphTy::file_edge_data_type>(f, filename);
   readGraphDispatch(graph, tag, f);
 }
 
+template <typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag, FileGraph& f,
+                       const bool readUnweighted = false) {
+  readGraphDispatch(graph, read_default_graph_tag(), f, readUnweighted);
+}
+
+/**
+ * Compressed graphs are read directly when the file is already in the
+ * compressed format; binary gr files are compressed while loading.
+ */
+template <typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag tag,
+                       const std::string& filename,
+                       const bool readUnweighted = false) {
+  if (GraphTy::isCompressedFile(filename)) {
+    graph.fromFile(filename);
+    return;
+  }
+
+  FileGraph f;
+  if (readUnweighted) {
+    readFileGraph<void>(f, filename);
+  } else {
+    readFileGraph<typename GraphTy::file_edge_data_type>(f, filename);
+  }
+  readGraphDispatch(graph, tag, f, readUnweighted);
+}
+
 template <typename GraphTy>
 void readGraphDispatch(GraphTy& graph, read_lc_inout_graph_tag,
                        const std::string& f1, const std::string& f2) {
@@ -0,0 +1,376 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPHS_REORDER_H
+#define GALOIS_GRAPHS_REORDER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "galois/config.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+
+namespace galois {
+namespace graphs {
+
+//! Node orderings offered by {@link reorderNodes}
+enum class ReorderPolicy { None, Degree, HubSort, RCM, Gorder };
+
+/**
+ * Bijection between the node ids of a graph and the ids of its relabelled
+ * copy. A default constructed permutation is the identity, so code that maps
+ * ids for input and output does not need to check whether the graph was
+ * actually reordered.
+ */
+class NodePermutation {
+  LargeArray<uint32_t> toNew;
+  LargeArray<uint32_t> toOld;
+
+public:
+  NodePermutation() = default;
+
+  //! Takes ownership of perm, where perm[old id] = new id
+  explicit NodePermutation(LargeArray<uint32_t>&& perm)
+      : toNew(std::move(perm)) {
+    toOld.create(toNew.size());
+    galois::do_all(
+        galois::iterate(size_t{0}, toNew.size()),
+        [&](size_t n) { toOld[toNew[n]] = n; }, galois::no_stats(),
+        galois::loopname("InvertPermutation"));
+  }
+
+  bool empty() const { return toNew.size() == 0; }
+  size_t size() const { return toNew.size(); }
+
+  uint32_t newId(uint32_t old) const { return empty() ? old : toNew[old]; }
+  uint32_t oldId(uint32_t n) const { return empty() ? n : toOld[n]; }
+
+  //! Array with forward[old id] = new id, e.g., for {@link permute}
+  const LargeArray<uint32_t>& forward() const { return toNew; }
+};
+
+namespace internal {
+
+template <typename GraphTy>
+uint64_t reorderDegree(GraphTy& g, uint32_t n) {
+  return std::distance(g.edge_begin(n), g.edge_end(n));
+}
+
+template <typename GraphTy>
+LargeArray<uint64_t> reorderDegrees(GraphTy& g) {
+  LargeArray<uint64_t> degrees;
+  degrees.create(g.size());
+  galois::do_all(
+      galois::iterate(size_t{0}, g.size()),
+      [&](size_t n) { degrees[n] = reorderDegree(g, n); }, galois::no_stats(),
+      galois::steal(), galois::loopname("ReorderDegrees"));
+  return degrees;
+}
+
+//! Turns a sequence of old ids into a permutation with perm[old id] = new id
+inline NodePermutation orderToPermutation(const std::vector<uint32_t>& order) {
+  LargeArray<uint32_t> perm;
+  perm.create(order.size());
+  galois::do_all(
+      galois::iterate(size_t{0}, order.size()),
+      [&](size_t i) { perm[order[i]] = i; }, galois::no_stats());
+  return NodePermutation(std::move(perm));
+}
+
+//! Node ids sorted by decreasing degree; ties keep the original order
+inline std::vector<uint32_t> byDecreasingDegree(const LargeArray<uint64_t>& d) {
+  std::vector<uint32_t> order(d.size());
+  galois::do_all(
+      galois::iterate(size_t{0}, d.size()), [&](size_t n) { order[n] = n; },
+      galois::no_stats());
+  galois::ParallelSTL::sort(order.begin(), order.end(),
+                            [&](uint32_t a, uint32_t b) {
+                              return d[a] > d[b] || (d[a] == d[b] && a < b);
+                            });
+  return order;
+}
+
+} // namespace internal
+
+/**
+ * Orders nodes by decreasing out-degree so that the most frequently accessed
+ * nodes share cache lines and pages.
+ */
+template <typename GraphTy>
+NodePermutation degreeSortOrder(GraphTy& g) {
+  LargeArray<uint64_t> degrees = internal::reorderDegrees(g);
+  return internal::orderToPermutation(internal::byDecreasingDegree(degrees));
+}
+
+/**
+ * Hub sorting: nodes with more than the average degree are moved to the
+ * front in decreasing degree order, while all other nodes keep their
+ * original relative order and hence whatever locality the input had.
+ */
+template <typename GraphTy>
+NodePermutation hubSortOrder(GraphTy& g) {
+  const size_t numNodes = g.size();
+  LargeArray<uint64_t> degrees = internal::reorderDegrees(g);
+  const uint64_t average = numNodes ? g.sizeEdges() / numNodes : 0;
+
+  std::vector<uint32_t> hubs;
+  for (size_t n = 0; n < numNodes; ++n)
+    if (degrees[n] > average)
+      hubs.push_back(n);
+  galois::ParallelSTL::sort(hubs.begin(), hubs.end(),
+                            [&](uint32_t a, uint32_t b) {
+                              return degrees[a] > degrees[b] ||
+                                     (degrees[a] == degrees[b] && a < b);
+                            });
+
+  // Non-hubs are numbered after the hubs by a prefix sum over non-hub flags
+  LargeArray<uint32_t> perm;
+  perm.create(numNodes);
+  LargeArray<uint64_t> rank;
+  rank.create(numNodes);
+  galois::do_all(
+      galois::iterate(size_t{0}, numNodes),
+      [&](size_t n) { rank[n] = degrees[n] <= average; }, galois::no_stats());
+  galois::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+  galois::do_all(
+      galois::iterate(size_t{0}, numNodes),
+      [&](size_t n) {
+        if (degrees[n] <= average)
+          perm[n] = hubs.size() + rank[n] - 1;
+      },
+      galois::no_stats());
+  galois::do_all(
+      galois::iterate(size_t{0}, hubs.size()),
+      [&](size_t i) { perm[hubs[i]] = i; }, galois::no_stats());
+  return NodePermutation(std::move(perm));
+}
+
+/**
+ * Reverse Cuthill-McKee ordering, which reduces the bandwidth of the
+ * adjacency matrix. Each component is traversed breadth-first from a node
+ * of minimum degree, visiting neighbors in increasing degree order. The
+ * traversal is sequential; degrees are computed in parallel. Intended for
+ * symmetric graphs; on directed graphs only out-edges are followed.
+ */
+template <typename GraphTy>
+NodePermutation rcmOrder(GraphTy& g) {
+  const size_t numNodes = g.size();
+  LargeArray<uint64_t> degrees = internal::reorderDegrees(g);
+  std::vector<uint32_t> starts = internal::byDecreasingDegree(degrees);
+
+  std::vector<uint32_t> order;
+  order.reserve(numNodes);
+  std::vector<char> visited(numNodes, false);
+  std::vector<uint32_t> neighbors;
+
+  for (auto ii = starts.rbegin(), ei = starts.rend(); ii != ei; ++ii) {
+    if (visited[*ii])
+      continue;
+    visited[*ii] = true;
+    size_t head  = order.size();
+    order.push_back(*ii);
+    while (head < order.size()) {
+      uint32_t src = order[head++];
+      neighbors.clear();
+      for (auto e : g.edges(src)) {
+        uint32_t dst = g.getEdgeDst(e);
+        if (!visited[dst]) {
+          visited[dst] = true;
+          neighbors.push_back(dst);
+        }
+      }
+      std::sort(neighbors.begin(), neighbors.end(),
+                [&](uint32_t a, uint32_t b) {
+                  return degrees[a] < degrees[b] ||
+                         (degrees[a] == degrees[b] && a < b);
+                });
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return internal::orderToPermutation(order);
+}
+
+/**
+ * Gorder (Wei et al., SIGMOD 2016): greedily appends the node that shares
+ * the most edges and common in-neighbors with the last window nodes placed.
+ * Scores are kept in a lazily updated max-heap. Common in-neighbors are only
+ * counted through nodes with at most hubDegree out-edges, which bounds the
+ * cost on skewed graphs; by default this is the square root of the number
+ * of nodes. The greedy placement is sequential.
+ *
+ * @param window number of recently placed nodes that contribute to scores
+ * @param hubDegree out-degree above which a node is not used to find
+ * siblings; 0 picks the default
+ */
+template <typename GraphTy>
+NodePermutation gorderOrder(GraphTy& g, unsigned window = 5,
+                            uint64_t hubDegree = 0) {
+  const size_t numNodes = g.size();
+  if (!hubDegree)
+    hubDegree = std::max<uint64_t>(16, std::sqrt(double(numNodes)));
+  LargeArray<uint64_t> degrees = internal::reorderDegrees(g);
+
+  // In-edges in CSR form
+  std::vector<uint64_t> inIndex(numNodes + 1, 0);
+  std::vector<uint32_t> inSrc(g.sizeEdges());
+  for (size_t n = 0; n < numNodes; ++n)
+    for (auto e : g.edges(n))
+      ++inIndex[g.getEdgeDst(e) + 1];
+  std::partial_sum(inIndex.begin(), inIndex.end(), inIndex.begin());
+  {
+    std::vector<uint64_t> fill(inIndex.begin(), inIndex.end() - 1);
+    for (size_t n = 0; n < numNodes; ++n)
+      for (auto e : g.edges(n))
+        inSrc[fill[g.getEdgeDst(e)]++] = n;
+  }
+
+  std::vector<int64_t> score(numNodes, 0);
+  std::vector<char> placed(numNodes, false);
+  std::priority_queue<std::pair<int64_t, uint32_t>> heap;
+
+  auto bump = [&](uint32_t u, int64_t delta) {
+    if (placed[u])
+      return;
+    score[u] += delta;
+    if (score[u] > 0)
+      heap.emplace(score[u], u);
+  };
+
+  auto update = [&](uint32_t v, int64_t delta) {
+    for (auto e : g.edges(v))
+      bump(g.getEdgeDst(e), delta);
+    for (uint64_t i = inIndex[v]; i < inIndex[v + 1]; ++i) {
+      uint32_t w = inSrc[i];
+      bump(w, delta);
+      if (degrees[w] > hubDegree)
+        continue;
+      for (auto e : g.edges(w)) {
+        uint32_t u = g.getEdgeDst(e);
+        if (u != v)
+          bump(u, delta);
+      }
+    }
+  };
+
+  // Nodes not reached through scores are taken in decreasing degree order
+  std::vector<uint32_t> fallback = internal::byDecreasingDegree(degrees);
+  size_t cursor                  = 0;
+
+  std::vector<uint32_t> order;
+  order.reserve(numNodes);
+  while (order.size() < numNodes) {
+    uint32_t v = numNodes;
+    while (!heap.empty()) {
+      auto top = heap.top();
+      heap.pop();
+      if (!placed[top.second] && score[top.second] == top.first) {
+        v = top.second;
+        break;
+      }
+    }
+    if (v == numNodes) {
+      while (placed[fallback[cursor]])
+        ++cursor;
+      v = fallback[cursor];
+    }
+
+    placed[v] = true;
+    order.push_back(v);
+    update(v, 1);
+    if (order.size() > window)
+      update(order[order.size() - 1 - window], -1);
+  }
+
+  return internal::orderToPermutation(order);
+}
+
+//! Computes the permutation for the given policy; None gives the identity
+template <typename GraphTy>
+NodePermutation reorderNodes(GraphTy& g, ReorderPolicy policy) {
+  switch (policy) {
+  case ReorderPolicy::Degree:
+    return degreeSortOrder(g);
+  case ReorderPolicy::HubSort:
+    return hubSortOrder(g);
+  case ReorderPolicy::RCM:
+    return rcmOrder(g);
+  case ReorderPolicy::Gorder:
+    return gorderOrder(g);
+  default:
+    return NodePermutation();
+  }
+}
+
+/**
+ * Builds a copy of an in-memory CSR graph (e.g., {@link LC_CSR_Graph}) with
+ * nodes relabelled by p. Edge data is copied; node data of the new graph is
+ * default constructed. Use {@link permute} with p.forward() to relabel a
+ * {@link FileGraph}.
+ */
+template <typename GraphTy>
+void relabelGraph(GraphTy& in, const NodePermutation& p, GraphTy& out) {
+  const size_t numNodes = in.size();
+
+  LargeArray<uint64_t> edgeEnd;
+  edgeEnd.create(numNodes);
+  galois::do_all(
+      galois::iterate(size_t{0}, numNodes),
+      [&](size_t n) {
+        edgeEnd[p.newId(n)] = internal::reorderDegree(in, n);
+      },
+      galois::no_stats());
+  galois::ParallelSTL::partial_sum(edgeEnd.begin(), edgeEnd.end(),
+                                   edgeEnd.begin());
+
+  out.allocateFrom(numNodes, in.sizeEdges());
+  out.constructNodes();
+  galois::do_all(
+      galois::iterate(size_t{0}, numNodes),
+      [&](size_t n) {
+        uint32_t id = p.newId(n);
+        uint64_t e  = id ? edgeEnd[id - 1] : 0;
+        for (auto ii : in.edges(n)) {
+          uint32_t dst = p.newId(in.getEdgeDst(ii));
+          if constexpr (std::is_void<
+                            typename GraphTy::edge_data_type>::value) {
+            out.constructEdge(e++, dst);
+          } else {
+            out.constructEdge(e++, dst, in.getEdgeData(ii));
+          }
+        }
+        out.fixEndEdge(id, edgeEnd[id]);
+      },
+      galois::no_stats(), galois::steal(), galois::loopname("RelabelGraph"));
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_RUNTIME_CHUNKSIZEADAPTER_H
+#define GALOIS_RUNTIME_CHUNKSIZEADAPTER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "galois/config.h"
+
+namespace galois {
+namespace runtime {
+
+/**
+ * Runtime chunk size selection for loops that hand out work in chunks.
+ *
+ * The chunk size is doubled when a chunk takes much less than TargetNs to
+ * execute, so that scheduling overhead is amortized over more iterations,
+ * and halved when a chunk takes much longer than TargetNs or when the caller
+ * observes load imbalance (e.g., it had to steal or was stolen from), so
+ * that the remaining work is spread more finely.
+ */
+class ChunkSizeAdapter {
+  typedef std::chrono::steady_clock Clock;
+
+  Clock::time_point last;
+  unsigned cur;
+  unsigned maxSize;
+  bool timing;
+
+public:
+  //! Desired execution time of a single chunk in nanoseconds
+  static constexpr uint64_t TargetNs = 10000;
+
+  ChunkSizeAdapter(unsigned initial, unsigned max)
+      : cur(std::max(1U, std::min(initial, max))), maxSize(max),
+        timing(false) {}
+
+  unsigned get() const { return cur; }
+
+  void grow() { cur = std::min(cur * 2, maxSize); }
+
+  void shrink() { cur = std::max(cur / 2, 1U); }
+
+  //! Begin timing a chunk
+  void start() {
+    last   = Clock::now();
+    timing = true;
+  }
+
+  //! End timing the current chunk and adjust the chunk size accordingly
+  void stop() {
+    if (!timing)
+      return;
+    timing = false;
+    uint64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                             last)
+            .count();
+    if (ns < TargetNs / 2)
+      grow();
+    else if (ns > TargetNs * 2)
+      shrink();
+  }
+
+  //! End timing the current chunk and begin timing the next one
+  void lap() {
+    stop();
+    start();
+  }
+};
+
+} // end namespace runtime
+} // end namespace galois
+
+#endif
@@ -34,6 +34,7 @@
 #include "galois/gIO.h"
 #include "galois/MethodFlags.h"
 #include "galois/substrate/PtrLock.h"
+#include "galois/substrate/ThreadPool.h"
 
 namespace galois {
 namespace runtime {
@@ -136,6 +137,10 @@ class SimpleRuntimeContext : public LockManagerBase {
   //! The locks we hold
   Lockable* locks;
   bool customAcquire;
+  //! Thread that created this context
+  unsigned tid;
+  //! Thread owning the lock of the last failed acquire, or ~0U if unknown
+  unsigned conflictOwner;
 
 protected:
   friend void doAcquire(Lockable*, galois::MethodFlag);
@@ -162,6 +167,8 @@ protected:
         addToNhood(lockable);
       }
     } else {
+      SimpleRuntimeContext* owner = getOwner(lockable);
+      conflictOwner               = owner ? owner->tid : ~0U;
       signalConflict(lockable);
     }
   }
@@ -169,10 +176,19 @@ protected:
   void release(Lockable* lockable);
 
 public:
-  SimpleRuntimeContext(bool child = false) : locks(0), customAcquire(child) {}
+  SimpleRuntimeContext(bool child = false)
+      : locks(0), customAcquire(child), tid(substrate::ThreadPool::getTID()),
+        conflictOwner(~0U) {}
   virtual ~SimpleRuntimeContext() {}
 
-  void startIteration() { assert(!locks); }
+  void startIteration() {
+    assert(!locks);
+    conflictOwner = ~0U;
+  }
+
+  //! Thread that held the lock which made the last iteration abort, or ~0U
+  //! if it is not known. Only a hint: the owner may have moved on since.
+  unsigned getConflictOwner() const { return conflictOwner; }
 
   unsigned cancelIteration();
   unsigned commitIteration();
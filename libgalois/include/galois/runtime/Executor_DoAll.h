@@ -22,7 +22,9 @@
 
 #include "galois/config.h"
 #include "galois/gIO.h"
+#include "galois/runtime/ChunkSizeAdapter.h"
 #include "galois/runtime/Executor_OnEach.h"
+#include "galois/runtime/NestedParallel.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
 #include "galois/runtime/Statistics.h"
 #include "galois/substrate/Barrier.h"
@@ -50,6 +52,8 @@ class DoAllStealingExec {
   constexpr static const bool MORE_STATS =
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
+  constexpr static const bool ADAPTIVE =
+      has_trait<adaptive_chunk_size_tag, ArgsTuple>();
 
   struct ThreadContext {
 
@@ -61,18 +65,25 @@ class DoAllStealingExec {
     Diff_ty m_size;
     size_t num_iter;
 
+    // for adaptive chunking
+    ChunkSizeAdapter chunkSize;
+    bool stolenFrom;
+
     // Stats
 
     ThreadContext()
         : work_mutex(), id(substrate::getThreadPool().getMaxThreads()),
-          shared_beg(), shared_end(), m_size(0), num_iter(0) {
+          shared_beg(), shared_end(), m_size(0), num_iter(0),
+          chunkSize(chunk_size_tag::MIN, chunk_size_tag::MAX),
+          stolenFrom(false) {
       // TODO: fix this initialization problem,
       // see initThread
     }
 
-    ThreadContext(unsigned id, Iter beg, Iter end)
+    ThreadContext(unsigned id, Iter beg, Iter end, unsigned chunk_size)
         : work_mutex(), id(id), shared_beg(beg), shared_end(end),
-          m_size(std::distance(beg, end)), num_iter(0) {}
+          m_size(std::distance(beg, end)), num_iter(0),
+          chunkSize(chunk_size, chunk_size_tag::MAX), stolenFrom(false) {}
 
     bool doWork(F func, const unsigned chunk_size) {
       Iter beg(shared_beg);
@@ -84,12 +95,20 @@ class DoAllStealingExec {
 
         didwork = true;
 
+        if (ADAPTIVE) {
+          chunkSize.start();
+        }
+
         for (; beg != end; ++beg) {
           if (NEED_STATS) {
             ++num_iter;
           }
           func(*beg);
         }
+
+        if (ADAPTIVE) {
+          chunkSize.stop();
+        }
       }
 
       return didwork;
@@ -114,11 +133,20 @@ class DoAllStealingExec {
     }
 
   private:
-    bool getWork(Iter& priv_beg, Iter& priv_end, const unsigned chunk_size) {
+    bool getWork(Iter& priv_beg, Iter& priv_end, unsigned chunk_size) {
       bool succ = false;
 
       work_mutex.lock();
       {
+        if (ADAPTIVE) {
+          // other threads are idle; leave them finer-grained work
+          if (stolenFrom) {
+            chunkSize.shrink();
+            stolenFrom = false;
+          }
+          chunk_size = chunkSize.get();
+        }
+
         if (hasWorkWeak()) {
           succ = true;
 
@@ -205,6 +233,8 @@ class DoAllStealingExec {
             steal_from_beg(steal_beg, steal_end, steal_size);
             m_size -= steal_size;
           }
+
+          stolenFrom = true;
         }
 
         work_mutex.unlock();
@@ -250,6 +280,10 @@ private:
       assert(std::distance(steal_beg, steal_end) == steal_size);
 
       poor.assignWork(steal_beg, steal_end, steal_size);
+
+      if (ADAPTIVE) {
+        poor.chunkSize.shrink();
+      }
     }
 
     return succ;
@@ -387,7 +421,7 @@ public:
     unsigned id = substrate::ThreadPool::getTID();
 
     *workers.getLocal(id) =
-        ThreadContext(id, range.local_begin(), range.local_end());
+        ThreadContext(id, range.local_begin(), range.local_end(), chunk_size);
 
     initTime.stop();
   }
@@ -429,6 +463,9 @@ public:
       if (stole) {
         continue;
 
+      } else if (helpNestedLoops()) {
+        continue;
+
       } else {
 
         assert(!ctx.hasWork());
@@ -453,6 +490,10 @@ public:
 
     if (NEED_STATS) {
       galois::runtime::reportStat_Tsum(loopname, "Iterations", ctx.num_iter);
+      if (ADAPTIVE) {
+        galois::runtime::reportStat_Tavg(loopname, "ChunkSize",
+                                         ctx.chunkSize.get());
+      }
     }
   }
 };
@@ -481,6 +522,9 @@ struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
 
+    // Threads that still run their own range, and so may publish nested loops
+    std::atomic<unsigned> working(activeThreads);
+
     runtime::on_each_gen(
         [&](const unsigned int, const unsigned int) {
           static constexpr bool NEED_STATS =
@@ -514,6 +558,13 @@ struct ChooseDoAllImpl<false> {
           }
           execTime.stop();
 
+          --working;
+          while (working.load(std::memory_order_relaxed)) {
+            if (!helpNestedLoops()) {
+              substrate::asmPause();
+            }
+          }
+
           totalTime.stop();
 
           if (NEED_STATS) {
@@ -548,7 +599,13 @@ void do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
   constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
 
   OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
-  internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  if (substrate::getThreadPool().isRunning()) {
+    // Called from inside another parallel section
+    internal::doAllNested(range, func_ref,
+                          get_trait_value<chunk_size_tag>(argsT).value);
+  } else {
+    internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
+  }
 
   timer.stop();
 }
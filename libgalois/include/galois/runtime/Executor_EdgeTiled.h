@@ -0,0 +1,210 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_RUNTIME_EXECUTOR_EDGETILED_H
+#define GALOIS_RUNTIME_EXECUTOR_EDGETILED_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "galois/config.h"
+#include "galois/Bag.h"
+#include "galois/MethodFlags.h"
+#include "galois/Traits.h"
+#include "galois/UserContext.h"
+#include "galois/runtime/Executor_DoAll.h"
+#include "galois/runtime/Executor_ForEach.h"
+#include "galois/runtime/Range.h"
+
+namespace galois {
+namespace runtime {
+
+//! A range of out-edges of a single node
+template <typename Graph>
+struct EdgeTile {
+  typename Graph::GraphNode src;
+  typename Graph::edge_iterator beg;
+  typename Graph::edge_iterator end;
+};
+
+namespace internal {
+
+//! Automatic tile sizes are AutoScale times the average degree, but no
+//! smaller than AutoMin, so only nodes well above the average are split
+constexpr ptrdiff_t AutoScale = 4;
+constexpr ptrdiff_t AutoMin   = 256;
+
+template <typename Graph>
+ptrdiff_t chooseEdgeTileSize(const Graph& graph, ptrdiff_t requested) {
+  if (requested > 0)
+    return std::max(requested, ptrdiff_t{edge_tile_tag::MIN});
+
+  ptrdiff_t nodes = graph.size();
+  ptrdiff_t edges = graph.sizeEdges();
+  ptrdiff_t avg   = nodes ? (edges + nodes - 1) / nodes : 0;
+  return std::max(AutoMin, AutoScale * avg);
+}
+
+//! Calls fn on consecutive tiles covering the out-edges of src. There is
+//! always at least one tile, which is empty if src has no edges.
+template <typename Graph, typename F>
+void splitEdgeTiles(Graph& graph, typename Graph::GraphNode src,
+                    ptrdiff_t tileSize, F&& fn) {
+  auto beg       = graph.edge_begin(src, MethodFlag::UNPROTECTED);
+  const auto end = graph.edge_end(src, MethodFlag::UNPROTECTED);
+  for (; end - beg > tileSize; beg += tileSize)
+    fn(EdgeTile<Graph>{src, beg, beg + tileSize});
+  fn(EdgeTile<Graph>{src, beg, end});
+}
+
+template <typename ArgsTuple>
+auto withEdgeTileDefault(const ArgsTuple& argsTuple) {
+  return std::tuple_cat(
+      argsTuple,
+      get_default_trait_values(argsTuple, std::make_tuple(edge_tile_tag{}),
+                               std::make_tuple(edge_tile<>{})));
+}
+
+} // namespace internal
+
+/**
+ * Context passed to operators of {@link for_each_edges()}. Pushing a node
+ * schedules all of its out-edges, split into tiles if needed.
+ */
+template <typename Graph>
+class EdgeTileContext {
+  using Tile = EdgeTile<Graph>;
+
+  Graph& graph;
+  UserContext<Tile>& ctx;
+  ptrdiff_t tileSize;
+
+public:
+  EdgeTileContext(Graph& g, UserContext<Tile>& c, ptrdiff_t sz)
+      : graph(g), ctx(c), tileSize(sz) {}
+
+  //! Push new work
+  void push(const typename Graph::GraphNode& n) {
+    internal::splitEdgeTiles(graph, n, tileSize,
+                             [&](const Tile& t) { ctx.push(t); });
+  }
+
+  //! Push new work
+  void push_back(const typename Graph::GraphNode& n) { push(n); }
+
+  //! Signal break in parallel loop
+  void breakLoop() { ctx.breakLoop(); }
+
+  //! Force the abort of this iteration
+  void abort() { ctx.abort(); }
+
+  //! Acquire a per-iteration allocator
+  PerIterAllocTy& getPerIterAlloc() { return ctx.getPerIterAlloc(); }
+};
+
+namespace internal {
+
+template <typename Graph, typename F>
+struct EdgeTileOp {
+  Graph& graph;
+  F& func;
+  ptrdiff_t tileSize;
+
+  void operator()(const EdgeTile<Graph>& t,
+                  UserContext<EdgeTile<Graph>>& ctx) const {
+    EdgeTileContext<Graph> tctx(graph, ctx, tileSize);
+    func(t.src, t.beg, t.end, tctx);
+  }
+};
+
+} // namespace internal
+
+template <typename Graph, typename R, typename F, typename ArgsTuple>
+void do_all_edges_gen(Graph& graph, const R& range, F&& func,
+                      const ArgsTuple& argsTuple) {
+  auto argsT         = internal::withEdgeTileDefault(argsTuple);
+  ptrdiff_t tileSize = internal::chooseEdgeTileSize(
+      graph, get_trait_value<edge_tile_tag>(argsT).value);
+
+  // Nodes below the tile size are handled in place; the rest are split and
+  // run in a second loop where every tile is a separate work item
+  InsertBag<EdgeTile<Graph>> tiles;
+  do_all_gen(
+      range,
+      [&](const typename Graph::GraphNode& n) {
+        auto beg = graph.edge_begin(n, MethodFlag::UNPROTECTED);
+        auto end = graph.edge_end(n, MethodFlag::UNPROTECTED);
+        if (end - beg <= tileSize)
+          func(n, beg, end);
+        else
+          internal::splitEdgeTiles(
+              graph, n, tileSize,
+              [&](const EdgeTile<Graph>& t) { tiles.push(t); });
+      },
+      argsTuple);
+
+  if (tiles.empty())
+    return;
+
+  // Tiles are few and large, so they are stolen one at a time; the loop
+  // reports its stats under its own name
+  auto tileArgs = std::tuple_cat(
+      std::make_tuple(steal(), chunk_size<1>()),
+      remove_traits<steal_tag, chunk_size_tag, loopname_tag>(argsTuple));
+  auto tileLoop = [&](const EdgeTile<Graph>& t) { func(t.src, t.beg, t.end); };
+  if constexpr (has_trait<loopname_tag, ArgsTuple>()) {
+    std::string name =
+        std::string(galois::internal::getLoopName(argsTuple)) + "_Tiles";
+    do_all_gen(
+        galois::iterate(tiles)(argsTuple), tileLoop,
+        std::tuple_cat(tileArgs, std::make_tuple(loopname(name.c_str()))));
+  } else {
+    do_all_gen(galois::iterate(tiles)(argsTuple), tileLoop, tileArgs);
+  }
+}
+
+template <typename Graph, typename R, typename F, typename ArgsTuple>
+void for_each_edges_gen(Graph& graph, const R& range, F&& func,
+                        const ArgsTuple& argsTuple) {
+  using Tile         = EdgeTile<Graph>;
+  auto argsT         = internal::withEdgeTileDefault(argsTuple);
+  ptrdiff_t tileSize = internal::chooseEdgeTileSize(
+      graph, get_trait_value<edge_tile_tag>(argsT).value);
+
+  InsertBag<Tile> initial;
+  do_all_gen(
+      range,
+      [&](const typename Graph::GraphNode& n) {
+        internal::splitEdgeTiles(graph, n, tileSize,
+                                 [&](const Tile& t) { initial.push(t); });
+      },
+      std::make_tuple(steal()));
+
+  using Op = internal::EdgeTileOp<Graph, std::remove_reference_t<F>>;
+  for_each_gen(galois::iterate(initial)(argsTuple), Op{graph, func, tileSize},
+               argsTuple);
+}
+
+} // namespace runtime
+} // namespace galois
+
+#endif
@@ -21,15 +21,18 @@
 #define GALOIS_RUNTIME_EXECUTOR_FOREACH_H
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/Mem.h"
 #include "galois/runtime/Context.h"
 #include "galois/runtime/LoopStatistics.h"
+#include "galois/runtime/NestedParallel.h"
 #include "galois/runtime/OperatorReferenceTypes.h"
 #include "galois/runtime/Range.h"
 #include "galois/runtime/Statistics.h"
@@ -48,6 +51,96 @@ namespace galois {
 //! Internal Galois functionality - Use at your own risk.
 namespace runtime {
 
+//! Whether GALOIS_ABORT_TRACE names a file to trace abort ratios to
+bool abortTraceEnabled();
+
+/**
+ * Appends one "LOOP, THREAD, WINDOW, USEC, ABORT_RATIO" line per window of
+ * the calling thread to the file named by GALOIS_ABORT_TRACE; usec is the end
+ * of the window, in microseconds since the thread entered the loop.
+ */
+void traceAbortWindows(const char* loopname,
+                       const std::vector<std::pair<uint64_t, float>>& windows);
+
+/**
+ * Fraction of iterations a thread aborts, measured over windows of Window
+ * iterations and smoothed across windows. With GALOIS_ABORT_TRACE set, the
+ * ratio of every window is also kept and written out by report.
+ */
+class AbortRate {
+  static const unsigned Window       = 256;
+  static const unsigned ThrottleSpins = 4096;
+
+  unsigned attempts = 0;
+  unsigned aborts   = 0;
+  double rate       = 0;
+  double peak       = 0;
+  size_t windows    = 0;
+  size_t hotWindows = 0;
+  size_t throttles  = 0;
+
+  bool tracing = abortTraceEnabled();
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  std::vector<std::pair<uint64_t, float>> trace;
+
+  void endWindow() {
+    double cur = double(aborts) / attempts;
+    rate       = (rate + cur) / 2;
+    peak       = std::max(peak, cur);
+    windows += 1;
+    if (cur >= High)
+      hotWindows += 1;
+    attempts = aborts = 0;
+    if (tracing) {
+      auto usec = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+      trace.emplace_back(usec.count(), cur);
+    }
+  }
+
+public:
+  //! Below this rate conflicts are rare enough to simply retry locally
+  static constexpr double Low = 0.05;
+  //! At or above this rate conflicts are serialized and retries backed off
+  static constexpr double High = 0.25;
+  //! At or above this rate a thread also pauses between rounds of work
+  static constexpr double Throttle = 0.5;
+
+  void commit() {
+    if (++attempts == Window)
+      endWindow();
+  }
+
+  void abort() {
+    aborts += 1;
+    if (++attempts == Window)
+      endWindow();
+  }
+
+  double get() const { return rate; }
+
+  //! Pause the calling thread if it aborts so often that running it only
+  //! feeds more conflicts. Returns true if the thread was throttled.
+  bool throttle() {
+    if (rate < Throttle)
+      return false;
+    for (unsigned i = 0; i < ThrottleSpins; ++i)
+      substrate::asmPause();
+    throttles += 1;
+    return true;
+  }
+
+  void report(const char* loopname) const {
+    reportStat_Tmax(loopname, "AbortRatioPeak", peak);
+    reportStat_Tsum(loopname, "AbortWindows", windows);
+    reportStat_Tsum(loopname, "HighAbortWindows", hotWindows);
+    reportStat_Tsum(loopname, "ThrottledRounds", throttles);
+    if (tracing)
+      traceAbortWindows(loopname, trace);
+  }
+};
+
 template <typename value_type>
 class AbortHandler {
   struct Item {
@@ -59,6 +152,9 @@ class AbortHandler {
   substrate::PerThreadStorage<AbortedList> queues;
   bool useBasicPolicy;
 
+  static const int MaxBackoffShift = 10;
+  static const int MaxEagerRetries = 2;
+
   /**
    * Policy: serialize via tree over sockets.
    */
@@ -119,9 +215,27 @@ class AbortHandler {
    */
   void eagerPolicy(const Item& item) { queues.getLocal()->push(item); }
 
+  /**
+   * Policy: send the item to the thread whose lock it conflicted on, which
+   * serializes iterations contending for the same neighborhood, otherwise
+   * serialize via tree over sockets.
+   */
+  void ownerPolicy(const Item& item, unsigned owner) {
+    if (owner < activeThreads && owner != substrate::ThreadPool::getTID())
+      queues.getRemote(owner)->push(item);
+    else
+      basicPolicy(item);
+  }
+
+  //! Wait exponentially longer on each retry of a hot conflict
+  void backoff(const Item& item) {
+    int n = 1 << std::min(item.retries, MaxBackoffShift);
+    for (int i = 0; i < n; ++i)
+      substrate::asmPause();
+  }
+
 public:
   AbortHandler() {
-    // XXX(ddn): Implement smarter adaptive policy
     useBasicPolicy = substrate::getThreadPool().getMaxSockets() > 2;
   }
 
@@ -133,14 +247,30 @@ public:
     queues.getLocal()->push(item);
   }
 
-  void push(const Item& item) {
+  /**
+   * Requeue an item that aborted again. The policy depends on the abort rate
+   * of the calling thread: rare conflicts are retried locally, frequent ones
+   * are backed off and routed to the owner of the conflicting lock.
+   *
+   * @param rate abort rate of the calling thread
+   * @param owner thread that held the conflicting lock, or ~0U if unknown
+   */
+  void push(const Item& item, const AbortRate& rate, unsigned owner) {
     Item newitem = {item.val, item.retries + 1};
-    if (useBasicPolicy)
+    if (rate.get() < AbortRate::Low && item.retries < MaxEagerRetries) {
+      eagerPolicy(newitem);
+    } else if (rate.get() >= AbortRate::High) {
+      backoff(newitem);
+      ownerPolicy(newitem, owner);
+    } else if (useBasicPolicy) {
       basicPolicy(newitem);
-    else
+    } else {
       doublePolicy(newitem);
+    }
   }
 
+  void push(const value_type& val, const AbortRate&, unsigned) { push(val); }
+
   AbortedList* getQueue() { return queues.getLocal(); }
 };
 
@@ -154,9 +284,12 @@ public:
   static constexpr bool needsAborts =
       !has_trait<disable_conflict_detection_tag, ArgsTy>();
   static constexpr bool needsPia   = has_trait<per_iter_alloc_tag, ArgsTy>();
+  static constexpr bool needsPla   = has_trait<per_loop_alloc_tag, ArgsTy>();
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
+  static constexpr bool adaptiveChunks =
+      has_trait<adaptive_chunk_size_tag, ArgsTy>();
 
 protected:
   typedef typename WorkListTy::value_type value_type;
@@ -165,6 +298,7 @@ protected:
     UserContextAccess<value_type> facing;
     FunctionTy function;
     SimpleRuntimeContext ctx;
+    AbortRate abortRate;
 
     explicit ThreadLocalBasics(FunctionTy fn) : facing(), function(fn), ctx() {}
   };
@@ -189,6 +323,9 @@ protected:
   // members to give higher likelihood of reclaiming PerThreadStorage
 
   AbortHandler<value_type> aborted;
+  //! Only allocated with per_loop_alloc; freed in bulk with the executor
+  std::unique_ptr<PerLoopAllocBaseTy> loopHeap;
+  PerLoopAllocTy loopAlloc;
   substrate::TerminationDetection& term;
   substrate::Barrier& barrier;
 
@@ -214,8 +351,10 @@ protected:
     }
     if (needsPia)
       tld.facing.resetAlloc();
-    if (needsAborts)
+    if (needsAborts) {
       tld.ctx.commitIteration();
+      tld.abortRate.commit();
+    }
     //++tld.stat_commits;
   }
 
@@ -223,9 +362,11 @@ protected:
   GALOIS_ATTRIBUTE_NOINLINE void abortIteration(const Item& item,
                                                 ThreadLocalData& tld) {
     assert(needsAborts);
+    unsigned owner = tld.ctx.getConflictOwner();
     tld.ctx.cancelIteration();
     tld.inc_conflicts();
-    aborted.push(item);
+    tld.abortRate.abort();
+    aborted.push(item, tld.abortRate, owner);
     // clear push buffer
     if (needsPush)
       tld.facing.resetPushBuffer();
@@ -303,6 +444,28 @@ protected:
     return wl.empty();
   }
 
+  void reportSteals(WorkListTy&, ...) {}
+
+  template <typename WL>
+  auto reportSteals(WL& wl, int) -> decltype(wl.localSteals(), void()) {
+    reportStat_Tsum(loopname, "Steals", wl.localSteals());
+  }
+
+  void reportChunkSize(WorkListTy&, ...) {}
+
+  template <typename WL>
+  auto reportChunkSize(WL& wl, int) -> decltype(wl.localChunkSize(), void()) {
+    if (adaptiveChunks)
+      reportStat_Tavg(loopname, "ChunkSize", wl.localChunkSize());
+  }
+
+  void reportWorkListStats() {
+    if (needStats) {
+      reportSteals(wl, 0);
+      reportChunkSize(wl, 0);
+    }
+  }
+
   template <bool couldAbort, bool isLeader>
   void go() {
 
@@ -312,6 +475,8 @@ protected:
     ThreadLocalData tld(origFunction, loopname);
     if (needsBreak)
       tld.facing.setBreakFlag(&broke);
+    if (needsPla)
+      tld.facing.setPerLoopAlloc(&loopAlloc);
     if (couldAbort)
       setThreadContext(&tld.ctx);
     if (needsPush && !couldAbort)
@@ -331,12 +496,21 @@ protected:
           if (couldAbort) {
             b       = handleAborts(tld);
             didWork = b || didWork;
+            // Socket leaders never throttle so some thread always makes
+            // progress
+            if (!isLeader)
+              tld.abortRate.throttle();
           }
         } else { // No try/catch
           bool b  = runQueueSimple(tld);
           didWork = b || didWork;
         }
 
+        // Help other threads with their nested loops
+        if (!didWork) {
+          didWork = internal::helpNestedLoops();
+        }
+
         // Update node color and prop token
         term.localTermination(didWork);
         substrate::asmPause(); // Let token propagate
@@ -356,8 +530,13 @@ protected:
       barrier.wait();
     }
 
-    if (couldAbort)
+    reportWorkListStats();
+
+    if (couldAbort) {
+      if (needStats)
+        tld.abortRate.report(loopname);
       setThreadContext(0);
+    }
   }
 
   struct T1 {};
@@ -365,7 +544,9 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(substrate::getSystemTermination(activeThreads)),
+      : loopHeap(needsPla ? std::make_unique<PerLoopAllocBaseTy>() : nullptr),
+        loopAlloc(loopHeap.get()),
+        term(substrate::getSystemTermination(activeThreads)),
         barrier(getBarrier(activeThreads)), wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f), loopname(galois::internal::getLoopName(args)),
         broke(false), initTime(loopname, "Init"),
@@ -437,15 +618,42 @@ struct reiterator<WLTy, IterTy,
   typedef typename WLTy::template with_iterator<IterTy>::type type;
 };
 
+template <typename WLTy>
+constexpr auto has_with_adaptive_chunks(int) -> decltype(
+    std::declval<typename WLTy::template with_adaptive_chunks<true>>(),
+    bool()) {
+  return true;
+}
+
+template <typename>
+constexpr auto has_with_adaptive_chunks(...) -> bool {
+  return false;
+}
+
+template <typename WLTy, bool Adaptive, typename Enable = void>
+struct readapt {
+  typedef WLTy type;
+};
+
+template <typename WLTy>
+struct readapt<
+    WLTy, true,
+    typename std::enable_if<has_with_adaptive_chunks<WLTy>(0)>::type> {
+  typedef typename WLTy::template with_adaptive_chunks<true> type;
+};
+
 // TODO(ddn): Think about folding in range into args too
 template <typename RangeTy, typename FunctionTy, typename ArgsTy>
 void for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
   typedef typename std::iterator_traits<typename RangeTy::iterator>::value_type
       value_type;
   typedef typename get_trait_type<wl_tag, ArgsTy>::type::type BaseWorkListTy;
-  typedef typename reiterator<BaseWorkListTy, typename RangeTy::iterator>::
-      type ::template retype<value_type>
-          WorkListTy;
+  typedef typename reiterator<BaseWorkListTy, typename RangeTy::iterator>::type
+      IterWorkListTy;
+  constexpr bool ADAPTIVE = has_trait<adaptive_chunk_size_tag, ArgsTy>();
+  typedef typename readapt<IterWorkListTy, ADAPTIVE>::type ::template retype<
+      value_type>
+      WorkListTy;
   using FuncRefType =
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
@@ -20,31 +20,376 @@
 #ifndef GALOIS_RUNTIME_EXECUTOR_ORDERED_H
 #define GALOIS_RUNTIME_EXECUTOR_ORDERED_H
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <vector>
+
 #include "galois/config.h"
+#include "galois/gIO.h"
+#include "galois/gstl.h"
+#include "galois/optional.h"
+#include "galois/PriorityQueue.h"
+#include "galois/runtime/Context.h"
+#include "galois/runtime/LoopStatistics.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/runtime/Substrate.h"
+#include "galois/runtime/UserContextAccess.h"
+#include "galois/substrate/Barrier.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/Threads.h"
+#include "galois/Timer.h"
 
 namespace galois {
 namespace runtime {
+//! Implementation of speculative ordered execution
+namespace internal {
+
+/**
+ * Neighborhood context of a task in the current window. Locks acquired by the
+ * neighborhood function are stolen by higher priority tasks, so after all
+ * neighborhoods have been visited, a task that still owns every lock it asked
+ * for is a source of the dependence graph among window tasks.
+ */
+template <typename T, typename Cmp>
+class OrderedContext : public SimpleRuntimeContext {
+public:
+  T item;
 
-// TODO(ddn): Pull in and integrate in executors from exp
+private:
+  const Cmp* cmp;
+  unsigned long id;
+  bool notReady;
 
-template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
-void for_each_ordered_impl(Iter GALOIS_UNUSED(beg), Iter GALOIS_UNUSED(end),
-                           const Cmp& GALOIS_UNUSED(cmp),
-                           const NhFunc& GALOIS_UNUSED(nhFunc),
-                           const OpFunc& GALOIS_UNUSED(opFunc),
-                           const char* GALOIS_UNUSED(loopname)) {
-  GALOIS_DIE("not yet implemented");
+public:
+  OrderedContext(const T& _item, const Cmp* _cmp, unsigned long _id)
+      : SimpleRuntimeContext(true), item(_item), cmp(_cmp), id(_id),
+        notReady(false) {}
+
+  bool isReady() const { return !notReady; }
+
+  //! Strict priority order between window tasks; equal priorities are broken
+  //! by id so that exactly one task wins each conflict
+  bool isBefore(const OrderedContext& o) const {
+    bool lt = (*cmp)(item, o.item);
+    bool gt = (*cmp)(o.item, item);
+    if (lt != gt)
+      return lt;
+    return id < o.id;
+  }
+
+  virtual void subAcquire(Lockable* lockable, galois::MethodFlag) {
+    if (this->tryLock(lockable))
+      this->addToNhood(lockable);
+
+    OrderedContext* other;
+    do {
+      other = static_cast<OrderedContext*>(this->getOwner(lockable));
+      if (other == this)
+        return;
+      if (other && other->isBefore(*this)) {
+        // A lock that I want but can't get
+        notReady = true;
+        return;
+      }
+    } while (!this->stealByCAS(lockable, other));
+
+    // Disable loser
+    if (other) {
+      // Only need atomic write
+      other->notReady = true;
+    }
+  }
+};
+
+//! Stability test for stable-source algorithms: every source can run
+struct AllSourcesStable {
+  template <typename T>
+  bool operator()(const T&) const {
+    return true;
+  }
+};
+
+/**
+ * Speculative ordered executor in the style of the Implicit Kinetic
+ * Dependence Graph (IKDG). Pending tasks are kept in per-thread min-heaps.
+ * Each round selects a window that is a prefix of the global priority order,
+ * visits the neighborhoods of window tasks in parallel to find the sources of
+ * their dependence graph and then executes the sources in parallel. Tasks that
+ * are not sources, together with newly created tasks, return to the heaps for
+ * later rounds. The window grows or shrinks with the fraction of window tasks
+ * that commit.
+ *
+ * For unstable-source algorithms, a source only runs when the stability test
+ * holds for it; the earliest task of the window always runs so that the loop
+ * makes progress.
+ */
+template <typename T, typename Cmp, typename NhFunc, typename OpFunc,
+          typename StableTest, bool NeedStats>
+class OrderedExecutor {
+  typedef OrderedContext<T, Cmp> Context;
+  typedef galois::MinHeap<T, Cmp> PendingHeap;
+
+  static const size_t MinWindowPerThread     = 4;
+  static const size_t InitialWindowPerThread = 64;
+
+  using LoopStat = LoopStatistics<NeedStats>;
+
+  struct ThreadLocalData : public LoopStat {
+    NhFunc nhFunc;
+    OpFunc opFunc;
+    StableTest stabilityTest;
+    UserContextAccess<T> facing;
+    std::vector<T> candidates;
+    std::deque<Context> contexts;
+    size_t committed;
+    size_t offset;
+
+    ThreadLocalData(const NhFunc& nh, const OpFunc& op, const StableTest& st,
+                    const char* loopname)
+        : LoopStat(loopname), nhFunc(nh), opFunc(op), stabilityTest(st),
+          committed(0), offset(0) {}
+  };
+
+  Cmp cmp;
+  const NhFunc& nhFunc;
+  const OpFunc& opFunc;
+  const StableTest& stabilityTest;
+  const char* loopname;
+  unsigned numActive;
+  substrate::Barrier& barrier;
+
+  substrate::PerThreadStorage<PendingHeap> heaps;
+  substrate::PerThreadStorage<ThreadLocalData*> tlds;
+  std::vector<Context*> window;
+  Context* earliest;
+  size_t windowSize;
+  size_t minWindowSize;
+  size_t rounds;
+  bool done;
+
+  //! Pop a prefix of the local heap into the local candidate list
+  void selectCandidates(ThreadLocalData& tld, PendingHeap& heap) {
+    tld.candidates.clear();
+    size_t quota = std::max<size_t>(windowSize / numActive, 1);
+    for (; quota && !heap.empty(); --quota)
+      tld.candidates.push_back(heap.pop());
+  }
+
+  //! Serial step: the window ends at the earliest task left in any heap
+  void computeBoundary() {
+    galois::optional<T> boundary;
+    for (unsigned i = 0; i < numActive; ++i) {
+      PendingHeap& h = *heaps.getRemote(i);
+      if (!h.empty() && (!boundary || cmp(h.top(), *boundary)))
+        boundary = h.top();
+    }
+
+    size_t total     = 0;
+    size_t committed = 0;
+    for (unsigned i = 0; i < numActive; ++i) {
+      ThreadLocalData& r = **tlds.getRemote(i);
+      PendingHeap& h     = *heaps.getRemote(i);
+      // Candidates were popped in priority order, so anything after the
+      // boundary is at the end of the list
+      while (boundary && !r.candidates.empty() &&
+             cmp(*boundary, r.candidates.back())) {
+        h.push(r.candidates.back());
+        r.candidates.pop_back();
+      }
+      r.offset = total;
+      total += r.candidates.size();
+      committed += r.committed;
+      r.committed = 0;
+    }
+
+    done = total == 0;
+    if (!done && rounds)
+      adaptWindow(committed, window.size());
+    window.resize(total);
+    ++rounds;
+  }
+
+  //! Same policy as the deterministic executor: grow the window while almost
+  //! everything commits and shrink it in proportion to the commit ratio
+  //! otherwise
+  void adaptWindow(size_t committed, size_t attempted) {
+    float commitRatio  = attempted > 0 ? committed / (float)attempted : 0.0;
+    const float target = 0.95;
+
+    if (commitRatio >= target)
+      windowSize += windowSize;
+    else
+      windowSize = commitRatio / target * windowSize;
+
+    if (windowSize < minWindowSize)
+      windowSize = minWindowSize;
+  }
+
+  void createContexts(ThreadLocalData& tld, unsigned tid) {
+    tld.contexts.clear();
+    unsigned long idx = 0;
+    for (const T& item : tld.candidates) {
+      tld.contexts.emplace_back(item, &cmp, idx * numActive + tid);
+      window[tld.offset + idx] = &tld.contexts.back();
+      ++idx;
+    }
+  }
+
+  //! Serial step: find the earliest window task, which is always a safe source
+  void findEarliest() {
+    earliest = nullptr;
+    for (unsigned i = 0; i < numActive; ++i) {
+      ThreadLocalData& r = **tlds.getRemote(i);
+      if (r.contexts.empty())
+        continue;
+      Context* c = &r.contexts.front();
+      if (!earliest || c->isBefore(*earliest))
+        earliest = c;
+    }
+  }
+
+  void visitNeighborhoods(ThreadLocalData& tld, unsigned tid) {
+    auto range = galois::block_range(window.begin(), window.end(), tid,
+                                     numActive);
+    for (auto ii = range.first; ii != range.second; ++ii) {
+      Context* ctx = *ii;
+      ctx->startIteration();
+      tld.inc_iterations();
+      setThreadContext(ctx);
+      tld.nhFunc(ctx->item);
+    }
+    setThreadContext(0);
+  }
+
+  void executeSources(ThreadLocalData& tld, PendingHeap& heap, unsigned tid) {
+    auto range = galois::block_range(window.begin(), window.end(), tid,
+                                     numActive);
+    for (auto ii = range.first; ii != range.second; ++ii) {
+      Context* ctx = *ii;
+      if (ctx == earliest ||
+          (ctx->isReady() && tld.stabilityTest(ctx->item))) {
+        tld.opFunc(ctx->item, tld.facing.data());
+        auto& pb = tld.facing.getPushBuffer();
+        tld.inc_pushes(pb.size());
+        for (auto& x : pb)
+          heap.push(x);
+        tld.facing.resetPushBuffer();
+        tld.facing.resetAlloc();
+        ++tld.committed;
+      } else {
+        tld.inc_conflicts();
+        heap.push(ctx->item);
+      }
+    }
+  }
+
+  void releaseLocks(ThreadLocalData& tld) {
+    for (Context& ctx : tld.contexts)
+      ctx.commitIteration();
+    tld.contexts.clear();
+  }
+
+public:
+  OrderedExecutor(const Cmp& c, const NhFunc& nh, const OpFunc& op,
+                  const StableTest& st, const char* ln)
+      : cmp(c), nhFunc(nh), opFunc(op), stabilityTest(st), loopname(ln),
+        numActive(getActiveThreads()), barrier(getBarrier(numActive)),
+        heaps(cmp), earliest(nullptr), rounds(0), done(false) {
+    minWindowSize = MinWindowPerThread * numActive;
+    windowSize    = InitialWindowPerThread * numActive;
+  }
+
+  template <typename Iter>
+  void initThread(Iter b, Iter e) {
+    unsigned tid   = substrate::ThreadPool::getTID();
+    auto range     = galois::block_range(b, e, tid, numActive);
+    PendingHeap& h = *heaps.getLocal();
+    for (; range.first != range.second; ++range.first)
+      h.push(*range.first);
+  }
+
+  void operator()() {
+    unsigned tid = substrate::ThreadPool::getTID();
+    ThreadLocalData tld(nhFunc, opFunc, stabilityTest, loopname);
+    PendingHeap& heap = *heaps.getLocal();
+    *tlds.getLocal()  = &tld;
+
+    while (true) {
+      selectCandidates(tld, heap);
+      barrier.wait();
+
+      if (tid == 0)
+        computeBoundary();
+      barrier.wait();
+
+      if (done)
+        break;
+
+      createContexts(tld, tid);
+      barrier.wait();
+
+      if (tid == 0)
+        findEarliest();
+      visitNeighborhoods(tld, tid);
+      barrier.wait();
+
+      executeSources(tld, heap, tid);
+      barrier.wait();
+
+      releaseLocks(tld);
+    }
+
+    if (NeedStats && tid == 0)
+      reportStat_Single(loopname, "RoundsExecuted", rounds);
+  }
+};
+
+template <bool NeedStats, typename Iter, typename Cmp, typename NhFunc,
+          typename OpFunc, typename StableTest>
+void for_each_ordered_dispatch(Iter beg, Iter end, const Cmp& cmp,
+                               const NhFunc& nhFunc, const OpFunc& opFunc,
+                               const StableTest& stabilityTest,
+                               const char* loopname) {
+  typedef typename std::iterator_traits<Iter>::value_type value_type;
+  typedef OrderedExecutor<value_type, Cmp, NhFunc, OpFunc, StableTest,
+                          NeedStats>
+      WorkTy;
+
+  CondStatTimer<NeedStats> timer(loopname);
+  timer.start();
+
+  WorkTy W(cmp, nhFunc, opFunc, stabilityTest, loopname);
+  substrate::getThreadPool().run(
+      getActiveThreads(), [&W, beg, end]() { W.initThread(beg, end); },
+      std::ref(getBarrier(getActiveThreads())), std::ref(W));
+
+  timer.stop();
 }
 
+} // namespace internal
+
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc,
           typename StableTest>
-void for_each_ordered_impl(Iter GALOIS_UNUSED(beg), Iter GALOIS_UNUSED(end),
-                           const Cmp& GALOIS_UNUSED(cmp),
-                           const NhFunc& GALOIS_UNUSED(nhFunc),
-                           const OpFunc& GALOIS_UNUSED(opFunc),
-                           const StableTest& GALOIS_UNUSED(stabilityTest),
-                           const char* GALOIS_UNUSED(loopname)) {
-  GALOIS_DIE("not yet implemented");
+void for_each_ordered_impl(Iter beg, Iter end, const Cmp& cmp,
+                           const NhFunc& nhFunc, const OpFunc& opFunc,
+                           const StableTest& stabilityTest,
+                           const char* loopname) {
+  if (loopname)
+    internal::for_each_ordered_dispatch<true>(beg, end, cmp, nhFunc, opFunc,
+                                              stabilityTest, loopname);
+  else
+    internal::for_each_ordered_dispatch<false>(beg, end, cmp, nhFunc, opFunc,
+                                               stabilityTest, "ANON_LOOP");
+}
+
+template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
+void for_each_ordered_impl(Iter beg, Iter end, const Cmp& cmp,
+                           const NhFunc& nhFunc, const OpFunc& opFunc,
+                           const char* loopname) {
+  for_each_ordered_impl(beg, end, cmp, nhFunc, opFunc,
+                        internal::AllSourcesStable(), loopname);
 }
 
 } // end namespace runtime
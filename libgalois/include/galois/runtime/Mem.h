@@ -694,6 +694,34 @@ public:
   }
 };
 
+/**
+ * Arena for memory that lives until the end of a parallel loop or round. Each
+ * thread bumps through its own pages from the page pool, deallocate is a
+ * no-op and clear releases everything at once. Pages released by clear are
+ * kept by each thread for the next round; they go back to the page pool when
+ * the arena is destroyed.
+ */
+class ArenaHeap : private boost::noncopyable {
+  typedef BumpWithMallocHeap<FreeListHeap<SystemHeap>> LocalHeap;
+  substrate::PerThreadStorage<LocalHeap> heaps;
+
+public:
+  enum { AllocSize = 0 };
+
+  inline void* allocate(size_t size) {
+    return heaps.getLocal()->allocate(size);
+  }
+
+  inline void deallocate(void*) {}
+
+  //! Release all allocations of all threads. Not thread-safe: call only when
+  //! no thread is allocating, e.g., between loops.
+  void clear() {
+    for (unsigned i = 0; i < heaps.size(); ++i)
+      heaps.getRemote(i)->clear();
+  }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Now adapt to standard std allocators
 ////////////////////////////////////////////////////////////////////////////////
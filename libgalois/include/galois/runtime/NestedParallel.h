@@ -0,0 +1,189 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_RUNTIME_NESTEDPARALLEL_H
+#define GALOIS_RUNTIME_NESTEDPARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+
+#include "galois/config.h"
+
+namespace galois::runtime {
+
+namespace internal {
+
+/**
+ * A parallel loop over [0, size) started from inside another parallel
+ * section. The starting thread publishes the loop so that threads that run
+ * out of work in the enclosing loop can take chunks of it (see
+ * helpNestedLoops), and then works on the loop itself until no chunks are
+ * left.
+ */
+class NestedLoop {
+public:
+  typedef void (*Body)(void* ctx, size_t begin, size_t end);
+
+private:
+  Body body;
+  void* ctx;
+  size_t size;
+  size_t chunk;
+  std::atomic<size_t> next;
+  //! First exception thrown by the body on a helper thread
+  std::exception_ptr error;
+  std::atomic<bool> failed;
+
+public:
+  NestedLoop(Body b, void* c, size_t sz, size_t ch)
+      : body(b), ctx(c), size(sz), chunk(std::max<size_t>(ch, 1)), next(0),
+        failed(false) {}
+
+  //! Execute chunks until none are left; returns whether any were executed
+  bool work() {
+    bool didWork = false;
+    while (true) {
+      size_t b = next.fetch_add(chunk, std::memory_order_relaxed);
+      if (b >= size) {
+        return didWork;
+      }
+      body(ctx, b, std::min(b + chunk, size));
+      didWork = true;
+    }
+  }
+
+  //! Stop handing out chunks; chunks already taken still run to completion
+  void cancel() { next.store(size); }
+
+  /**
+   * Execute chunks on behalf of the thread that published the loop. If the
+   * body throws, the loop is cancelled and the exception is kept for the
+   * owner to rethrow, since it belongs to the owner's iteration.
+   */
+  bool help() {
+    try {
+      return work();
+    } catch (...) {
+      if (!failed.exchange(true)) {
+        error = std::current_exception();
+      }
+      cancel();
+      return true;
+    }
+  }
+
+  //! Rethrow the exception of a helper; only valid once all have left
+  void rethrow() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+};
+
+/**
+ * Make loop available to other threads. Returns false, without publishing,
+ * if the calling thread already has a loop published or runs an iteration
+ * that may abort (a loop with conflict detection); the caller should then
+ * execute the loop by itself.
+ */
+bool publishNestedLoop(NestedLoop* loop);
+
+//! Withdraw the loop published by the calling thread and wait until no other
+//! thread is executing it
+void retractNestedLoop();
+
+/**
+ * Execute chunks of a nested loop published by another thread. Called by
+ * parallel executors when the calling thread has no work of its own.
+ * Returns whether any work was done.
+ */
+bool helpNestedLoops();
+
+template <typename Iter, typename F>
+void doAllNestedImpl(Iter b, Iter e, F& func, unsigned,
+                     std::input_iterator_tag) {
+  std::for_each(b, e, func);
+}
+
+template <typename Iter, typename F>
+void doAllNestedImpl(Iter b, Iter e, F& func, unsigned chunk_size,
+                     std::random_access_iterator_tag) {
+  struct Context {
+    Iter begin;
+    F* func;
+
+    static void run(void* c, size_t lo, size_t hi) {
+      Context* self = static_cast<Context*>(c);
+      Iter ii = self->begin + lo;
+      Iter ei = self->begin + hi;
+      for (; ii != ei; ++ii) {
+        (*self->func)(*ii);
+      }
+    }
+  };
+
+  Context ctx{b, &func};
+  NestedLoop loop(&Context::run, &ctx, std::distance(b, e), chunk_size);
+
+  if (!publishNestedLoop(&loop)) {
+    loop.work();
+    return;
+  }
+
+  // Withdraw the loop even if func throws, so that helpers do not run the
+  // rest of it on behalf of an iteration that is gone
+  struct Retract {
+    NestedLoop& loop;
+    ~Retract() {
+      loop.cancel();
+      retractNestedLoop();
+    }
+  };
+
+  {
+    Retract retract{loop};
+    loop.work();
+  }
+  loop.rethrow();
+}
+
+/**
+ * Execute a do_all started from inside a parallel section. The calling
+ * thread executes the loop, and idle threads of the enclosing section may
+ * join in; an exception thrown by func on one of them is rethrown on the
+ * calling thread. Ranges without random access are executed serially.
+ */
+template <typename R, typename F>
+void doAllNested(const R& range, F& func, unsigned chunk_size) {
+  auto b = range.begin();
+  auto e = range.end();
+  doAllNestedImpl(
+      b, e, func, chunk_size,
+      typename std::iterator_traits<decltype(b)>::iterator_category());
+}
+
+} // namespace internal
+
+} // namespace galois::runtime
+
+#endif
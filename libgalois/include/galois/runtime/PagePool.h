@@ -30,6 +30,7 @@
 #include "galois/config.h"
 #include "galois/gIO.h"
 #include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/SimpleLock.h"
 #include "galois/substrate/PageAlloc.h"
 #include "galois/substrate/PtrLock.h"
@@ -52,6 +53,8 @@ int numPagePoolAllocTotal();
 //! Returns total large pages allocated for thread by Galois memory management
 //! subsystem
 int numPagePoolAllocForThread(unsigned tid);
+//! Returns pages allocated for thread that are backed by huge pages
+int numPagePoolHugePagesForThread(unsigned tid);
 
 namespace internal {
 
@@ -75,6 +78,9 @@ class PageAllocState {
     assert(ptr);
     auto tid = galois::substrate::ThreadPool::getTID();
     counts[tid] += 1;
+    galois::substrate::memAccount(galois::substrate::MemCategory::PagePool,
+                                  galois::substrate::allocSize(),
+                                  galois::substrate::ThreadPool::getNumaNode());
     std::lock_guard<galois::substrate::SimpleLock> lg(mapLock);
     ownerMap[ptr] = tid;
     return ptr;
@@ -93,6 +99,16 @@ public:
     return std::accumulate(counts.begin(), counts.end(), 0);
   }
 
+  int countHuge(unsigned tid) {
+    galois::substrate::HugePageMap hugePages;
+    size_t bytes = 0;
+    std::lock_guard<galois::substrate::SimpleLock> lg(mapLock);
+    for (auto& kv : ownerMap)
+      if (kv.second == int(tid))
+        bytes += hugePages.hugeBytes(kv.first, galois::substrate::allocSize());
+    return bytes / galois::substrate::allocSize();
+  }
+
   void* pageAlloc() {
     auto tid    = galois::substrate::ThreadPool::getTID();
     HeadPtr& hp = pool[tid].data;
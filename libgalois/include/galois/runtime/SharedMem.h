@@ -25,6 +25,7 @@
 #include "galois/config.h"
 #include "galois/runtime/PagePool.h"
 #include "galois/runtime/Statistics.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/SharedMem.h"
 
 namespace galois::runtime {
@@ -41,6 +42,8 @@ public:
   }
 
   ~SharedMem() {
+    if (substrate::memAccountingEnabled())
+      reportMemAccounting("MemAccounting");
     m_sm.print();
     internal::setSysStatManager(nullptr);
     internal::setPagePoolState(nullptr);
@@ -630,6 +630,12 @@ void reportPageAlloc(const char* category);
 //! Reports NUMA memory stats for all NUMA nodes
 void reportNumaAlloc(const char* category);
 
+//! Reports live bytes and high-water mark of each accounted memory category,
+//! in total and per NUMA node. Nothing is recorded unless accounting is
+//! enabled (see galois::substrate::memAccountingEnabled()).
+//! @param region Region to report the stats under
+void reportMemAccounting(const char* region);
+
 } // end namespace runtime
 } // end namespace galois
 
@@ -35,6 +35,7 @@ public:
   typedef typename SuperTy::FastPushBack FastPushBack;
 
   void resetAlloc() { SuperTy::__resetAlloc(); }
+  void setPerLoopAlloc(PerLoopAllocTy* a) { SuperTy::__setPerLoopAlloc(a); }
   PushBufferTy& getPushBuffer() { return SuperTy::__getPushBuffer(); }
   void resetPushBuffer() { SuperTy::__resetPushBuffer(); }
   SuperTy& data() { return *static_cast<SuperTy*>(this); }
@@ -0,0 +1,99 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_SUBSTRATE_MEMACCOUNTING_H
+#define GALOIS_SUBSTRATE_MEMACCOUNTING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "galois/config.h"
+
+namespace galois {
+namespace substrate {
+
+/**
+ * Kinds of structures whose memory is accounted. Large allocations are
+ * tagged LargeArray unless a MemCategoryScope says otherwise. InsertBag
+ * blocks come from the page pool, so they are also part of PagePool.
+ */
+enum class MemCategory : unsigned {
+  LargeArray,
+  Graph,
+  InsertBag,
+  PerThreadStorage,
+  PagePool,
+  NumCategories
+};
+
+//! Live bytes and high-water mark of a category
+struct MemUsage {
+  int64_t live;
+  int64_t peak;
+};
+
+//! Largest NUMA node id accounted separately; higher ids share its counters
+constexpr unsigned MEM_ACCOUNTING_MAX_NODE = 63;
+
+const char* getMemCategoryName(MemCategory c);
+
+//! Returns true if allocations are accounted, which is off unless the
+//! GALOIS_MEM_ACCOUNTING environment variable is set or it was turned on
+//! with setMemAccounting()
+bool memAccountingEnabled();
+void setMemAccounting(bool enabled);
+
+//! Account bytes allocated (positive) or freed (negative) on a NUMA node
+void memAccount(MemCategory c, int64_t bytes, unsigned node);
+
+//! Account bytes on the node of each of threads [0, numThreads)
+void memAccountPerThread(MemCategory c, int64_t bytesPerThread,
+                         unsigned numThreads);
+
+//! Account bytes spread evenly over threads [0, numThreads)
+void memAccountSpread(MemCategory c, int64_t bytes, unsigned numThreads);
+
+//! Usage of a category over all NUMA nodes
+MemUsage getMemUsage(MemCategory c);
+
+//! Usage of a category on one NUMA node
+MemUsage getMemUsage(MemCategory c, unsigned node);
+
+//! Category of the large allocations made by the calling thread
+MemCategory getLargeAllocCategory();
+
+/**
+ * Tags the large allocations made by the calling thread while in scope, e.g.,
+ * the arrays a graph class allocates through LargeArray.
+ */
+class MemCategoryScope {
+  MemCategory prev;
+
+public:
+  explicit MemCategoryScope(MemCategory c);
+  ~MemCategoryScope();
+
+  MemCategoryScope(const MemCategoryScope&) = delete;
+  MemCategoryScope& operator=(const MemCategoryScope&) = delete;
+};
+
+} // namespace substrate
+} // namespace galois
+
+#endif
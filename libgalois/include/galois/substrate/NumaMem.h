@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "galois/config.h"
+#include "galois/substrate/MemAccounting.h"
 
 namespace galois {
 namespace substrate {
@@ -32,6 +33,12 @@ namespace substrate {
 namespace internal {
 struct largeFreer {
   size_t bytes;
+  //! Accounting of the allocation: category, and the threads its pages are
+  //! spread over or, if numThreads is 0, the NUMA node they are on
+  MemCategory category = MemCategory::LargeArray;
+  unsigned numThreads  = 0;
+  unsigned node        = 0;
+
   void operator()(void* ptr) const;
 };
 } // namespace internal
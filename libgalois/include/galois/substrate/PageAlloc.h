@@ -21,6 +21,7 @@
 #define GALOIS_SUBSTRATE_PAGEALLOC_H
 
 #include <cstddef>
+#include <cstdint>
 
 #include "galois/config.h"
 
@@ -30,6 +31,7 @@
 #include <sys/mman.h>
 
 #include <utility>
+#include <vector>
 #ifdef HAVE_MMAP64
 namespace galois {
 template <typename... Args>
@@ -71,6 +73,41 @@ void* allocPages(unsigned num, bool preFault);
 // free page range
 void freePages(void* ptr, unsigned num);
 
+// round bytes up to a multiple of the largest page size allocPages would try
+// to back them with
+size_t allocSizeFor(size_t bytes);
+
+// advise the OS to back a range with transparent huge pages
+void adviseHugePages(void* ptr, size_t bytes);
+
+/**
+ * Snapshot of how the mappings of this process are backed by huge pages,
+ * read from /proc/self/smaps. Explicit (hugetlbfs) pages are exact;
+ * transparent huge pages are only reported per mapping, so the count for part
+ * of a mapping is prorated.
+ */
+class HugePageMap {
+  struct Mapping {
+    uintptr_t begin;
+    uintptr_t end;
+    size_t pageSize;
+    size_t hugeBytes;
+  };
+  std::vector<Mapping> mappings;
+
+public:
+  HugePageMap();
+
+  // bytes of [ptr, ptr + bytes) backed by huge pages
+  size_t hugeBytes(const void* ptr, size_t bytes) const;
+
+  // number of huge pages backing [ptr, ptr + bytes)
+  size_t count(const void* ptr, size_t bytes) const;
+};
+
+// number of huge pages backing [ptr, ptr + bytes)
+size_t numHugePages(const void* ptr, size_t bytes);
+
 } // namespace substrate
 } // namespace galois
 
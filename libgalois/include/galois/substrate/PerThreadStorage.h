@@ -27,6 +27,7 @@
 
 #include "galois/config.h"
 #include "galois/substrate/HWTopo.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/PaddedLock.h"
 #include "galois/substrate/ThreadPool.h"
 
@@ -94,9 +95,12 @@ protected:
     if (offset == ~0U)
       return;
 
-    for (unsigned n = 0; n < getThreadPool().getMaxThreads(); ++n)
+    unsigned maxThreads = getThreadPool().getMaxThreads();
+    for (unsigned n = 0; n < maxThreads; ++n)
       reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
     b->deallocOffset(offset, sizeof(T));
+    memAccountPerThread(MemCategory::PerThreadStorage, -int64_t(sizeof(T)),
+                        maxThreads);
     offset = ~0U;
   }
 
@@ -111,6 +115,8 @@ public:
     offset = b->allocOffset(sizeof(T));
     for (unsigned n = 0; n < tp.getMaxThreads(); ++n)
       new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+    memAccountPerThread(MemCategory::PerThreadStorage, sizeof(T),
+                        tp.getMaxThreads());
   }
 
   PerThreadStorage(PerThreadStorage&& rhs) : b(rhs.b), offset(rhs.offset) {
@@ -34,12 +34,16 @@ class SharedMem {
   // Order is critical here
   ThreadPool m_tpool;
 
-  std::unique_ptr<internal::LocalTerminationDetection<>> m_termPtr;
+  std::unique_ptr<TerminationDetection> m_termPtr;
   std::unique_ptr<internal::BarrierInstance<>> m_biPtr;
 
 public:
   /**
-   * Initializes the Substrate library components
+   * Initializes the Substrate library components.
+   *
+   * Termination detection uses a token ring. The GALOIS_TERMINATION
+   * environment variable selects another detector: "tree", or
+   * "hierarchical" (per socket, then across sockets).
    */
   SharedMem();
 
@@ -21,6 +21,8 @@
 #define GALOIS_SUBSTRATE_TERMINATION_H
 
 #include <atomic>
+#include <numeric>
+#include <vector>
 
 #include "galois/config.h"
 #include "galois/substrate/PerThreadStorage.h"
@@ -254,6 +256,116 @@ public:
   }
 };
 
+// Dijkstra style 2-pass termination detection over the machine topology.
+// Threads report to the leader of their socket and socket leaders report to
+// thread 0, so each socket reaches quiescence locally before its leader
+// takes part in the exchange across sockets.
+template <typename _UNUSED = void>
+class HierarchicalTerminationDetection : public TerminationDetection {
+
+  struct TokenHolder {
+    // wave this thread has joined; read by its children
+    std::atomic<unsigned> downWave;
+    // last wave finished by this thread and its children; read by its parent
+    std::atomic<unsigned> upWave;
+    // whether any thread below did work during upWave
+    std::atomic<bool> upBlack;
+    // wave this thread is taking part in, 0 if none
+    unsigned wave;
+    bool processIsBlack;
+    bool lastWasWhite; // only used by the master
+  };
+
+  PerThreadStorage<TokenHolder> data;
+
+  unsigned activeThreads = 0;
+  // children of thread i are childIds[childBegin[i], childBegin[i + 1])
+  std::vector<unsigned> childBegin;
+  std::vector<unsigned> childIds;
+
+  static unsigned parentOf(unsigned tid) {
+    auto& tp = getThreadPool();
+    return tp.isLeader(tid) ? 0 : tp.getLeader(tid);
+  }
+
+  void propGlobalTerm() { globalTerm = true; }
+
+  bool isSysMaster() const { return ThreadPool::getTID() == 0; }
+
+protected:
+  virtual void init(unsigned aThreads) {
+    if (aThreads == activeThreads)
+      return;
+    activeThreads = aThreads;
+
+    childBegin.assign(aThreads + 1, 0);
+    for (unsigned t = 1; t < aThreads; ++t)
+      ++childBegin[parentOf(t) + 1];
+    std::partial_sum(childBegin.begin(), childBegin.end(), childBegin.begin());
+
+    std::vector<unsigned> pos(childBegin.begin(), childBegin.end() - 1);
+    childIds.resize(aThreads - 1);
+    for (unsigned t = 1; t < aThreads; ++t)
+      childIds[pos[parentOf(t)]++] = t;
+  }
+
+public:
+  HierarchicalTerminationDetection() {}
+
+  virtual void initializeThread() {
+    TokenHolder& th   = *data.getLocal();
+    th.upWave         = 0;
+    th.upBlack        = false;
+    th.processIsBlack = true;
+    th.lastWasWhite   = false;
+    globalTerm        = false;
+    th.wave           = isSysMaster() ? 1 : 0;
+    th.downWave       = th.wave;
+  }
+
+  virtual void localTermination(bool workHappened) {
+    assert(!(workHappened && globalTerm.get()));
+    TokenHolder& th = *data.getLocal();
+    th.processIsBlack |= workHappened;
+    unsigned tid = ThreadPool::getTID();
+
+    if (!th.wave) {
+      // Join a new wave once our parent has started one
+      TokenHolder& parent = *data.getRemote(parentOf(tid));
+      unsigned w          = parent.downWave.load(std::memory_order_acquire);
+      if (w == th.upWave.load(std::memory_order_relaxed))
+        return;
+      th.wave = w;
+      th.downWave.store(w, std::memory_order_release);
+    }
+
+    bool black = th.processIsBlack;
+    for (unsigned i = childBegin[tid]; i < childBegin[tid + 1]; ++i) {
+      TokenHolder& child = *data.getRemote(childIds[i]);
+      if (child.upWave.load(std::memory_order_acquire) != th.wave)
+        return;
+      black |= child.upBlack.load(std::memory_order_relaxed);
+    }
+
+    // Whole subtree has finished this wave
+    th.processIsBlack = false;
+    if (isSysMaster()) {
+      if (th.lastWasWhite && !black) {
+        // This was the second success
+        propGlobalTerm();
+        return;
+      }
+      th.lastWasWhite = !black;
+      th.wave += 1;
+      th.downWave.store(th.wave, std::memory_order_release);
+    } else {
+      th.upBlack.store(black, std::memory_order_relaxed);
+      th.upWave.store(th.wave, std::memory_order_release);
+      th.wave = 0;
+    }
+  }
+};
+
 void setTermDetect(TerminationDetection* term);
 } // end namespace internal
 
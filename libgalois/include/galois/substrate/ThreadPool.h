@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
@@ -83,18 +84,34 @@ protected:
       }
     }
 
-    void wait(bool fastmode) {
+    void wait(bool fastmode, std::chrono::nanoseconds spin) {
       if (fastmode) {
         while (!fastRelease.load(std::memory_order_relaxed)) {
           asmPause();
         }
         fastRelease = 0;
       } else {
+        // Spin for a while in case another parallel section follows shortly
+        if (spin.count() && spinUntilReleased(spin)) {
+          return;
+        }
         std::unique_lock<std::mutex> lg(m);
         cv.wait(lg, [=] { return !done; });
         // start.acquire();
       }
     }
+
+    bool spinUntilReleased(std::chrono::nanoseconds spin) {
+      auto start = std::chrono::steady_clock::now();
+      for (unsigned i = 1; done; ++i) {
+        asmPause();
+        // checking the clock is expensive; do it only occasionally
+        if (i % 1024 == 0 && std::chrono::steady_clock::now() - start > spin) {
+          return false;
+        }
+      }
+      return true;
+    }
   };
 
   thread_local static per_signal my_box;
@@ -105,6 +122,7 @@ protected:
   unsigned reserved;
   unsigned masterFastmode;
   bool running;
+  std::atomic<std::chrono::nanoseconds::rep> idleSpin;
   std::function<void(void)> work;
 
   //! destroy all threads
@@ -169,6 +187,18 @@ public:
   // experimental: leave busy wait
   void beKind();
 
+  //! default for setIdleSpin
+  static constexpr std::chrono::microseconds DefaultIdleSpin{100};
+
+  //! set how long idle threads spin waiting for the next parallel section
+  //! before blocking. Zero blocks immediately. Ignored while burning power.
+  void setIdleSpin(std::chrono::nanoseconds spin) {
+    idleSpin = spin.count();
+  }
+  std::chrono::nanoseconds getIdleSpin() const {
+    return std::chrono::nanoseconds(idleSpin.load());
+  }
+
   bool isRunning() const { return running; }
 
   //! return the number of non-reserved threads in the pool
@@ -194,6 +224,12 @@ public:
   unsigned getLeader(unsigned tid) const {
     return signals[tid]->topo.socketLeader;
   }
+  bool isCoreLeader(unsigned tid) const {
+    return signals[tid]->topo.coreLeader == tid;
+  }
+  unsigned getCoreLeader(unsigned tid) const {
+    return signals[tid]->topo.coreLeader;
+  }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
     return signals[tid]->topo.cumulativeMaxSocket;
   }
@@ -205,6 +241,7 @@ public:
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
   static unsigned getLeader() { return my_box.topo.socketLeader; }
   static unsigned getSocket() { return my_box.topo.socket; }
+  static unsigned getCoreLeader() { return my_box.topo.coreLeader; }
   static unsigned getCumulativeMaxSocket() {
     return my_box.topo.cumulativeMaxSocket;
   }
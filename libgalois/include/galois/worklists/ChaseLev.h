@@ -0,0 +1,268 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_WORKLIST_CHASELEV_H
+#define GALOIS_WORKLIST_CHASELEV_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#include <boost/utility.hpp>
+
+#include "galois/config.h"
+#include "galois/optional.h"
+#include "galois/Threads.h"
+#include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+#include "galois/worklists/WLCompileCheck.h"
+
+namespace galois {
+namespace worklists {
+
+namespace internal {
+
+/**
+ * Work-stealing deque of Chase and Lev, with the memory orderings of Lê et
+ * al. (PPoPP'13). The owner pushes and takes at the bottom; other threads
+ * steal from the top. Only steals and the take of the last item use atomic
+ * read-modify-write operations.
+ *
+ * Thieves may read a slot while the owner overwrites it, and they discard
+ * what they read if they lose the race, so items must be trivially copyable
+ * in practice; this is checked for the copy constructor and destructor.
+ * Buffers are replaced by larger ones as the deque grows, and old buffers
+ * are kept until the deque is destroyed because thieves may still read them.
+ */
+template <typename T>
+class ChaseLevDeque {
+  static_assert(std::is_trivially_copy_constructible<T>::value &&
+                    std::is_trivially_destructible<T>::value,
+                "ChaseLev items are copied while they may be overwritten");
+
+  struct Buffer {
+    ptrdiff_t mask;
+    Buffer* prev;
+    T* items;
+
+    Buffer(ptrdiff_t size, Buffer* p)
+        : mask(size - 1), prev(p),
+          items(static_cast<T*>(std::malloc(size * sizeof(T)))) {
+      if (!items)
+        throw std::bad_alloc();
+    }
+
+    ~Buffer() { std::free(items); }
+
+    ptrdiff_t size() const { return mask + 1; }
+    T get(ptrdiff_t i) const { return items[i & mask]; }
+    void put(ptrdiff_t i, const T& v) { new (&items[i & mask]) T(v); }
+  };
+
+  static const ptrdiff_t InitialSize = 256;
+
+  substrate::CacheLineStorage<std::atomic<ptrdiff_t>> top;
+  substrate::CacheLineStorage<std::atomic<ptrdiff_t>> bottom;
+  std::atomic<Buffer*> buffer;
+
+  Buffer* grow(Buffer* a, ptrdiff_t t, ptrdiff_t b) {
+    Buffer* n = new Buffer(2 * a->size(), a);
+    for (ptrdiff_t i = t; i < b; ++i)
+      n->put(i, a->get(i));
+    buffer.store(n, std::memory_order_release);
+    return n;
+  }
+
+public:
+  ChaseLevDeque() : top(0), bottom(0), buffer(new Buffer(InitialSize, 0)) {}
+
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  ~ChaseLevDeque() {
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+    while (a) {
+      Buffer* p = a->prev;
+      delete a;
+      a = p;
+    }
+  }
+
+  //! May be called concurrently with steals; read without synchronization
+  bool empty() const {
+    return bottom.data.load(std::memory_order_relaxed) <=
+           top.data.load(std::memory_order_relaxed);
+  }
+
+  //! Owner only
+  void push(const T& val) {
+    ptrdiff_t b = bottom.data.load(std::memory_order_relaxed);
+    ptrdiff_t t = top.data.load(std::memory_order_acquire);
+    Buffer* a   = buffer.load(std::memory_order_relaxed);
+    if (b - t > a->mask)
+      a = grow(a, t, b);
+    a->put(b, val);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.data.store(b + 1, std::memory_order_relaxed);
+  }
+
+  //! Owner only; returns the most recently pushed item
+  galois::optional<T> take() {
+    ptrdiff_t b = bottom.data.load(std::memory_order_relaxed) - 1;
+    Buffer* a   = buffer.load(std::memory_order_relaxed);
+    bottom.data.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ptrdiff_t t = top.data.load(std::memory_order_relaxed);
+
+    galois::optional<T> retval;
+    if (t <= b) {
+      retval = a->get(b);
+      if (t == b) {
+        // Last item: race with thieves for it
+        if (!top.data.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+          retval = galois::optional<T>();
+        bottom.data.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom.data.store(b + 1, std::memory_order_relaxed);
+    }
+    return retval;
+  }
+
+  //! Any thread; returns the least recently pushed item. Fails if the deque
+  //! is empty or another thread took the item first.
+  galois::optional<T> steal() {
+    ptrdiff_t t = top.data.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ptrdiff_t b = bottom.data.load(std::memory_order_acquire);
+
+    if (t < b) {
+      Buffer* a = buffer.load(std::memory_order_acquire);
+      T val     = a->get(t);
+      if (top.data.compare_exchange_strong(t, t + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+        return galois::optional<T>(val);
+    }
+    return galois::optional<T>();
+  }
+};
+
+} // namespace internal
+
+/**
+ * Per-thread work-stealing deques. Each thread pushes onto and pops from the
+ * bottom of its own deque (LIFO), without locks or atomic read-modify-write
+ * operations unless the deque is nearly empty. A thread whose deque is empty
+ * steals single items from the top (FIFO end) of other threads' deques,
+ * trying threads on its own socket before threads on other sockets.
+ *
+ * This suits depth-first algorithms that push a few items per iteration and
+ * mostly pop what they just pushed. Items need trivial copy constructors and
+ * destructors.
+ *
+ * A thread only reports an empty worklist to the executor after it has
+ * drained its own deque, and an item taken by a thief counts as work for
+ * that thread, so the executor's termination detection needs no extra
+ * support.
+ *
+ * @tparam T Item type
+ */
+template <typename T = int, bool Concurrent = true>
+class ChaseLev : private boost::noncopyable {
+public:
+  template <typename _T>
+  using retype = ChaseLev<_T, Concurrent>;
+
+  template <bool _concurrent>
+  using rethread = ChaseLev<T, _concurrent>;
+
+  typedef T value_type;
+
+private:
+  struct Local {
+    internal::ChaseLevDeque<T> deque;
+    size_t steals;
+    Local() : steals(0) {}
+  };
+
+  substrate::PerThreadStorage<Local> local;
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  galois::optional<value_type> doSteal(Local& me) {
+    auto& tp     = substrate::getThreadPool();
+    unsigned id  = tp.getTID();
+    unsigned pkg = substrate::ThreadPool::getSocket();
+    unsigned num = Concurrent ? galois::getActiveThreads() : 1;
+
+    // Threads on our socket first, then the others
+    for (int remote = 0; remote < 2; ++remote) {
+      for (unsigned i = 1; i < num; ++i) {
+        unsigned eid = (id + i) % num;
+        if ((tp.getSocket(eid) != pkg) != bool(remote))
+          continue;
+        Local& victim = *local.getRemote(eid);
+        if (victim.deque.empty())
+          continue;
+        if (galois::optional<value_type> r = victim.deque.steal()) {
+          ++me.steals;
+          return r;
+        }
+      }
+    }
+    return galois::optional<value_type>();
+  }
+
+public:
+  void push(const value_type& val) { local.getLocal()->deque.push(val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    Local& me = *local.getLocal();
+    while (b != e)
+      me.deque.push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    auto rp = range.local_pair();
+    push(rp.first, rp.second);
+  }
+
+  //! Number of items the calling thread stole from other threads
+  size_t localSteals() { return local.getLocal()->steals; }
+
+  galois::optional<value_type> pop() {
+    Local& me = *local.getLocal();
+    if (galois::optional<value_type> r = me.deque.take())
+      return r;
+    return doSteal(me);
+  }
+};
+GALOIS_WLCOMPILECHECK(ChaseLev)
+
+} // end namespace worklists
+} // end namespace galois
+
+#endif
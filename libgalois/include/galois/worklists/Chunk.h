@@ -22,6 +22,7 @@
 
 #include "galois/config.h"
 #include "galois/FixedSizeRing.h"
+#include "galois/runtime/ChunkSizeAdapter.h"
 #include "galois/runtime/Mem.h"
 #include "galois/substrate/PaddedLock.h"
 #include "galois/worklists/WLCompileCheck.h"
@@ -55,23 +56,33 @@ struct squeue<false, PS, TQ> {
 };
 
 //! Common functionality to all chunked worklists
+//!
+//! With Adaptive, chunks have room for up to 4 * ChunkSize items, and each
+//! thread fills the chunks it pushes up to a limit that starts at ChunkSize
+//! and is adjusted at runtime (see runtime::ChunkSizeAdapter).
 template <typename T, template <typename, bool> class QT, bool Distributed,
-          bool IsStack, int ChunkSize, bool Concurrent>
+          bool IsStack, int ChunkSize, bool Concurrent, bool Adaptive = false>
 struct ChunkMaster {
   template <typename _T>
-  using retype =
-      ChunkMaster<_T, QT, Distributed, IsStack, ChunkSize, Concurrent>;
+  using retype = ChunkMaster<_T, QT, Distributed, IsStack, ChunkSize,
+                             Concurrent, Adaptive>;
 
   template <int _chunk_size>
-  using with_chunk_size =
-      ChunkMaster<T, QT, Distributed, IsStack, _chunk_size, Concurrent>;
+  using with_chunk_size = ChunkMaster<T, QT, Distributed, IsStack, _chunk_size,
+                                      Concurrent, Adaptive>;
 
   template <bool _Concurrent>
-  using rethread =
-      ChunkMaster<T, QT, Distributed, IsStack, ChunkSize, _Concurrent>;
+  using rethread = ChunkMaster<T, QT, Distributed, IsStack, ChunkSize,
+                               _Concurrent, Adaptive>;
+
+  template <bool _Adaptive>
+  using with_adaptive_chunks = ChunkMaster<T, QT, Distributed, IsStack,
+                                           ChunkSize, Concurrent, _Adaptive>;
 
 private:
-  class Chunk : public FixedSizeRing<T, ChunkSize>,
+  static const int Capacity = Adaptive ? 4 * ChunkSize : ChunkSize;
+
+  class Chunk : public FixedSizeRing<T, Capacity>,
                 public QT<Chunk, Concurrent>::ListNode {};
 
   runtime::FixedSizeAllocator<Chunk> alloc;
@@ -79,7 +90,9 @@ private:
   struct p {
     Chunk* cur;
     Chunk* next;
-    p() : cur(0), next(0) {}
+    size_t steals;
+    runtime::ChunkSizeAdapter chunkSize;
+    p() : cur(0), next(0), steals(0), chunkSize(ChunkSize, Capacity) {}
   };
 
   typedef QT<Chunk, Concurrent> LevelItem;
@@ -108,22 +121,37 @@ private:
     return I.pop();
   }
 
-  Chunk* popChunk() {
+  //! Pop from our socket's queue first, then visit the other sockets in
+  //! order starting from the next one. Only socket leaders are probed since
+  //! every thread on a socket shares its leader's queue.
+  Chunk* popChunk(p& n) {
+    if (Adaptive)
+      n.chunkSize.stop();
+
     int id   = Q.myEffectiveID();
     Chunk* r = popChunkByID(id);
-    if (r)
+    if (r) {
+      if (Adaptive)
+        n.chunkSize.start();
       return r;
-
-    for (int i = id + 1; i < (int)Q.size(); ++i) {
-      r = popChunkByID(i);
-      if (r)
-        return r;
     }
 
-    for (int i = 0; i < id; ++i) {
-      r = popChunkByID(i);
-      if (r)
+    auto& tp     = substrate::getThreadPool();
+    unsigned pkg = substrate::ThreadPool::getSocket();
+    for (int i = 1; i < (int)Q.size(); ++i) {
+      int eid = (id + i) % Q.size();
+      if (!tp.isLeader(eid) || tp.getSocket(eid) == pkg)
+        continue;
+      r = popChunkByID(eid);
+      if (r) {
+        ++n.steals;
+        // Work is scarce locally, so hand out what we push in smaller pieces
+        if (Adaptive) {
+          n.chunkSize.shrink();
+          n.chunkSize.start();
+        }
         return r;
+      }
     }
 
     return 0;
@@ -132,7 +160,8 @@ private:
   template <typename... Args>
   T* emplacei(p& n, Args&&... args) {
     T* retval = 0;
-    if (n.next && (retval = n.next->emplace_back(std::forward<Args>(args)...)))
+    if (n.next && (!Adaptive || n.next->size() < n.chunkSize.get()) &&
+        (retval = n.next->emplace_back(std::forward<Args>(args)...)))
       return retval;
     if (n.next)
       pushChunk(n.next);
@@ -181,7 +210,7 @@ public:
         return &n.next->back();
       if (n.next)
         delChunk(n.next);
-      n.next = popChunk();
+      n.next = popChunk(n);
       if (n.next && !n.next->empty())
         return &n.next->back();
       return NULL;
@@ -190,7 +219,7 @@ public:
         return &n.cur->front();
       if (n.cur)
         delChunk(n.cur);
-      n.cur = popChunk();
+      n.cur = popChunk(n);
       if (!n.cur) {
         n.cur  = n.next;
         n.next = 0;
@@ -235,6 +264,14 @@ public:
     push(rp.first, rp.second);
   }
 
+  //! Number of chunks the calling thread took from other sockets' queues
+  size_t localSteals() { return data.get().steals; }
+
+  //! Number of items the calling thread currently puts in each chunk
+  size_t localChunkSize() {
+    return Adaptive ? data.get().chunkSize.get() : ChunkSize;
+  }
+
   galois::optional<value_type> pop() {
     p& n = data.get();
     galois::optional<value_type> retval;
@@ -243,7 +280,7 @@ public:
         return retval;
       if (n.next)
         delChunk(n.next);
-      n.next = popChunk();
+      n.next = popChunk(n);
       if (n.next)
         return n.next->extract_back();
       return galois::optional<value_type>();
@@ -252,7 +289,7 @@ public:
         return retval;
       if (n.cur)
         delChunk(n.cur);
-      n.cur = popChunk();
+      n.cur = popChunk(n);
       if (!n.cur) {
         n.cur  = n.next;
         n.next = 0;
@@ -0,0 +1,289 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_WORKLIST_MULTIQUEUE_H
+#define GALOIS_WORKLIST_MULTIQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "galois/config.h"
+#include "galois/optional.h"
+#include "galois/substrate/PaddedLock.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/worklists/WLCompileCheck.h"
+
+namespace galois {
+namespace runtime {
+extern unsigned activeThreads;
+}
+namespace worklists {
+
+/**
+ * Relaxed priority scheduling without an indexer. The worklist is a
+ * collection of C * T binary heaps (T is the number of active threads), each
+ * protected by its own lock. Pushes go to a random heap; pops look at the
+ * tops of two random heaps and take the better one, so that items come out
+ * in roughly, but not exactly, priority order.
+ *
+ * Unlike {@link OrderedByIntegerMetric}, only a comparator is needed, so
+ * there is no bucket width to tune. Priority is given to the least element
+ * under Comparator, as with {@link OrderedList} and galois::MinHeap.
+ *
+ * An example:
+ * \code
+ * using WL = galois::worklists::MultiQueue<std::less<Item>, Item>;
+ * galois::for_each(galois::iterate(items), Fn, galois::wl<WL>());
+ * \endcode
+ *
+ * @tparam Comparator  Strict weak ordering on T
+ * @tparam T           Item type
+ * @tparam Concurrent  Whether the worklist is accessed concurrently
+ * @tparam C           Number of heaps per thread
+ * @tparam StickPeriod Number of consecutive pushes (pops) a thread sends to
+ *                     (takes from) the same heap before choosing another
+ *                     one at random
+ */
+template <typename Comparator = std::less<int>, typename T = int,
+          bool Concurrent = true, unsigned C = 2, unsigned StickPeriod = 1>
+class MultiQueue : private boost::noncopyable {
+  static_assert(C > 0, "need at least one heap per thread");
+  static_assert(StickPeriod > 0, "stick period must be positive");
+
+public:
+  template <typename _T>
+  using retype = MultiQueue<Comparator, _T, Concurrent, C, StickPeriod>;
+
+  template <bool _concurrent>
+  using rethread = MultiQueue<Comparator, T, _concurrent, C, StickPeriod>;
+
+  template <unsigned _c>
+  using with_queues_per_thread = MultiQueue<Comparator, T, Concurrent, _c,
+                                            StickPeriod>;
+
+  template <unsigned _period>
+  using with_stick_period = MultiQueue<Comparator, T, Concurrent, C, _period>;
+
+  typedef T value_type;
+
+private:
+  struct Heap : public substrate::PaddedLock<Concurrent> {
+    std::vector<T> items;
+    //! Number of items; may be read without holding the lock
+    std::atomic<size_t> count;
+
+    Heap() : count(0) {}
+
+    bool maybeEmpty() const {
+      return count.load(std::memory_order_relaxed) == 0;
+    }
+  };
+
+  struct ThreadData {
+    uint64_t seed;
+    unsigned pushHeap;
+    unsigned pushLeft;
+    unsigned popHeap;
+    unsigned popLeft;
+
+    ThreadData()
+        : seed(0x9E3779B97F4A7C15ULL * (substrate::ThreadPool::getTID() + 1)),
+          pushHeap(0), pushLeft(0), popHeap(0), popLeft(0) {}
+  };
+
+  //! Inverted comparison so that std heap algorithms keep the least element
+  //! at the front
+  struct HeapCompare {
+    const Comparator& cmp;
+    bool operator()(const T& a, const T& b) const { return cmp(b, a); }
+  };
+
+  Comparator cmp;
+  std::vector<substrate::CacheLineStorage<Heap>> heaps;
+  substrate::PerThreadStorage<ThreadData> tdata;
+
+  unsigned nextRandom(ThreadData& td) {
+    // xorshift64*
+    td.seed ^= td.seed >> 12;
+    td.seed ^= td.seed << 25;
+    td.seed ^= td.seed >> 27;
+    return (td.seed * 0x2545F4914F6CDD1DULL) >> 32;
+  }
+
+  Heap& randomHeap(ThreadData& td) {
+    return heaps[nextRandom(td) % heaps.size()].get();
+  }
+
+  void pushLocked(Heap& h, const value_type& val) {
+    h.items.push_back(val);
+    std::push_heap(h.items.begin(), h.items.end(), HeapCompare{cmp});
+    h.count.store(h.items.size(), std::memory_order_relaxed);
+  }
+
+  galois::optional<value_type> popLocked(Heap& h) {
+    if (h.items.empty())
+      return galois::optional<value_type>();
+    std::pop_heap(h.items.begin(), h.items.end(), HeapCompare{cmp});
+    galois::optional<value_type> retval(std::move(h.items.back()));
+    h.items.pop_back();
+    h.count.store(h.items.size(), std::memory_order_relaxed);
+    return retval;
+  }
+
+  //! Lock some heap, starting with the sticky one
+  Heap& lockForPush(ThreadData& td) {
+    if (td.pushLeft) {
+      --td.pushLeft;
+      Heap& h = heaps[td.pushHeap].get();
+      if (h.try_lock())
+        return h;
+    }
+    while (true) {
+      unsigned idx = nextRandom(td) % heaps.size();
+      Heap& h      = heaps[idx].get();
+      if (h.try_lock()) {
+        td.pushHeap = idx;
+        td.pushLeft = StickPeriod - 1;
+        return h;
+      }
+    }
+  }
+
+  galois::optional<value_type> popSticky(ThreadData& td) {
+    galois::optional<value_type> retval;
+    if (!td.popLeft)
+      return retval;
+    --td.popLeft;
+    Heap& h = heaps[td.popHeap].get();
+    if (h.maybeEmpty() || !h.try_lock())
+      return retval;
+    retval = popLocked(h);
+    h.unlock();
+    return retval;
+  }
+
+  //! Two-choice pop: compare the tops of two random heaps and take the
+  //! better one
+  galois::optional<value_type> popTwoChoice(ThreadData& td) {
+    galois::optional<value_type> retval;
+    unsigned i = nextRandom(td) % heaps.size();
+    unsigned j = nextRandom(td) % heaps.size();
+    Heap& a    = heaps[i].get();
+    Heap& b    = heaps[j].get();
+    if (a.maybeEmpty() && b.maybeEmpty())
+      return retval;
+    if (b.maybeEmpty() || i == j) {
+      if (!a.try_lock())
+        return retval;
+      retval = popLocked(a);
+      a.unlock();
+      td.popHeap = i;
+    } else if (a.maybeEmpty()) {
+      if (!b.try_lock())
+        return retval;
+      retval = popLocked(b);
+      b.unlock();
+      td.popHeap = j;
+    } else {
+      if (!a.try_lock())
+        return retval;
+      if (!b.try_lock()) {
+        retval = popLocked(a);
+        a.unlock();
+        td.popHeap = i;
+      } else {
+        bool useB = !b.items.empty() &&
+                    (a.items.empty() || cmp(b.items.front(), a.items.front()));
+        retval    = popLocked(useB ? b : a);
+        b.unlock();
+        a.unlock();
+        td.popHeap = useB ? j : i;
+      }
+    }
+    if (retval)
+      td.popLeft = StickPeriod - 1;
+    return retval;
+  }
+
+  //! Visit every heap so that an empty result really means empty
+  galois::optional<value_type> popScan(ThreadData& td) {
+    galois::optional<value_type> retval;
+    unsigned start = nextRandom(td) % heaps.size();
+    for (unsigned k = 0; k < heaps.size(); ++k) {
+      Heap& h = heaps[(start + k) % heaps.size()].get();
+      if (h.maybeEmpty())
+        continue;
+      h.lock();
+      retval = popLocked(h);
+      h.unlock();
+      if (retval)
+        return retval;
+    }
+    return retval;
+  }
+
+public:
+  explicit MultiQueue(const Comparator& c = Comparator())
+      : cmp(c), heaps(Concurrent ? C * runtime::activeThreads : 1) {}
+
+  void push(const value_type& val) {
+    Heap& h = lockForPush(*tdata.getLocal());
+    pushLocked(h, val);
+    h.unlock();
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    ThreadData& td = *tdata.getLocal();
+    while (b != e) {
+      Heap& h = lockForPush(td);
+      pushLocked(h, *b++);
+      h.unlock();
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    auto rp = range.local_pair();
+    push(rp.first, rp.second);
+  }
+
+  galois::optional<value_type> pop() {
+    ThreadData& td = *tdata.getLocal();
+    galois::optional<value_type> retval = popSticky(td);
+    if (retval)
+      return retval;
+    // A few random attempts before falling back to a full scan
+    for (unsigned k = 0; k < 2 * C; ++k) {
+      retval = popTwoChoice(td);
+      if (retval)
+        return retval;
+    }
+    return popScan(td);
+  }
+};
+GALOIS_WLCOMPILECHECK(MultiQueue)
+
+} // end namespace worklists
+} // end namespace galois
+
+#endif
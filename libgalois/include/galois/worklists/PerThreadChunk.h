@@ -243,53 +243,76 @@ public:
 
 template <typename InnerWL>
 class StealingQueue : private boost::noncopyable {
-  substrate::PerThreadStorage<std::pair<InnerWL, unsigned>> local;
+  struct Local {
+    InnerWL wl;
+    unsigned victim;
+    size_t steals;
+    Local() : victim(0), steals(0) {}
+  };
 
+  substrate::PerThreadStorage<Local> local;
+
+  ChunkHeader* stealHalfFrom(Local& me, unsigned eid) {
+    return me.wl.stealHalfAndPop(local.getRemote(eid)->wl);
+  }
+
+  //! Victims are tried in order of topological distance: threads sharing
+  //! our physical core, then threads on our socket, then remote sockets.
   GALOIS_ATTRIBUTE_NOINLINE
   ChunkHeader* doSteal() {
-    std::pair<InnerWL, unsigned>& me = *local.getLocal();
-    auto& tp                         = substrate::getThreadPool();
-    unsigned id                      = tp.getTID();
-    unsigned pkg                     = substrate::ThreadPool::getSocket();
-    unsigned num                     = galois::getActiveThreads();
-
-    // First steal from this socket
-    for (unsigned eid = id + 1; eid < num; ++eid) {
-      if (tp.getSocket(eid) == pkg) {
-        ChunkHeader* c = me.first.stealHalfAndPop(local.getRemote(eid)->first);
-        if (c)
+    Local& me    = *local.getLocal();
+    auto& tp     = substrate::getThreadPool();
+    unsigned id  = tp.getTID();
+    unsigned pkg = substrate::ThreadPool::getSocket();
+    unsigned cl  = substrate::ThreadPool::getCoreLeader();
+    unsigned num = galois::getActiveThreads();
+
+    // First steal from SMT siblings
+    for (unsigned i = 1; i < num; ++i) {
+      unsigned eid = (id + i) % num;
+      if (tp.getCoreLeader(eid) == cl) {
+        if (ChunkHeader* c = stealHalfFrom(me, eid))
           return c;
       }
     }
-    for (unsigned eid = 0; eid < id; ++eid) {
-      if (tp.getSocket(eid) == pkg) {
-        ChunkHeader* c = me.first.stealHalfAndPop(local.getRemote(eid)->first);
-        if (c)
+
+    // Then from the rest of this socket
+    for (unsigned i = 1; i < num; ++i) {
+      unsigned eid = (id + i) % num;
+      if (tp.getSocket(eid) == pkg && tp.getCoreLeader(eid) != cl) {
+        if (ChunkHeader* c = stealHalfFrom(me, eid))
           return c;
       }
     }
 
-    // Leaders can cross socket
+    // Leaders can cross socket. Probe one remote thread per attempt, cycling
+    // through the other sockets in order starting from the next one.
     if (substrate::ThreadPool::isLeader()) {
-      unsigned eid = (id + me.second) % num;
-      ++me.second;
-      if (id != eid && tp.isLeader(eid)) {
-        ChunkHeader* c = me.first.stealAllAndPop(local.getRemote(eid)->first);
-        if (c)
-          return c;
+      for (unsigned i = 1; i < num; ++i) {
+        me.victim    = me.victim % (num - 1) + 1;
+        unsigned eid = (id + me.victim) % num;
+        if (tp.getSocket(eid) != pkg)
+          return stealHalfFrom(me, eid);
       }
     }
     return 0;
   }
 
 public:
-  void push(ChunkHeader* c) { local.getLocal()->first.push(c); }
+  void push(ChunkHeader* c) { local.getLocal()->wl.push(c); }
 
   ChunkHeader* pop() {
-    if (ChunkHeader* c = local.getLocal()->first.pop())
+    Local& me = *local.getLocal();
+    if (ChunkHeader* c = me.wl.pop())
       return c;
-    return doSteal();
+    ChunkHeader* c = doSteal();
+    if (c)
+      ++me.steals;
+    return c;
   }
+
+  //! Number of successful steals by the calling thread
+  size_t localSteals() { return local.getLocal()->steals; }
 };
 
 template <bool IsLocallyLIFO, int ChunkSize, typename Container, typename T>
@@ -384,6 +407,9 @@ public:
     push(rp.first, rp.second);
   }
 
+  //! Number of chunks the calling thread stole from other threads
+  size_t localSteals() { return worklist.localSteals(); }
+
   galois::optional<value_type> pop() {
     std::pair<Chunk*, Chunk*>& tld = *data.getLocal();
     Chunk*& n                      = getPopChunk(tld);
@@ -25,9 +25,11 @@
 #include "galois/worklists/AdaptiveObim.h"
 #include "galois/worklists/PerThreadChunk.h"
 #include "galois/worklists/BulkSynchronous.h"
+#include "galois/worklists/ChaseLev.h"
 #include "galois/worklists/Chunk.h"
 #include "galois/worklists/Simple.h"
 #include "galois/worklists/LocalQueue.h"
+#include "galois/worklists/MultiQueue.h"
 #include "galois/worklists/Obim.h"
 #include "galois/worklists/OrderedList.h"
 #include "galois/worklists/OwnerComputes.h"
@@ -38,7 +40,8 @@ namespace galois {
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, {@link PerSocketChunkLIFO} or {@link
  * PerSocketChunkFIFO} is a reasonable scheduling policy. If you need
- * approximate priority scheduling, use {@link OrderedByIntegerMetric}. For
+ * approximate priority scheduling, use {@link OrderedByIntegerMetric}, or
+ * {@link MultiQueue} if there is no natural integer priority to bucket by. For
  * debugging, you may be interested in {@link FIFO} or {@link LIFO}, which try
  * to follow serial order exactly.
  *
@@ -0,0 +1,74 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/runtime/Executor_ForEach.h"
+#include "galois/gIO.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/substrate/SimpleLock.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr static const char* const ABORT_TRACE_ENV_VAR = "GALOIS_ABORT_TRACE";
+
+struct AbortTraceFile {
+  std::string name;
+  bool enabled = false;
+  //! the file is truncated by the first write of the process
+  bool started = false;
+  galois::substrate::SimpleLock lock;
+
+  AbortTraceFile() {
+    enabled = galois::substrate::EnvCheck(ABORT_TRACE_ENV_VAR, name) &&
+              !name.empty();
+  }
+};
+
+AbortTraceFile& getAbortTraceFile() {
+  static AbortTraceFile f;
+  return f;
+}
+
+} // namespace
+
+bool galois::runtime::abortTraceEnabled() {
+  return getAbortTraceFile().enabled;
+}
+
+void galois::runtime::traceAbortWindows(
+    const char* loopname,
+    const std::vector<std::pair<uint64_t, float>>& windows) {
+  AbortTraceFile& f = getAbortTraceFile();
+  unsigned tid      = substrate::ThreadPool::getTID();
+
+  std::lock_guard<substrate::SimpleLock> lg(f.lock);
+  FILE* fh = fopen(f.name.c_str(), f.started ? "a" : "w");
+  GALOIS_ASSERT(fh != nullptr, "abort trace file error");
+  if (!f.started) {
+    fprintf(fh, "LOOP, THREAD, WINDOW, USEC, ABORT_RATIO\n");
+    f.started = true;
+  }
+  for (size_t i = 0; i < windows.size(); ++i) {
+    fprintf(fh, "%s, %u, %zu, %lu, %.4f\n", loopname ? loopname : "(NULL)",
+            tid, i, (unsigned long)windows[i].first, windows[i].second);
+  }
+  fclose(fh);
+}
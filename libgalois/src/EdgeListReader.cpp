@@ -0,0 +1,79 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/gIO.h"
+#include "galois/graphs/EdgeListReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace galois {
+namespace graphs {
+namespace internal {
+
+MappedTextFile::MappedTextFile(const std::string& filename) {
+  fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+  struct stat buf;
+  if (fstat(fd, &buf) == -1)
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  length = buf.st_size;
+  if (!length)
+    return;
+
+  void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (base == MAP_FAILED)
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  // Every byte is read exactly once, front to back within each range
+  madvise(base, length, MADV_SEQUENTIAL);
+  mapping = static_cast<const char*>(base);
+}
+
+MappedTextFile::~MappedTextFile() {
+  if (mapping)
+    munmap(const_cast<char*>(mapping), length);
+  if (fd != -1)
+    close(fd);
+}
+
+size_t MappedTextFile::lineStart(size_t offset) const {
+  if (offset == 0 || offset >= length)
+    return std::min(offset, length);
+  const void* nl =
+      std::memchr(mapping + offset - 1, '\n', length - offset + 1);
+  return nl ? static_cast<const char*>(nl) - mapping + 1 : length;
+}
+
+std::pair<const char*, const char*>
+MappedTextFile::lineRange(unsigned tid, unsigned total) const {
+  size_t begin = lineStart(length * tid / total);
+  size_t end   = lineStart(length * (tid + 1) / total);
+  return std::make_pair(mapping + begin, mapping + end);
+}
+
+} // namespace internal
+} // namespace graphs
+} // namespace galois
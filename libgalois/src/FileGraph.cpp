@@ -26,7 +26,9 @@
 
 #include "galois/gIO.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/substrate/MemAccounting.h"
 #include "galois/substrate/PageAlloc.h"
+#include "galois/substrate/ThreadPool.h"
 
 #include <cassert>
 #include <fstream>
@@ -80,9 +82,28 @@ FileGraph& FileGraph::operator=(FileGraph&& other) {
   return *this;
 }
 
+/**
+ * Tracks a new mapping of the graph and accounts it on the NUMA node of the
+ * calling thread.
+ *
+ * @param mappings Mappings structure that tracks the things we have mmap'd
+ * @param ptr Start of the mapping
+ * @param len Length of the mapping
+ */
+template <typename Mappings>
+static void addMapping(Mappings& mappings, void* ptr, size_t len) {
+  unsigned node = galois::substrate::ThreadPool::getNumaNode();
+  galois::substrate::memAccount(galois::substrate::MemCategory::Graph, len,
+                                node);
+  mappings.push_back({ptr, len, node});
+}
+
 FileGraph::~FileGraph() {
-  for (auto& m : mappings)
+  for (auto& m : mappings) {
     munmap(m.ptr, m.len);
+    galois::substrate::memAccount(galois::substrate::MemCategory::Graph,
+                                  -int64_t(m.len), m.node);
+  }
   for (auto& fd : fds)
     close(fd);
 }
@@ -181,6 +202,17 @@ void* FileGraph::fromGraph(FileGraph& g, size_t sizeof_edge_data) {
                     g.graphVersion);
 }
 
+char* FileGraph::allocateMapping(size_t bytes) {
+  char* base = (char*)mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                           _MAP_ANON | MAP_PRIVATE, -1, 0);
+  if (base == MAP_FAILED)
+    GALOIS_SYS_DIE("failed allocating graph");
+  galois::substrate::adviseHugePages(base, bytes);
+
+  addMapping(mappings, base, bytes);
+  return base;
+}
+
 void* FileGraph::fromArrays(uint64_t* out_idx, uint64_t num_nodes, void* outs,
                             uint64_t num_edges, char* edge_data,
                             size_t sizeof_edge_data, uint64_t node_offset,
@@ -189,12 +221,7 @@ void* FileGraph::fromArrays(uint64_t* out_idx, uint64_t num_nodes, void* outs,
   size_t bytes =
       rawBlockSize(num_nodes, num_edges, sizeof_edge_data, oGraphVersion);
 
-  char* base = (char*)mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
-                           _MAP_ANON | MAP_PRIVATE, -1, 0);
-  if (base == MAP_FAILED)
-    GALOIS_SYS_DIE("failed allocating graph");
-
-  mappings.push_back({base, bytes});
+  char* base = allocateMapping(bytes);
 
   uint64_t* fptr = (uint64_t*)base;
   // set header info
@@ -288,7 +315,9 @@ void FileGraph::fromFile(const std::string& filename) {
   void* base = mmap(nullptr, buf.st_size, PROT_READ, _MAP_BASE, fd, 0);
   if (base == MAP_FAILED)
     GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
-  mappings.push_back({base, static_cast<size_t>(buf.st_size)});
+  // Already populated, so this only lets khugepaged collapse the file pages
+  galois::substrate::adviseHugePages(base, buf.st_size);
+  addMapping(mappings, base, buf.st_size);
 
   fromMem(base, 0, 0, buf.st_size);
 }
@@ -313,7 +342,8 @@ static void* loadFromOffset(int fd, offset_t offset, size_t length,
   void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, aligned);
   if (base == MAP_FAILED)
     GALOIS_SYS_DIE("failed allocating for fd ", fd);
-  mappings.push_back({base, length});
+  galois::substrate::adviseHugePages(base, length);
+  addMapping(mappings, base, length);
   return static_cast<char*>(base) + alignment;
 }
 
@@ -355,7 +385,7 @@ void FileGraph::partFromFile(const std::string& filename, NodeRange nrange,
   void* base        = mmap(nullptr, headerSize, PROT_READ, MAP_PRIVATE, fd, 0);
   if (base == MAP_FAILED)
     GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
-  mappings.push_back({base, headerSize});
+  addMapping(mappings, base, headerSize);
 
   // Read metadata of whole graph
   fromMem(base, *nrange.first, *erange.first, 0);
@@ -699,6 +729,14 @@ void FileGraph::initNodeDegrees() {
   }
 }
 
+size_t FileGraph::numHugePages() const {
+  galois::substrate::HugePageMap hugePages;
+  size_t num = 0;
+  for (auto& m : mappings)
+    num += hugePages.count(m.ptr, m.len);
+  return num;
+}
+
 uint64_t FileGraph::getDegree(uint32_t node_id) const {
   // node_degrees array should be initialized
   assert(this->node_degrees.size());
@@ -714,8 +752,9 @@ void FileGraphWriter::phase1() {
       nullptr, bytes, PROT_READ | PROT_WRITE, _MAP_ANON | MAP_PRIVATE, -1, 0));
   if (mmap_base == MAP_FAILED)
     GALOIS_SYS_DIE("failed allocating graph to write");
+  galois::substrate::adviseHugePages(mmap_base, bytes);
 
-  mappings.push_back({mmap_base, bytes});
+  addMapping(mappings, mmap_base, bytes);
 
   uint64_t* fptr = reinterpret_cast<uint64_t*>(mmap_base);
   // set header info
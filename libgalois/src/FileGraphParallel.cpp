@@ -17,38 +17,48 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "galois/Endian.h"
+#include "galois/gIO.h"
 #include "galois/graphs/FileGraph.h"
-#include "galois/substrate/ThreadPool.h"
-#include "galois/substrate/HWTopo.h"
+#include "galois/graphs/FileReader.h"
 
-#include <mutex>
-#include <condition_variable>
+#include <algorithm>
+#include <cstring>
 
 namespace galois {
 namespace graphs {
 
 void FileGraph::fromFileInterleaved(const std::string& filename,
                                     size_t sizeofEdgeData) {
-  fromFile(filename);
-
-  std::mutex lock;
-  std::condition_variable cond;
-  auto& tp            = substrate::getThreadPool();
-  unsigned maxSockets = tp.getMaxSockets();
-  unsigned count      = maxSockets;
-
-  // Interleave across all NUMA nodes
-  tp.run(tp.getMaxThreads(), [&]() {
-    std::unique_lock<std::mutex> lk(lock);
-    if (substrate::ThreadPool::isLeader()) {
-      pageInByNode(substrate::ThreadPool::getSocket(), maxSockets,
-                   sizeofEdgeData);
-      if (--count == 0)
-        cond.notify_all();
-    } else {
-      cond.wait(lk, [&]() { return count == 0; });
-    }
-  });
+  // Rather than faulting in a private file mapping page by page, copy the
+  // file into anonymous memory with large parallel reads. FileReader hands
+  // blocks to threads round robin, so the first touches spread the graph
+  // across all NUMA nodes.
+  FileReader reader(filename);
+  uint64_t header[4];
+  if (reader.size() < sizeof(header))
+    GALOIS_DIE("'", filename, "' is not a gr file");
+  char* base = allocateMapping(reader.size());
+  reader.read(base, 0, sizeof(header));
+  std::memcpy(header, base, sizeof(header));
+
+  uint64_t version  = convert_le64toh(header[0]);
+  uint64_t numNodes = convert_le64toh(header[2]);
+  uint64_t numEdges = convert_le64toh(header[3]);
+  if (version != 1 && version != 2)
+    GALOIS_DIE("unknown file version: ", version);
+
+  // Without edge data there is no need to read past the edge destinations
+  uint64_t bytes = reader.size();
+  if (!sizeofEdgeData) {
+    uint64_t dstSize = version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+    bytes = std::min(bytes, sizeof(header) + sizeof(uint64_t) * numNodes +
+                                dstSize * numEdges);
+  }
+  reader.read(base + sizeof(header), sizeof(header), bytes - sizeof(header));
+  reader.reportStats("FileGraph");
+
+  fromMem(base, 0, 0, reader.size());
 }
 
 } // namespace graphs
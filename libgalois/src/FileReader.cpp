@@ -0,0 +1,350 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/gIO.h"
+#include "galois/Timer.h"
+#include "galois/graphs/FileReader.h"
+#include "galois/runtime/Statistics.h"
+#include "galois/substrate/EnvCheck.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef GALOIS_USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+//! Range of the file covered by one read request
+struct Block {
+  char* dst;
+  uint64_t offset;
+  uint64_t len;
+};
+
+//! Reads the block with blocking preads, retrying short reads
+void preadBlock(int fd, Block b) {
+  while (b.len) {
+    ssize_t r = pread(fd, b.dst, b.len, b.offset);
+    if (r < 0 && errno == EINTR)
+      continue;
+    if (r < 0)
+      GALOIS_SYS_DIE("failed reading graph file");
+    if (r == 0)
+      GALOIS_DIE("unexpected end of graph file");
+    b.dst += r;
+    b.offset += r;
+    b.len -= r;
+  }
+}
+
+#ifdef GALOIS_USE_IO_URING
+
+/**
+ * Minimal io_uring instance driven by raw system calls (liburing is not a
+ * dependency). Only one thread uses a ring, so the submission side needs no
+ * synchronization beyond publishing the tail to the kernel.
+ */
+class Ring : private boost::noncopyable {
+  int fd            = -1;
+  unsigned features = 0;
+  void* sqRing;
+  size_t sqRingLen;
+  void* cqRing;
+  size_t cqRingLen;
+  io_uring_sqe* sqes;
+  size_t sqesLen;
+
+  unsigned* sqTail;
+  unsigned* sqMask;
+  unsigned* sqArray;
+  unsigned* cqHead;
+  unsigned* cqTail;
+  unsigned* cqMask;
+  io_uring_cqe* cqes;
+
+  template <typename T>
+  static T* at(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+  }
+
+public:
+  explicit Ring(unsigned entries) {
+    io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    int r = syscall(__NR_io_uring_setup, entries, &p);
+    if (r < 0)
+      return;
+
+    sqRingLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqRingLen = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+      sqRingLen = cqRingLen = std::max(sqRingLen, cqRingLen);
+    sqesLen = p.sq_entries * sizeof(io_uring_sqe);
+
+    sqRing = mmap(nullptr, sqRingLen, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, r, IORING_OFF_SQ_RING);
+    cqRing = single ? sqRing
+                    : mmap(nullptr, cqRingLen, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, r, IORING_OFF_CQ_RING);
+    void* s = mmap(nullptr, sqesLen, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, r, IORING_OFF_SQES);
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || s == MAP_FAILED) {
+      if (sqRing != MAP_FAILED)
+        munmap(sqRing, sqRingLen);
+      if (!single && cqRing != MAP_FAILED)
+        munmap(cqRing, cqRingLen);
+      if (s != MAP_FAILED)
+        munmap(s, sqesLen);
+      close(r);
+      return;
+    }
+
+    fd       = r;
+    features = p.features;
+    sqes     = static_cast<io_uring_sqe*>(s);
+    sqTail  = at<unsigned>(sqRing, p.sq_off.tail);
+    sqMask  = at<unsigned>(sqRing, p.sq_off.ring_mask);
+    sqArray = at<unsigned>(sqRing, p.sq_off.array);
+    cqHead  = at<unsigned>(cqRing, p.cq_off.head);
+    cqTail  = at<unsigned>(cqRing, p.cq_off.tail);
+    cqMask  = at<unsigned>(cqRing, p.cq_off.ring_mask);
+    cqes    = at<io_uring_cqe>(cqRing, p.cq_off.cqes);
+  }
+
+  ~Ring() {
+    if (fd == -1)
+      return;
+    munmap(sqes, sqesLen);
+    if (cqRing != sqRing)
+      munmap(cqRing, cqRingLen);
+    munmap(sqRing, sqRingLen);
+    close(fd);
+  }
+
+  bool valid() const { return fd != -1; }
+
+  /**
+   * Whether the kernel implements positional IORING_OP_READ. Kernels that
+   * can create rings but predate it (before 5.6) fail every read with
+   * -EINVAL, so this is checked with a probe, not assumed from valid().
+   */
+  bool supportsRead() const {
+    if (!valid() || !(features & IORING_FEAT_RW_CUR_POS))
+      return false;
+    constexpr unsigned numOps = IORING_OP_READ + 1;
+    alignas(io_uring_probe) char
+        buf[sizeof(io_uring_probe) + numOps * sizeof(io_uring_probe_op)];
+    std::memset(buf, 0, sizeof(buf));
+    auto* probe = reinterpret_cast<io_uring_probe*>(buf);
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe,
+                numOps) < 0)
+      return false;
+    return probe->last_op >= IORING_OP_READ &&
+           (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+  }
+
+  //! Queues a read; the caller never queues more than the ring holds
+  void prepareRead(int file, const Block& b, uint64_t userData) {
+    unsigned tail   = *sqTail;
+    unsigned idx    = tail & *sqMask;
+    io_uring_sqe& e = sqes[idx];
+    std::memset(&e, 0, sizeof(e));
+    e.opcode    = IORING_OP_READ;
+    e.fd        = file;
+    e.addr      = reinterpret_cast<uint64_t>(b.dst);
+    e.len       = b.len;
+    e.off       = b.offset;
+    e.user_data = userData;
+    sqArray[idx] = idx;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  //! Submits queued reads and waits until at least one has completed
+  void submitAndWait(unsigned toSubmit) {
+    while (true) {
+      int r = syscall(__NR_io_uring_enter, fd, toSubmit, 1,
+                      IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (r >= 0)
+        return;
+      if (errno != EINTR)
+        GALOIS_SYS_DIE("failed submitting reads");
+      // The interrupted call may have consumed part of the queue
+      toSubmit = 0;
+    }
+  }
+
+  bool popCompletion(uint64_t& userData, int& res) {
+    unsigned head = *cqHead;
+    if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+      return false;
+    io_uring_cqe& c = cqes[head & *cqMask];
+    userData        = c.user_data;
+    res             = c.res;
+    __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+};
+
+//! Checks whether the kernel lets us create rings that can read files
+bool ioUringUsable() {
+  if (galois::substrate::EnvCheck("GALOIS_DO_NOT_USE_IO_URING"))
+    return false;
+  Ring probe(1);
+  return probe.supportsRead();
+}
+
+#endif
+
+} // namespace
+
+namespace galois {
+namespace graphs {
+
+FileReader::FileReader(const std::string& filename) {
+  fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+  struct stat buf;
+  if (fstat(fd, &buf) == -1)
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  length = buf.st_size;
+  // Every byte is read once; let the kernel read ahead aggressively
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+#ifdef GALOIS_USE_IO_URING
+  ioUring = ioUringUsable();
+#else
+  ioUring = false;
+#endif
+}
+
+FileReader::~FileReader() { close(fd); }
+
+void FileReader::readBlocks(unsigned tid, unsigned total, char* dst,
+                            uint64_t offset, uint64_t len) {
+  uint64_t end   = offset + len;
+  uint64_t first = offset / blockSize;
+  uint64_t last  = (end - 1) / blockSize;
+
+  auto block = [&](uint64_t k) {
+    uint64_t b = std::max(offset, k * blockSize);
+    uint64_t e = std::min(end, (k + 1) * blockSize);
+    return Block{dst + (b - offset), b, e - b};
+  };
+
+  uint64_t k = first + tid;
+
+#ifdef GALOIS_USE_IO_URING
+  if (ioUring) {
+    Ring ring(queueDepth);
+    if (ring.valid()) {
+      Block slots[queueDepth];
+      unsigned freeSlots[queueDepth];
+      unsigned numFree = queueDepth;
+      for (unsigned i = 0; i < queueDepth; ++i)
+        freeSlots[i] = i;
+
+      unsigned toSubmit = 0;
+      // Set when the kernel rejects a read; the remaining blocks use pread
+      bool fallback = false;
+      while ((!fallback && k <= last) || numFree != queueDepth) {
+        for (; !fallback && k <= last && numFree; k += total) {
+          unsigned s = freeSlots[--numFree];
+          slots[s]   = block(k);
+          ring.prepareRead(fd, slots[s], s);
+          ++toSubmit;
+        }
+        ring.submitAndWait(toSubmit);
+        toSubmit = 0;
+
+        uint64_t s;
+        int res;
+        while (ring.popCompletion(s, res)) {
+          Block& b = slots[s];
+          if (res == -EINVAL || res == -EOPNOTSUPP) {
+            fallback = true;
+            preadBlock(fd, b);
+            freeSlots[numFree++] = s;
+            continue;
+          }
+          if (res < 0) {
+            errno = -res;
+            GALOIS_SYS_DIE("failed reading graph file");
+          }
+          if (res == 0)
+            GALOIS_DIE("unexpected end of graph file");
+          if (uint64_t(res) < b.len) {
+            // Short read: the remainder goes out with the next submission
+            b.dst += res;
+            b.offset += res;
+            b.len -= res;
+            ring.prepareRead(fd, b, s);
+            ++toSubmit;
+          } else {
+            freeSlots[numFree++] = s;
+          }
+        }
+      }
+    }
+  }
+#endif
+
+  for (; k <= last; k += total)
+    preadBlock(fd, block(k));
+}
+
+void FileReader::read(void* dst, uint64_t offset, uint64_t len) {
+  if (!len)
+    return;
+  if (offset + len > length)
+    GALOIS_DIE("read past the end of the graph file");
+
+  Timer timer;
+  timer.start();
+  galois::on_each([&](unsigned tid, unsigned total) {
+    readBlocks(tid, total, static_cast<char*>(dst), offset, len);
+  });
+  timer.stop();
+
+  bytesRead += len;
+  readUsec += timer.get_usec();
+}
+
+void FileReader::reportStats(const char* region) const {
+  galois::runtime::reportStat_Single(region, "ReadBytes", bytesRead);
+  galois::runtime::reportStat_Single(region, "ReadTime", readUsec / 1000);
+  // bytes per microsecond / 1000 = GB/s
+  double gbps = readUsec ? double(bytesRead) / readUsec / 1000 : 0.0;
+  galois::runtime::reportStat_Single(region, "ReadThroughputGBps", gbps);
+}
+
+} // namespace graphs
+} // namespace galois
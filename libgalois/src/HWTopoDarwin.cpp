@@ -103,6 +103,16 @@ HWTopoInfo makeHWTopo() {
     tti[i].cumulativeMaxSocket = m;
   }
 
+  for (unsigned i = 0; i < mti.maxThreads; ++i) {
+    unsigned core = tti[i].osContext / logicalPerPhysical;
+    for (unsigned j = 0; j <= i; ++j) {
+      if (tti[j].osContext / logicalPerPhysical == core) {
+        tti[i].coreLeader = j;
+        break;
+      }
+    }
+  }
+
   return {
       .machineTopoInfo = mti,
       .threadTopoInfo  = tti,
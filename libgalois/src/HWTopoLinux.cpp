@@ -250,11 +250,17 @@ galois::substrate::HWTopoInfo makeHWTopo() {
         info.begin(),
         std::find_if(info.begin(), info.end(),
                      [pid](const cpuinfo& c) { return c.physid == pid; }));
+    unsigned cid        = info[i].coreid;
+    unsigned coreLeader = std::distance(
+        info.begin(), std::find_if(info.begin(), info.end(),
+                                   [pid, cid](const cpuinfo& c) {
+                                     return c.physid == pid && c.coreid == cid;
+                                   }));
     retTTI.push_back(galois::substrate::ThreadTopoInfo{
         i, leader, repid,
         (unsigned)std::distance(numaNodes.begin(),
                                 numaNodes.find(info[i].numaNode)),
-        mid, info[i].proc, info[i].numaNode});
+        mid, info[i].proc, info[i].numaNode, coreLeader});
   }
 
   return {
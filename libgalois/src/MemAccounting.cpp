@@ -0,0 +1,139 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/substrate/MemAccounting.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/substrate/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace galois::substrate;
+
+namespace {
+
+constexpr unsigned NumCategories = unsigned(MemCategory::NumCategories);
+constexpr unsigned NumNodes      = MEM_ACCOUNTING_MAX_NODE + 1;
+
+struct Counter {
+  std::atomic<int64_t> live;
+  std::atomic<int64_t> peak;
+
+  void add(int64_t bytes) {
+    int64_t cur  = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t prev = peak.load(std::memory_order_relaxed);
+    while (cur > prev && !peak.compare_exchange_weak(prev, cur,
+                                                     std::memory_order_relaxed))
+      ;
+  }
+
+  MemUsage get() const {
+    return {live.load(std::memory_order_relaxed),
+            peak.load(std::memory_order_relaxed)};
+  }
+};
+
+// Constant initialized, so usable from static constructors and destructors
+Counter totals[NumCategories];
+Counter perNode[NumCategories][NumNodes];
+
+// -1 until GALOIS_MEM_ACCOUNTING is read
+std::atomic<int> enabled{-1};
+
+thread_local MemCategory largeCategory = MemCategory::LargeArray;
+
+} // namespace
+
+const char* galois::substrate::getMemCategoryName(MemCategory c) {
+  switch (c) {
+  case MemCategory::LargeArray:
+    return "LargeArray";
+  case MemCategory::Graph:
+    return "Graph";
+  case MemCategory::InsertBag:
+    return "InsertBag";
+  case MemCategory::PerThreadStorage:
+    return "PerThreadStorage";
+  case MemCategory::PagePool:
+    return "PagePool";
+  default:
+    return "Unknown";
+  }
+}
+
+bool galois::substrate::memAccountingEnabled() {
+  int e = enabled.load(std::memory_order_relaxed);
+  if (e < 0) {
+    e = EnvCheck("GALOIS_MEM_ACCOUNTING") ? 1 : 0;
+    int expected = -1;
+    if (!enabled.compare_exchange_strong(expected, e))
+      e = expected;
+  }
+  return e;
+}
+
+void galois::substrate::setMemAccounting(bool e) { enabled = e; }
+
+void galois::substrate::memAccount(MemCategory c, int64_t bytes,
+                                   unsigned node) {
+  if (!memAccountingEnabled() || !bytes)
+    return;
+  totals[unsigned(c)].add(bytes);
+  perNode[unsigned(c)][std::min(node, MEM_ACCOUNTING_MAX_NODE)].add(bytes);
+}
+
+void galois::substrate::memAccountPerThread(MemCategory c,
+                                            int64_t bytesPerThread,
+                                            unsigned numThreads) {
+  if (!memAccountingEnabled() || !bytesPerThread)
+    return;
+  auto& tp = getThreadPool();
+  for (unsigned tid = 0; tid < numThreads; ++tid)
+    memAccount(c, bytesPerThread, tp.getNumaNode(tid));
+}
+
+void galois::substrate::memAccountSpread(MemCategory c, int64_t bytes,
+                                         unsigned numThreads) {
+  if (!memAccountingEnabled() || !bytes)
+    return;
+  // The remainder goes to thread 0, so freeing the same bytes over the same
+  // threads undoes the allocation exactly
+  numThreads    = std::max(numThreads, 1U);
+  int64_t share = bytes / int64_t(numThreads);
+  auto& tp      = getThreadPool();
+  memAccount(c, bytes - share * (numThreads - 1), tp.getNumaNode(0));
+  for (unsigned tid = 1; tid < numThreads; ++tid)
+    memAccount(c, share, tp.getNumaNode(tid));
+}
+
+MemUsage galois::substrate::getMemUsage(MemCategory c) {
+  return totals[unsigned(c)].get();
+}
+
+MemUsage galois::substrate::getMemUsage(MemCategory c, unsigned node) {
+  return perNode[unsigned(c)][std::min(node, MEM_ACCOUNTING_MAX_NODE)].get();
+}
+
+MemCategory galois::substrate::getLargeAllocCategory() { return largeCategory; }
+
+MemCategoryScope::MemCategoryScope(MemCategory c) : prev(largeCategory) {
+  largeCategory = c;
+}
+
+MemCategoryScope::~MemCategoryScope() { largeCategory = prev; }
@@ -0,0 +1,118 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/runtime/NestedParallel.h"
+#include "galois/runtime/Context.h"
+#include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/ThreadPool.h"
+
+#include <vector>
+
+namespace galois::runtime {
+extern unsigned int activeThreads;
+}
+
+namespace {
+
+struct Slot {
+  std::atomic<galois::runtime::internal::NestedLoop*> loop{nullptr};
+  //! number of threads that may be executing loop
+  std::atomic<unsigned> helpers{0};
+};
+
+//! number of published loops; lets idle threads skip scanning the slots
+std::atomic<unsigned> numPublished{0};
+
+Slot& getSlot(unsigned tid) {
+  static std::vector<galois::substrate::CacheLineStorage<Slot>> slots(
+      galois::substrate::getThreadPool().getMaxThreads());
+  return slots[tid].get();
+}
+
+} // namespace
+
+bool galois::runtime::internal::publishNestedLoop(NestedLoop* loop) {
+  // Helpers run iterations outside of the context of the owner, which would
+  // bypass its conflict detection and rerun them if it aborts
+  if (getThreadContext()) {
+    return false;
+  }
+  Slot& me = getSlot(substrate::ThreadPool::getTID());
+  if (me.loop.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  me.loop = loop;
+  ++numPublished;
+  return true;
+}
+
+void galois::runtime::internal::retractNestedLoop() {
+  Slot& me = getSlot(substrate::ThreadPool::getTID());
+  me.loop  = nullptr;
+  --numPublished;
+  // helpers register before reading loop, so once they have all left, no
+  // one can still be using it
+  while (me.helpers.load()) {
+    substrate::asmPause();
+  }
+}
+
+bool galois::runtime::internal::helpNestedLoops() {
+  if (!numPublished.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  unsigned tid = substrate::ThreadPool::getTID();
+  unsigned num = activeThreads;
+  for (unsigned i = 1; i < num; ++i) {
+    Slot& s = getSlot((tid + i) % num);
+    if (!s.loop.load(std::memory_order_relaxed)) {
+      continue;
+    }
+
+    bool didWork = false;
+    {
+      // Registered for as long as the loop may be in use, even if something
+      // below throws, or the owner would wait for this thread forever.
+      // Nested loops are not conflict-checked on helper threads.
+      struct Helping {
+        Slot& slot;
+        SimpleRuntimeContext* ctx;
+
+        explicit Helping(Slot& s) : slot(s), ctx(getThreadContext()) {
+          ++slot.helpers;
+          setThreadContext(nullptr);
+        }
+        ~Helping() {
+          setThreadContext(ctx);
+          --slot.helpers;
+        }
+      } helping(s);
+
+      if (NestedLoop* loop = s.loop.load()) {
+        didWork = loop->help();
+      }
+    }
+
+    if (didWork) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -134,23 +134,30 @@ static void largeFree(void* ptr, size_t bytes) {
   freePages(ptr, bytes / allocSize());
 }
 
-void galois::substrate::internal::largeFreer::operator()(void* ptr) const {
-  largeFree(ptr, bytes);
+//! Account an allocation of the calling thread whose pages are spread over
+//! numThreads threads, or on the calling thread's node if numThreads is 0
+static internal::largeFreer accounted(size_t bytes, unsigned numThreads) {
+  internal::largeFreer f{bytes, getLargeAllocCategory(), numThreads,
+                         ThreadPool::getNumaNode()};
+  if (numThreads)
+    memAccountSpread(f.category, bytes, numThreads);
+  else
+    memAccount(f.category, bytes, f.node);
+  return f;
 }
 
-// round data to a multiple of mult
-static size_t roundup(size_t data, size_t mult) {
-  auto rem = data % mult;
-
-  if (!rem)
-    return data;
-  return data + (mult - rem);
+void galois::substrate::internal::largeFreer::operator()(void* ptr) const {
+  if (numThreads)
+    memAccountSpread(category, -int64_t(bytes), numThreads);
+  else
+    memAccount(category, -int64_t(bytes), node);
+  largeFree(ptr, bytes);
 }
 
 LAptr galois::substrate::largeMallocInterleaved(size_t bytes,
                                                 unsigned numThreads) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
+  // round up to page size
+  bytes = allocSizeFor(bytes);
 
 #ifdef GALOIS_USE_NUMA
   // We don't use numa_alloc_interleaved_subset because we really want huge
@@ -166,34 +173,32 @@ LAptr galois::substrate::largeMallocInterleaved(size_t bytes,
     // true = round robin paging
     pageIn(data, bytes, allocSize(), numThreads, true);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, accounted(bytes, numThreads)};
 }
 
 LAptr galois::substrate::largeMallocLocal(size_t bytes) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
+  // round up to page size
+  bytes = allocSizeFor(bytes);
   // Get a prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), true),
-               internal::largeFreer{bytes}};
+  return LAptr{allocPages(bytes / allocSize(), true), accounted(bytes, 0)};
 }
 
 LAptr galois::substrate::largeMallocFloating(size_t bytes) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
+  // round up to page size
+  bytes = allocSizeFor(bytes);
   // Get a non-prefaulted allocation
-  return LAptr{allocPages(bytes / allocSize(), false),
-               internal::largeFreer{bytes}};
+  return LAptr{allocPages(bytes / allocSize(), false), accounted(bytes, 0)};
 }
 
 LAptr galois::substrate::largeMallocBlocked(size_t bytes, unsigned numThreads) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
+  // round up to page size
+  bytes = allocSizeFor(bytes);
   // Get a non-prefaulted allocation
   void* data = allocPages(bytes / allocSize(), false);
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, accounted(bytes, numThreads)};
 }
 
 /**
@@ -214,7 +219,7 @@ LAptr galois::substrate::largeMallocSpecified(size_t bytes, uint32_t numThreads,
                                               RangeArrayTy& threadRanges,
                                               size_t elementSize) {
   // ceiling to nearest page
-  bytes = roundup(bytes, allocSize());
+  bytes = allocSizeFor(bytes);
 
   void* data = allocPages(bytes / allocSize(), false);
 
@@ -223,7 +228,7 @@ LAptr galois::substrate::largeMallocSpecified(size_t bytes, uint32_t numThreads,
     pageInSpecified(data, bytes, allocSize(), numThreads, threadRanges,
                     elementSize);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, accounted(bytes, numThreads)};
 }
 // Explicit template declarations since the template is defined in the .h
 // file
@@ -107,10 +107,12 @@ static void readHeader(int fd, uint64_t& numNodes, uint64_t& numEdges) {
     GALOIS_SYS_DIE("failed reading ", fd);
   }
 
-  uint64_t* ptr = reinterpret_cast<uint64_t*>(m);
-  assert(ptr[0] == 1);
-  numNodes = ptr[2];
-  numEdges = ptr[3];
+  uint64_t* ptr    = reinterpret_cast<uint64_t*>(m);
+  uint64_t version = ptr[0];
+  numNodes         = ptr[2];
+  numEdges         = ptr[3];
+  if (version != 1)
+    GALOIS_DIE("unsupported file version: ", version);
 
   if (munmap(m, 4 * sizeof(uint64_t))) {
     GALOIS_SYS_DIE("failed reading ", fd);
@@ -18,13 +18,19 @@
  */
 
 #include "galois/substrate/PageAlloc.h"
+#include "galois/substrate/EnvCheck.h"
 #include "galois/substrate/SimpleLock.h"
 #include "galois/gIO.h"
 
+#include <algorithm>
+#include <fstream>
 #include <mutex>
+#include <sstream>
+#include <string>
 
 // figure this out dynamically
 const size_t hugePageSize = 2 * 1024 * 1024;
+const size_t gigaPageSize = 1024 * 1024 * 1024;
 // protect mmap, munmap since linux has issues
 static galois::substrate::SimpleLock allocLock;
 
@@ -52,23 +58,106 @@ static const int _MAP_HUGE     = MAP_HUGETLB | _MAP;
 static const int _MAP_HUGE_POP = _MAP_POP;
 static const int _MAP_HUGE     = _MAP;
 #endif
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+static const int _MAP_GIGA_POP = MAP_HUGE_1GB | _MAP_HUGE_POP;
+static const int _MAP_GIGA     = MAP_HUGE_1GB | _MAP_HUGE;
+static const bool haveGiga     = true;
+#else
+static const int _MAP_GIGA_POP = _MAP_HUGE_POP;
+static const int _MAP_GIGA     = _MAP_HUGE;
+static const bool haveGiga     = false;
+#endif
+
+namespace {
+//! Page sizes to try, from GALOIS_HUGE_PAGES
+enum HugePageMode {
+  //! Base pages only
+  NoHuge = 0,
+  //! 2MB hugetlbfs pages, else transparent huge pages
+  Huge = 1,
+  //! Also 1GB hugetlbfs pages for allocations of at least GigaMinAlloc
+  Giga = 2
+};
+} // namespace
+
+// Smallest allocation rounded up to 1GB pages; caps the waste at 1/8
+static const size_t GigaMinAlloc = 8 * gigaPageSize;
+
+static HugePageMode hugePageMode() {
+  static HugePageMode mode = [] {
+    int m = Huge;
+    galois::substrate::EnvCheck("GALOIS_HUGE_PAGES", m);
+    return HugePageMode(std::min(std::max(m, int(NoHuge)), int(Giga)));
+  }();
+  return mode;
+}
+
+// Map bytes of base pages aligned to hugePageSize, so transparent huge pages
+// can back all of them
+static void* trymmapAligned(size_t bytes) {
+  char* ptr = static_cast<char*>(trymmap(bytes + hugePageSize, _MAP));
+  if (!ptr)
+    return nullptr;
+  std::lock_guard<galois::substrate::SimpleLock> lg(allocLock);
+  size_t misalign = reinterpret_cast<uintptr_t>(ptr) % hugePageSize;
+  size_t head     = misalign ? hugePageSize - misalign : 0;
+  if (head)
+    munmap(ptr, head);
+  if (hugePageSize - head)
+    munmap(ptr + head + bytes, hugePageSize - head);
+  return ptr + head;
+}
 
 size_t galois::substrate::allocSize() { return hugePageSize; }
 
+size_t galois::substrate::allocSizeFor(size_t bytes) {
+  size_t mult = hugePageSize;
+  if (haveGiga && hugePageMode() >= Giga && bytes >= GigaMinAlloc)
+    mult = gigaPageSize;
+  size_t rem = bytes % mult;
+  return rem ? bytes + (mult - rem) : bytes;
+}
+
+void galois::substrate::adviseHugePages(void* ptr, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+  if (hugePageMode() >= Huge && madvise(ptr, bytes, MADV_HUGEPAGE) != 0)
+    gDebug("madvise(MADV_HUGEPAGE) failed");
+#endif
+}
+
 void* galois::substrate::allocPages(unsigned num, bool preFault) {
   if (num > 0) {
-    void* ptr =
-        trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
-    if (!ptr) {
-      gDebug("Huge page alloc failed, falling back");
-      ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+    size_t bytes = num * hugePageSize;
+    void* ptr         = nullptr;
+    HugePageMode mode = hugePageMode();
+
+    if (haveGiga && mode >= Giga && bytes % gigaPageSize == 0) {
+      ptr = trymmap(bytes, preFault ? _MAP_GIGA_POP : _MAP_GIGA);
+      if (!ptr)
+        gDebug("1GB page alloc failed, falling back");
+    }
+    if (!ptr && mode >= Huge) {
+      ptr = trymmap(bytes, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+      if (!ptr)
+        gDebug("Huge page alloc failed, falling back");
+    }
+
+    bool handMap = doHandMap;
+    if (!ptr && mode >= Huge) {
+      // Fault in only after the advice so transparent huge pages are used
+      ptr = trymmapAligned(bytes);
+      if (ptr)
+        adviseHugePages(ptr, bytes);
+      handMap = true;
+    } else if (!ptr) {
+      ptr = trymmap(bytes, preFault ? _MAP_POP : _MAP);
     }
 
     if (!ptr)
       GALOIS_SYS_DIE("Out of Memory");
 
-    if (preFault && doHandMap)
-      for (size_t x = 0; x < num * hugePageSize; x += 4096)
+    if (preFault && handMap)
+      for (size_t x = 0; x < bytes; x += 4096)
         static_cast<char*>(ptr)[x] = 0;
 
     return ptr;
@@ -83,6 +172,86 @@ void galois::substrate::freePages(void* ptr, unsigned num) {
     GALOIS_SYS_DIE("Unmap failed");
 }
 
+galois::substrate::HugePageMap::HugePageMap() {
+  std::ifstream f("/proc/self/smaps");
+  std::string line;
+  while (std::getline(f, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    ss >> key;
+    if (key.empty())
+      continue;
+
+    if (key.back() != ':') {
+      // Header of a new mapping: "begin-end perms offset dev inode path"
+      size_t dash = key.find('-');
+      if (dash != std::string::npos)
+        mappings.push_back({std::stoul(key.substr(0, dash), nullptr, 16),
+                            std::stoul(key.substr(dash + 1), nullptr, 16),
+                            4096, 0});
+      continue;
+    }
+    if (mappings.empty())
+      continue;
+
+    size_t kb = 0;
+    ss >> kb;
+    Mapping& m = mappings.back();
+    if (key == "KernelPageSize:")
+      m.pageSize = kb * 1024;
+    else if (key == "AnonHugePages:" || key == "FilePmdMapped:" ||
+             key == "ShmemPmdMapped:")
+      m.hugeBytes += kb * 1024;
+  }
+}
+
+//! Calls fn(mapping, overlap) for each mapping overlapping [ptr, ptr + bytes)
+template <typename Mappings, typename Fn>
+static void forOverlaps(const Mappings& mappings, const void* ptr,
+                        size_t bytes, Fn fn) {
+  uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+  uintptr_t end   = begin + bytes;
+  for (const auto& m : mappings) {
+    uintptr_t b = std::max(begin, m.begin);
+    uintptr_t e = std::min(end, m.end);
+    if (b < e)
+      fn(m, e - b);
+  }
+}
+
+template <typename Mapping>
+static size_t proratedHugeBytes(const Mapping& m, size_t overlap) {
+  if (m.pageSize >= hugePageSize)
+    return overlap;
+  return static_cast<size_t>(double(m.hugeBytes) * overlap /
+                             (m.end - m.begin));
+}
+
+size_t galois::substrate::HugePageMap::hugeBytes(const void* ptr,
+                                                 size_t bytes) const {
+  size_t ret = 0;
+  forOverlaps(mappings, ptr, bytes, [&](const Mapping& m, size_t overlap) {
+    ret += proratedHugeBytes(m, overlap);
+  });
+  return ret;
+}
+
+size_t galois::substrate::HugePageMap::count(const void* ptr,
+                                             size_t bytes) const {
+  size_t ret = 0;
+  forOverlaps(mappings, ptr, bytes, [&](const Mapping& m, size_t overlap) {
+    if (m.pageSize >= hugePageSize)
+      ret += (overlap + m.pageSize - 1) / m.pageSize;
+    else
+      ret += proratedHugeBytes(m, overlap) / hugePageSize;
+  });
+  return ret;
+}
+
+size_t galois::substrate::numHugePages(const void* ptr, size_t bytes) {
+  return HugePageMap().count(ptr, bytes);
+}
+
 /*
 
 class PageSizeConf {
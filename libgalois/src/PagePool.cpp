@@ -38,6 +38,10 @@ int galois::runtime::numPagePoolAllocForThread(unsigned tid) {
   return PA->count(tid);
 }
 
+int galois::runtime::numPagePoolHugePagesForThread(unsigned tid) {
+  return PA->countHuge(tid);
+}
+
 void* galois::runtime::pagePoolAlloc() { return PA->pageAlloc(); }
 
 void galois::runtime::pagePoolPreAlloc(unsigned num) {
@@ -0,0 +1,281 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/SetIntersection.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GALOIS_INTERSECT_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+//! Counts common elements
+struct CountSink {
+  size_t n = 0;
+
+  void one(size_t, size_t) { ++n; }
+
+  void block(uint32_t mask, size_t, size_t, const uint32_t*,
+             const uint32_t*) {
+    n += __builtin_popcount(mask);
+  }
+};
+
+//! Records the positions of common elements
+struct PositionSink {
+  uint32_t* posA;
+  uint32_t* posB;
+  size_t n = 0;
+
+  PositionSink(uint32_t* a, uint32_t* b) : posA(a), posB(b) {}
+
+  void one(size_t i, size_t j) {
+    posA[n] = i;
+    posB[n] = j;
+    ++n;
+  }
+
+  //! Bit l of mask is set if a[i + l] occurs in the block of b at j
+  void block(uint32_t mask, size_t i, size_t j, const uint32_t* a,
+             const uint32_t* b) {
+    while (mask) {
+      unsigned l = __builtin_ctz(mask);
+      mask &= mask - 1;
+      size_t k = j;
+      while (b[k] != a[i + l])
+        ++k;
+      one(i + l, k);
+    }
+  }
+};
+
+template <typename Sink>
+void mergeKernel(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                 size_t i, size_t j, Sink& sink) {
+  while (i < na && j < nb) {
+    uint32_t x = a[i];
+    uint32_t y = b[j];
+    if (x == y)
+      sink.one(i, j);
+    i += x <= y;
+    j += y <= x;
+  }
+}
+
+/**
+ * Looks up each element of the short list s in the long list l, searching
+ * forward from the previous hit with exponentially growing steps.
+ */
+template <typename Sink>
+void gallopingKernel(const uint32_t* s, size_t ns, const uint32_t* l,
+                     size_t nl, bool swapped, Sink& sink) {
+  size_t lo = 0;
+  for (size_t i = 0; i < ns && lo < nl; ++i) {
+    uint32_t x  = s[i];
+    size_t hi   = lo;
+    size_t step = 1;
+    while (hi < nl && l[hi] < x) {
+      lo = hi + 1;
+      hi += step;
+      step *= 2;
+    }
+    lo = std::lower_bound(l + lo, l + std::min(hi + 1, nl), x) - l;
+    if (lo < nl && l[lo] == x) {
+      if (swapped)
+        sink.one(lo, i);
+      else
+        sink.one(i, lo);
+      ++lo;
+    }
+  }
+}
+
+#ifdef GALOIS_INTERSECT_X86
+
+struct CpuFeatures {
+  bool avx2;
+  bool avx512;
+
+  CpuFeatures() {
+    __builtin_cpu_init();
+    avx2   = __builtin_cpu_supports("avx2");
+    avx512 = __builtin_cpu_supports("avx512f");
+  }
+};
+
+const CpuFeatures& cpuFeatures() {
+  static CpuFeatures features;
+  return features;
+}
+
+/**
+ * Compares a block of 8 elements of a with a block of 8 elements of b by
+ * rotating the b block through all 8 lanes, then advances the block(s) with
+ * the smaller last element. Matches cannot span blocks that were skipped
+ * because both lists are strictly increasing.
+ */
+template <typename Sink>
+__attribute__((target("avx2"))) void
+avx2Kernel(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+           Sink& sink) {
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  size_t i = 0;
+  size_t j = 0;
+  while (i + 8 <= na && j + 8 <= nb) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+    uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+    if (mask)
+      sink.block(mask, i, j, a, b);
+    uint32_t lastA = a[i + 7];
+    uint32_t lastB = b[j + 7];
+    i += lastA <= lastB ? 8 : 0;
+    j += lastB <= lastA ? 8 : 0;
+  }
+  mergeKernel(a, na, b, nb, i, j, sink);
+}
+
+//! avx2Kernel with blocks of 16
+template <typename Sink>
+__attribute__((target("avx512f"))) void
+avx512Kernel(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+             Sink& sink) {
+  size_t i = 0;
+  size_t j = 0;
+  while (i + 16 <= na && j + 16 <= nb) {
+    __m512i va    = _mm512_loadu_si512(a + i);
+    __m512i vb    = _mm512_loadu_si512(b + j);
+    __mmask16 eq  = _mm512_cmpeq_epi32_mask(va, vb);
+    for (int r = 1; r < 16; ++r) {
+      // Rotate b by one lane. The zero-masking form with a full mask avoids
+      // the uninitialized passthrough of the unmasked intrinsic in GCC.
+      vb = _mm512_maskz_alignr_epi32(0xFFFF, vb, vb, 1);
+      eq = _mm512_kor(eq, _mm512_cmpeq_epi32_mask(va, vb));
+    }
+    if (eq)
+      sink.block(eq, i, j, a, b);
+    uint32_t lastA = a[i + 15];
+    uint32_t lastB = b[j + 15];
+    i += lastA <= lastB ? 16 : 0;
+    j += lastB <= lastA ? 16 : 0;
+  }
+  mergeKernel(a, na, b, nb, i, j, sink);
+}
+
+#endif
+
+template <typename Sink>
+void intersect(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+               galois::IntersectKernel k, Sink& sink) {
+  using galois::IntersectKernel;
+  if (k == IntersectKernel::Auto)
+    k = galois::selectIntersectKernel(na, nb);
+  else if (!galois::intersectKernelSupported(k))
+    GALOIS_DIE("unsupported intersection kernel ",
+               galois::intersectKernelName(k));
+
+  switch (k) {
+  case IntersectKernel::Galloping:
+    if (na <= nb)
+      gallopingKernel(a, na, b, nb, false, sink);
+    else
+      gallopingKernel(b, nb, a, na, true, sink);
+    return;
+#ifdef GALOIS_INTERSECT_X86
+  case IntersectKernel::AVX2:
+    avx2Kernel(a, na, b, nb, sink);
+    return;
+  case IntersectKernel::AVX512:
+    avx512Kernel(a, na, b, nb, sink);
+    return;
+#endif
+  default:
+    mergeKernel(a, na, b, nb, 0, 0, sink);
+    return;
+  }
+}
+
+} // namespace
+
+bool galois::intersectKernelSupported(IntersectKernel k) {
+  switch (k) {
+#ifdef GALOIS_INTERSECT_X86
+  case IntersectKernel::AVX2:
+    return cpuFeatures().avx2;
+  case IntersectKernel::AVX512:
+    return cpuFeatures().avx512;
+#else
+  case IntersectKernel::AVX2:
+  case IntersectKernel::AVX512:
+    return false;
+#endif
+  default:
+    return true;
+  }
+}
+
+galois::IntersectKernel galois::selectIntersectKernel(size_t na, size_t nb) {
+  size_t small = std::min(na, nb);
+  size_t large = std::max(na, nb);
+  if (small && large / small >= INTERSECT_GALLOPING_RATIO)
+    return IntersectKernel::Galloping;
+  if (small >= 8 && intersectKernelSupported(IntersectKernel::AVX2))
+    return IntersectKernel::AVX2;
+  return IntersectKernel::Merge;
+}
+
+const char* galois::intersectKernelName(IntersectKernel k) {
+  switch (k) {
+  case IntersectKernel::Auto:
+    return "auto";
+  case IntersectKernel::Merge:
+    return "merge";
+  case IntersectKernel::Galloping:
+    return "galloping";
+  case IntersectKernel::AVX2:
+    return "avx2";
+  case IntersectKernel::AVX512:
+    return "avx512";
+  }
+  return "unknown";
+}
+
+size_t galois::intersectCount(const uint32_t* a, size_t na, const uint32_t* b,
+                              size_t nb, IntersectKernel k) {
+  CountSink sink;
+  intersect(a, na, b, nb, k, sink);
+  return sink.n;
+}
+
+size_t galois::intersectPositions(const uint32_t* a, size_t na,
+                                  const uint32_t* b, size_t nb, uint32_t* posA,
+                                  uint32_t* posB, IntersectKernel k) {
+  PositionSink sink(posA, posB);
+  intersect(a, na, b, nb, k, sink);
+  return sink.n;
+}
@@ -19,10 +19,29 @@
 
 #include "galois/substrate/SharedMem.h"
 #include "galois/substrate/Barrier.h"
+#include "galois/substrate/EnvCheck.h"
 #include "galois/substrate/ThreadPool.h"
 #include "galois/substrate/Termination.h"
+#include "galois/gIO.h"
 
 #include <memory>
+#include <string>
+
+static std::unique_ptr<galois::substrate::TerminationDetection>
+makeTermination() {
+  using namespace galois::substrate::internal;
+
+  std::string kind = "ring";
+  galois::substrate::EnvCheck("GALOIS_TERMINATION", kind);
+
+  if (kind == "tree")
+    return std::make_unique<TreeTerminationDetection<>>();
+  if (kind == "hierarchical")
+    return std::make_unique<HierarchicalTerminationDetection<>>();
+  if (kind != "ring")
+    galois::gWarn("unknown GALOIS_TERMINATION ", kind, ", using ring");
+  return std::make_unique<LocalTerminationDetection<>>();
+}
 
 galois::substrate::SharedMem::SharedMem() {
   internal::setThreadPool(&m_tpool);
@@ -30,7 +49,7 @@ galois::substrate::SharedMem::SharedMem() {
   // delayed initialization because both call getThreadPool in constructor
   // which is valid only after setThreadPool() above
   m_biPtr   = std::make_unique<internal::BarrierInstance<>>();
-  m_termPtr = std::make_unique<internal::LocalTerminationDetection<>>();
+  m_termPtr = makeTermination();
 
   internal::setBarrierInstance(m_biPtr.get());
   internal::setTermDetect(m_termPtr.get());
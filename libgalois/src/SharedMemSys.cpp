@@ -18,7 +18,12 @@
  */
 
 #include "galois/SharedMemSys.h"
+#include "galois/substrate/ThreadPool.h"
 
 galois::SharedMemSys::SharedMemSys() = default;
 
+galois::SharedMemSys::SharedMemSys(std::chrono::microseconds idleSpin) {
+  substrate::getThreadPool().setIdleSpin(idleSpin);
+}
+
 galois::SharedMemSys::~SharedMemSys() = default;
@@ -19,6 +19,7 @@
 
 #include "galois/runtime/Statistics.h"
 #include "galois/runtime/Executor_OnEach.h"
+#include "galois/substrate/MemAccounting.h"
 
 #include <iostream>
 #include <fstream>
@@ -129,10 +130,32 @@ void galois::runtime::reportPageAlloc(const char* category) {
   galois::runtime::on_each_gen(
       [category](const unsigned int tid, const unsigned int) {
         reportStat_Tsum("PageAlloc", category, numPagePoolAllocForThread(tid));
+        reportStat_Tsum("PageAllocHuge", category,
+                        numPagePoolHugePagesForThread(tid));
       },
       std::make_tuple());
 }
 
+void galois::runtime::reportMemAccounting(const char* region) {
+  using namespace galois::substrate;
+  unsigned nodes = getThreadPool().getMaxNumaNodes();
+  for (unsigned c = 0; c < unsigned(MemCategory::NumCategories); ++c) {
+    MemCategory cat = MemCategory(c);
+    MemUsage total  = getMemUsage(cat);
+    if (!total.peak)
+      continue;
+    std::string name = getMemCategoryName(cat);
+    reportStat_Single(region, name + "LiveBytes", total.live);
+    reportStat_Single(region, name + "PeakBytes", total.peak);
+    for (unsigned n = 0; n < nodes && n <= MEM_ACCOUNTING_MAX_NODE; ++n) {
+      MemUsage usage     = getMemUsage(cat, n);
+      std::string suffix = "_Node" + std::to_string(n);
+      reportStat_Single(region, name + "LiveBytes" + suffix, usage.live);
+      reportStat_Single(region, name + "PeakBytes" + suffix, usage.peak);
+    }
+  }
+}
+
 void galois::runtime::reportNumaAlloc(const char*) {
   galois::gWarn("reportNumaAlloc NOT IMPLEMENTED YET. TBD");
   int nodes = substrate::getThreadPool().getMaxNumaNodes();
@@ -39,7 +39,8 @@ thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
     : mi(getHWTopo().machineTopoInfo), reserved(0), masterFastmode(false),
-      running(false) {
+      running(false),
+      idleSpin(std::chrono::nanoseconds(DefaultIdleSpin).count()) {
   signals.resize(mi.maxThreads);
   initThread(0);
 
@@ -134,7 +135,7 @@ void ThreadPool::threadLoop(unsigned tid) {
   bool fastmode = false;
   auto& me      = my_box;
   do {
-    me.wait(fastmode);
+    me.wait(fastmode, getIdleSpin());
     cascade(fastmode);
     try {
       work();
@@ -0,0 +1,82 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file TestGraphs.h
+ *
+ * Random graphs shared by the graph unit tests. Adjacency lists are built in
+ * memory so tests can check a graph against them, and then written to a
+ * FileGraphWriter from which any graph type can be read.
+ */
+
+#ifndef GALOIS_TEST_TESTGRAPHS_H
+#define GALOIS_TEST_TESTGRAPHS_H
+
+#include "galois/graphs/FileGraph.h"
+
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//! Out edges of every node as (destination, data) pairs
+using TestAdjacency = std::vector<std::vector<std::pair<uint32_t, int>>>;
+
+/**
+ * Random graph where each node has fewer than maxDegree out edges to random
+ * destinations with random data; destinations are unsorted and may repeat.
+ */
+inline TestAdjacency randomAdjacency(size_t numNodes, unsigned maxDegree,
+                                     std::mt19937& gen) {
+  TestAdjacency adj(numNodes);
+  for (auto& edges : adj)
+    for (unsigned i = gen() % maxDegree; i > 0; --i)
+      edges.emplace_back(gen() % numNodes, int(gen()));
+  return adj;
+}
+
+/**
+ * Writes adjacency lists into w. For EdgeTy void, adj[n] holds destinations;
+ * otherwise it holds (destination, data) pairs in any container.
+ */
+template <typename EdgeTy, typename Adjacency>
+void writeAdjacency(galois::graphs::FileGraphWriter& w, const Adjacency& adj) {
+  uint64_t numEdges = 0;
+  for (auto& edges : adj)
+    numEdges += edges.size();
+
+  w.setNumNodes(adj.size());
+  w.setNumEdges<EdgeTy>(numEdges);
+  w.phase1();
+  for (size_t n = 0; n < adj.size(); ++n)
+    w.incrementDegree(n, adj[n].size());
+  w.phase2();
+  for (size_t n = 0; n < adj.size(); ++n) {
+    for (auto& e : adj[n]) {
+      if constexpr (std::is_void<EdgeTy>::value)
+        w.addNeighbor(n, e);
+      else
+        w.addNeighbor<EdgeTy>(n, e.first, e.second);
+    }
+  }
+  w.finish<EdgeTy>();
+}
+
+#endif
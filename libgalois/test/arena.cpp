@@ -0,0 +1,87 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+
+#include <cstring>
+#include <vector>
+
+//! Allocations survive until clear, and pages are reused afterwards
+void testArenaHeap() {
+  galois::PerLoopAllocBaseTy heap;
+  int before = galois::runtime::numPagePoolAllocTotal();
+
+  for (int round = 0; round < 4; ++round) {
+    galois::on_each([&](unsigned tid, unsigned) {
+      std::vector<unsigned*> ptrs;
+      for (unsigned i = 0; i < 10000; ++i) {
+        unsigned* p = static_cast<unsigned*>(heap.allocate(sizeof(unsigned)));
+        *p          = tid + i;
+        ptrs.push_back(p);
+      }
+      // Larger than a page, so comes from malloc
+      void* big = heap.allocate(4 * galois::runtime::pagePoolSize());
+      std::memset(big, 0, 4 * galois::runtime::pagePoolSize());
+      for (unsigned i = 0; i < ptrs.size(); ++i)
+        GALOIS_ASSERT(*ptrs[i] == tid + i);
+    });
+    heap.clear();
+  }
+
+  // Every round after the first reuses the pages released by clear
+  int pages = galois::runtime::numPagePoolAllocTotal() - before;
+  GALOIS_ASSERT(pages <= 2 * int(galois::getActiveThreads()));
+}
+
+//! Operators build temporary vectors without freeing them
+void testForEach() {
+  using IntAlloc = galois::PerLoopAllocTy::rebind<int>::other;
+  galois::GAccumulator<size_t> sum;
+  std::vector<int> items(1000);
+  for (int i = 0; i < 1000; ++i)
+    items[i] = i;
+
+  galois::for_each(
+      galois::iterate(items),
+      [&](int n, auto& ctx) {
+        std::vector<int, IntAlloc> v(ctx.getPerLoopAlloc());
+        for (int i = 0; i <= n; ++i)
+          v.push_back(i);
+        for (int x : v)
+          sum += x;
+      },
+      galois::per_loop_alloc(), galois::loopname("arena"));
+
+  size_t expected = 0;
+  for (size_t n = 0; n < 1000; ++n)
+    expected += n * (n + 1) / 2;
+  GALOIS_ASSERT(sum.reduce() == expected);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      std::max(galois::substrate::getThreadPool().getMaxThreads(), 2U));
+
+  testArenaHeap();
+  testForEach();
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/worklists/ChaseLev.h"
+
+#include <vector>
+
+//! The owner takes from the bottom and thieves steal from the top
+void testDeque() {
+  galois::worklists::internal::ChaseLevDeque<int> deque;
+  GALOIS_ASSERT(!deque.take() && !deque.steal());
+
+  // Enough items to grow the initial buffer a few times
+  for (int i = 0; i < 5000; ++i)
+    deque.push(i);
+  GALOIS_ASSERT(*deque.steal() == 0);
+  GALOIS_ASSERT(*deque.take() == 4999);
+  for (int i = 1; i < 4999; ++i)
+    GALOIS_ASSERT(*deque.steal() == i);
+  GALOIS_ASSERT(deque.empty() && !deque.take() && !deque.steal());
+}
+
+//! Binary tree of the given depth expanded depth first
+void testForEach(int depth) {
+  galois::GAccumulator<size_t> visited;
+  std::vector<int> roots(16, depth);
+
+  galois::for_each(
+      galois::iterate(roots),
+      [&](int d, auto& ctx) {
+        visited += 1;
+        if (d > 0) {
+          ctx.push(d - 1);
+          ctx.push(d - 1);
+        }
+      },
+      galois::wl<galois::worklists::ChaseLev<>>(),
+      galois::disable_conflict_detection(), galois::loopname("tree"));
+
+  GALOIS_ASSERT(visited.reduce() == roots.size() * ((2u << depth) - 1));
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      std::max(galois::substrate::getThreadPool().getMaxThreads(), 2U));
+
+  testDeque();
+  testForEach(14);
+
+  return 0;
+}
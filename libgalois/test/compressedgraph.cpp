@@ -0,0 +1,118 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "TestGraphs.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+using Graph = galois::graphs::LC_Compressed_Graph<unsigned, int>;
+using Adjacency = TestAdjacency;
+
+//! Random graph with unsorted, duplicate and self edges and one hub node
+void makeGraph(galois::graphs::FileGraphWriter& w, Adjacency& adj) {
+  const uint32_t numNodes = 1000;
+  std::mt19937 gen(0);
+  adj.resize(numNodes);
+  for (uint32_t src = 0; src < numNodes; ++src) {
+    uint32_t degree = (src == 7) ? 5 * numNodes : gen() % 20;
+    for (uint32_t i = 0; i < degree; ++i)
+      adj[src].emplace_back(gen() % numNodes, int(gen() % 100));
+  }
+  adj[3].emplace_back(3, 1);
+  adj[3].emplace_back(0, 2);
+  writeAdjacency<int>(w, adj);
+
+  for (auto& edges : adj)
+    std::sort(edges.begin(), edges.end(), [](auto& a, auto& b) {
+      return a.first < b.first;
+    });
+}
+
+void checkGraph(Graph& g, const Adjacency& adj) {
+  GALOIS_ASSERT(g.size() == adj.size());
+  uint64_t numEdges = 0;
+  for (uint32_t src = 0; src < adj.size(); ++src) {
+    GALOIS_ASSERT(g.getDegree(src) == adj[src].size());
+
+    // Edges with the same destination may appear in either order, so only
+    // check the multiset of weights for each destination
+    std::vector<std::pair<uint32_t, int>> edges;
+    for (auto e : g.edges(src))
+      edges.emplace_back(g.getEdgeDst(e), g.getEdgeData(e));
+    GALOIS_ASSERT(std::is_sorted(
+        edges.begin(), edges.end(),
+        [](auto& a, auto& b) { return a.first < b.first; }));
+    std::vector<std::pair<uint32_t, int>> expected = adj[src];
+    std::sort(edges.begin(), edges.end());
+    std::sort(expected.begin(), expected.end());
+    GALOIS_ASSERT(edges == expected);
+
+    // Decoding block by block gives the same sequence
+    std::vector<uint32_t> blocked;
+    for (uint64_t b = 0; b < g.numEdgeBlocks(src); ++b)
+      for (auto e : g.edgeBlock(src, b))
+        blocked.push_back(g.getEdgeDst(e));
+    GALOIS_ASSERT(blocked.size() == adj[src].size());
+    for (size_t i = 0; i < blocked.size(); ++i)
+      GALOIS_ASSERT(blocked[i] == adj[src][i].first);
+
+    for (auto& e : adj[src])
+      GALOIS_ASSERT(g.getEdgeDst(g.findEdge(src, e.first)) == e.first);
+    numEdges += edges.size();
+  }
+  GALOIS_ASSERT(g.sizeEdges() == numEdges);
+  GALOIS_ASSERT(g.sizeEdgeBytes() < numEdges * sizeof(uint32_t));
+  GALOIS_ASSERT(g.findEdge(0, adj.size()) == g.edge_end(0));
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  galois::graphs::FileGraphWriter w;
+  Adjacency adj;
+  makeGraph(w, adj);
+
+  Graph g;
+  galois::graphs::readGraph(g, w);
+  checkGraph(g, adj);
+
+  char path[] = "/tmp/compressedgraphXXXXXX";
+  int fd      = mkstemp(path);
+  GALOIS_ASSERT(fd >= 0);
+  close(fd);
+
+  g.toFile(path);
+  GALOIS_ASSERT(Graph::isCompressedFile(path));
+  Graph h;
+  galois::graphs::readGraph(h, std::string(path));
+  checkGraph(h, adj);
+  unlink(path);
+
+  return 0;
+}
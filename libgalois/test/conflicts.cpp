@@ -0,0 +1,112 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/runtime/Context.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//! The smoothed rate follows the per-window abort ratio
+void testAbortRate() {
+  galois::runtime::AbortRate rate;
+  for (int i = 0; i < 1024; ++i)
+    rate.commit();
+  GALOIS_ASSERT(rate.get() == 0 && !rate.throttle());
+
+  for (int i = 0; i < 1024; ++i)
+    rate.abort();
+  GALOIS_ASSERT(rate.get() >= galois::runtime::AbortRate::Throttle);
+  GALOIS_ASSERT(rate.throttle());
+  rate.report("rate");
+}
+
+struct Cell : public galois::runtime::Lockable {
+  size_t count = 0;
+};
+
+//! Every iteration writes the same few cells, so nearly all of them conflict
+void testHotCells(size_t numItems) {
+  std::vector<Cell> cells(4);
+
+  galois::for_each(
+      galois::iterate(size_t{0}, numItems),
+      [&](size_t i, auto&) {
+        Cell& a = cells[i % cells.size()];
+        Cell& b = cells[(i + 1) % cells.size()];
+        galois::runtime::acquire(&a, galois::MethodFlag::WRITE);
+        galois::runtime::acquire(&b, galois::MethodFlag::WRITE);
+        a.count += 1;
+        b.count += 1;
+      },
+      galois::loopname("hot"));
+
+  size_t total = 0;
+  for (auto& c : cells)
+    total += c.count;
+  GALOIS_ASSERT(total == 2 * numItems);
+}
+
+//! Every reported window leaves one trace line with its own ratio; the hot
+//! loop only tracks aborts when it runs on more than one thread
+void testAbortTrace(const char* file) {
+  std::ifstream in(file);
+  std::string line;
+  GALOIS_ASSERT(std::getline(in, line) && line.rfind("LOOP", 0) == 0);
+
+  std::vector<double> rateRatios;
+  size_t hotRows = 0;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string loop, field;
+    std::getline(fields, loop, ',');
+    for (int i = 0; i < 4; ++i)
+      std::getline(fields, field, ',');
+    double ratio = std::stod(field);
+    GALOIS_ASSERT(ratio >= 0 && ratio <= 1);
+    if (loop == "rate")
+      rateRatios.push_back(ratio);
+    else if (loop == "hot")
+      hotRows += 1;
+  }
+
+  // 1024 commits then 1024 aborts, in windows of 256
+  GALOIS_ASSERT(rateRatios.size() == 8);
+  GALOIS_ASSERT(rateRatios.front() == 0 && rateRatios.back() == 1);
+  GALOIS_ASSERT(hotRows > 0 || galois::getActiveThreads() == 1);
+}
+
+int main() {
+  // must be set before the runtime first looks for it
+  const char* traceFile = "conflicts-abort-trace.csv";
+  setenv("GALOIS_ABORT_TRACE", traceFile, 1);
+
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      std::max(galois::substrate::getThreadPool().getMaxThreads(), 2U));
+
+  testAbortRate();
+  testHotCells(100000);
+  testAbortTrace(traceFile);
+
+  return 0;
+}
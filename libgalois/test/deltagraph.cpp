@@ -0,0 +1,177 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/DeltaGraph.h"
+#include "galois/graphs/ReadGraph.h"
+#include "TestGraphs.h"
+
+#include <deque>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+using Graph    = galois::graphs::DeltaGraph<unsigned, int>;
+using Snapshot = Graph::Snapshot;
+using Model    = std::vector<std::map<uint32_t, int>>;
+
+const uint32_t numNodes = 1000;
+
+void makeGraph(galois::graphs::FileGraphWriter& w, Model& model) {
+  std::mt19937 gen(0);
+  model.resize(numNodes);
+  for (uint32_t src = 0; src < numNodes; ++src)
+    for (uint32_t i = gen() % 10; i > 0; --i)
+      model[src][gen() % numNodes] = gen() % 100;
+  writeAdjacency<int>(w, model);
+}
+
+void checkSnapshot(const Snapshot& s, const Model& model) {
+  GALOIS_ASSERT(s.size() == model.size());
+  uint64_t numEdges = 0;
+  for (uint32_t src = 0; src < model.size(); ++src) {
+    std::map<uint32_t, int> edges;
+    for (auto e : s.edges(src)) {
+      GALOIS_ASSERT(edges.count(s.getEdgeDst(e)) == 0);
+      edges[s.getEdgeDst(e)] = s.getEdgeData(e);
+    }
+    GALOIS_ASSERT(edges == model[src]);
+    GALOIS_ASSERT(s.getDegree(src) == model[src].size());
+    numEdges += edges.size();
+  }
+  GALOIS_ASSERT(s.sizeEdges() == numEdges);
+}
+
+//! Queues random updates from all threads; each thread owns some sources
+void randomUpdates(Graph& g, Model& model, unsigned seed) {
+  unsigned total = galois::getActiveThreads();
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> removed(total);
+  galois::on_each([&](unsigned tid, unsigned) {
+    std::mt19937 gen(seed + tid);
+    for (uint32_t src = tid; src < numNodes; src += total) {
+      for (uint32_t i = gen() % 4; i > 0; --i) {
+        uint32_t dst = gen() % numNodes;
+        g.insertEdge(src, dst, int(gen() % 100));
+      }
+      if (gen() % 3 == 0) {
+        uint32_t dst = gen() % numNodes;
+        g.removeEdge(src, dst);
+        removed[tid].emplace_back(src, dst);
+      }
+    }
+  });
+
+  // Replay the same sequences serially on the model
+  for (unsigned tid = 0; tid < total; ++tid) {
+    std::mt19937 gen(seed + tid);
+    for (uint32_t src = tid; src < numNodes; src += total) {
+      for (uint32_t i = gen() % 4; i > 0; --i) {
+        uint32_t dst    = gen() % numNodes;
+        model[src][dst] = gen() % 100;
+      }
+      if (gen() % 3 == 0)
+        model[src].erase(gen() % numNodes);
+    }
+  }
+}
+
+//! BFS levels from node 0 over a snapshot
+std::vector<uint32_t> bfs(const Snapshot& s) {
+  std::vector<uint32_t> level(s.size(), std::numeric_limits<uint32_t>::max());
+  std::deque<uint32_t> queue{0};
+  level[0] = 0;
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop_front();
+    for (auto e : s.edges(n)) {
+      uint32_t dst = s.getEdgeDst(e);
+      if (level[dst] == std::numeric_limits<uint32_t>::max()) {
+        level[dst] = level[n] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+  return level;
+}
+
+std::vector<uint32_t> bfs(const Model& model) {
+  std::vector<uint32_t> level(model.size(),
+                              std::numeric_limits<uint32_t>::max());
+  std::deque<uint32_t> queue{0};
+  level[0] = 0;
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop_front();
+    for (auto& e : model[n]) {
+      if (level[e.first] == std::numeric_limits<uint32_t>::max()) {
+        level[e.first] = level[n] + 1;
+        queue.push_back(e.first);
+      }
+    }
+  }
+  return level;
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  galois::graphs::FileGraphWriter w;
+  Model model0;
+  makeGraph(w, model0);
+
+  Graph g;
+  galois::graphs::readGraph(g, w);
+  g.setCompactionRatio(0);
+  Snapshot s0 = g.snapshot();
+  checkSnapshot(s0, model0);
+
+  // Updates are invisible until applied
+  Model model1 = model0;
+  randomUpdates(g, model1, 1);
+  checkSnapshot(g.snapshot(), model0);
+  GALOIS_ASSERT(g.applyUpdates() == 1);
+  Snapshot s1 = g.snapshot();
+  checkSnapshot(s0, model0);
+  checkSnapshot(s1, model1);
+  GALOIS_ASSERT(bfs(s1) == bfs(model1));
+
+  // Later batches and compaction leave older snapshots intact
+  Model model2 = model1;
+  randomUpdates(g, model2, 2);
+  g.applyUpdates();
+  g.compact();
+  GALOIS_ASSERT(g.sizeDelta() == 0);
+  Snapshot s2 = g.snapshot();
+  checkSnapshot(s0, model0);
+  checkSnapshot(s1, model1);
+  checkSnapshot(s2, model2);
+
+  // Applying enough updates compacts automatically
+  Model model3 = model2;
+  g.setCompactionRatio(0.1);
+  randomUpdates(g, model3, 3);
+  g.applyUpdates();
+  GALOIS_ASSERT(g.sizeDelta() == 0);
+  checkSnapshot(g.snapshot(), model3);
+  checkSnapshot(s2, model2);
+
+  return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/EdgeListReader.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/ReadGraph.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+using Edges = std::vector<std::tuple<uint64_t, uint64_t, int>>;
+
+void checkParseUnsigned() {
+  std::mt19937_64 gen(0);
+  for (int i = 0; i < 10000; ++i) {
+    uint64_t expected = gen() >> (gen() % 64);
+    std::string text  = std::to_string(expected) + (i % 2 ? " 7" : "");
+    const char* p     = text.data();
+    uint64_t value;
+    GALOIS_ASSERT(galois::graphs::internal::parseUnsigned(
+        p, text.data() + text.size(), value));
+    GALOIS_ASSERT(value == expected);
+    GALOIS_ASSERT(p == text.data() + std::to_string(expected).size());
+  }
+  const char* text = "x1";
+  uint64_t value;
+  GALOIS_ASSERT(
+      !galois::graphs::internal::parseUnsigned(text, text + 2, value));
+}
+
+//! Writes edges in random order with noise lines; returns them sorted
+Edges writeEdgeList(const std::string& path, bool csv) {
+  std::mt19937 gen(1);
+  Edges edges;
+  for (int i = 0; i < 20000; ++i)
+    edges.emplace_back(gen() % 3000, gen() % 3000, int(gen() % 2000) - 1000);
+  edges.emplace_back(123456, 0, 5);
+
+  std::ofstream out(path);
+  if (csv)
+    out << "src,dst,weight\n";
+  for (size_t i = 0; i < edges.size(); ++i) {
+    if (i % 1000 == 0)
+      out << "# comment\n\n";
+    if (i % 1500 == 0)
+      out << "garbage line\n";
+    auto& e = edges[i];
+    if (csv)
+      out << std::get<0>(e) << " , " << std::get<1>(e) << "," << std::get<2>(e);
+    else
+      out << "\t" << std::get<0>(e) << "  " << std::get<1>(e) << " "
+          << std::get<2>(e) << "\r";
+    if (i + 1 != edges.size())
+      out << "\n";
+  }
+  out.close();
+
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+template <typename Graph>
+void checkGraph(Graph& g, const Edges& expected) {
+  Edges edges;
+  for (auto n : g)
+    for (auto e : g.edges(n))
+      if constexpr (std::is_same<Graph, galois::graphs::FileGraph>::value)
+        edges.emplace_back(n, g.getEdgeDst(e), g.template getEdgeData<int>(e));
+      else
+        edges.emplace_back(n, g.getEdgeDst(e), g.getEdgeData(e));
+  GALOIS_ASSERT(g.size() == 123457);
+  GALOIS_ASSERT(edges == expected);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  checkParseUnsigned();
+
+  char dir[] = "/tmp/edgelistXXXXXX";
+  GALOIS_ASSERT(mkdtemp(dir));
+  std::string el  = std::string(dir) + "/graph.el";
+  std::string csv = std::string(dir) + "/graph.csv";
+  Edges expected  = writeEdgeList(el, false);
+  GALOIS_ASSERT(writeEdgeList(csv, true) == expected);
+
+  for (unsigned threads : {1, 2, 3}) {
+    galois::setActiveThreads(threads);
+
+    galois::graphs::FileGraphWriter w;
+    galois::graphs::readEdgeList<int>(w, el);
+    checkGraph<galois::graphs::FileGraph>(w, expected);
+
+    galois::graphs::FileGraphWriter c;
+    galois::graphs::readEdgeList<int>(c, csv, true, ',');
+    checkGraph<galois::graphs::FileGraph>(c, expected);
+
+    galois::graphs::LC_CSR_Graph<unsigned, int> g;
+    galois::graphs::readGraph(g, csv);
+    checkGraph(g, expected);
+  }
+
+  unlink(el.c_str());
+  unlink(csv.c_str());
+  rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+
+#include <atomic>
+#include <vector>
+
+using Graph = galois::graphs::LC_CSR_Graph<unsigned, void>;
+using GNode = Graph::GraphNode;
+
+//! Node 0 is a hub connected to every other node; the rest form a chain
+void makeHubGraph(Graph& g, uint32_t numNodes) {
+  uint64_t numEdges = 2 * (numNodes - 1) - 1;
+  g.allocateFrom(numNodes, numEdges);
+  g.constructNodes();
+
+  uint64_t e = 0;
+  for (uint32_t dst = 1; dst < numNodes; ++dst)
+    g.constructEdge(e++, dst);
+  g.fixEndEdge(0, e);
+  for (uint32_t src = 1; src < numNodes; ++src) {
+    if (src + 1 < numNodes)
+      g.constructEdge(e++, src + 1);
+    g.fixEndEdge(src, e);
+  }
+  GALOIS_ASSERT(e == numEdges);
+}
+
+template <typename... Args>
+void testDoAll(Graph& g, ptrdiff_t maxTile, Args&&... args) {
+  std::vector<std::atomic<size_t>> visited(g.size());
+  std::atomic<ptrdiff_t> largest(0);
+
+  galois::do_all_edges(
+      g, galois::iterate(g),
+      [&](GNode n, Graph::edge_iterator beg, Graph::edge_iterator end) {
+        ptrdiff_t sz = end - beg;
+        ptrdiff_t l  = largest;
+        while (sz > l && !largest.compare_exchange_weak(l, sz)) {
+        }
+        visited[n] += sz;
+      },
+      std::forward<Args>(args)...);
+
+  GALOIS_ASSERT(largest <= maxTile);
+  for (GNode n : g) {
+    size_t degree = std::distance(g.edge_begin(n), g.edge_end(n));
+    GALOIS_ASSERT(visited[n] == degree);
+  }
+}
+
+void testForEach(Graph& g) {
+  for (GNode n : g)
+    g.getData(n) = 0;
+
+  galois::GAccumulator<size_t> edges;
+  galois::for_each_edges(
+      g, galois::iterate({GNode{0}}),
+      [&](GNode, Graph::edge_iterator beg, Graph::edge_iterator end,
+          auto& ctx) {
+        GALOIS_ASSERT(end - beg <= 32);
+        for (auto ii = beg; ii != end; ++ii) {
+          edges += 1;
+          GNode dst = g.getEdgeDst(ii);
+          if (__sync_bool_compare_and_swap(&g.getData(dst), 0, 1))
+            ctx.push(dst);
+        }
+      },
+      galois::edge_tile<32>(), galois::disable_conflict_detection(),
+      galois::loopname("reach"));
+
+  GALOIS_ASSERT(edges.reduce() == g.sizeEdges());
+  for (GNode n = 1; n < g.size(); ++n)
+    GALOIS_ASSERT(g.getData(n) == 1);
+}
+
+static_assert(
+    std::tuple_size<decltype(galois::remove_traits<galois::steal_tag,
+                                                   galois::loopname_tag>(
+        std::make_tuple(galois::steal(), galois::chunk_size<8>(),
+                        galois::loopname("x"))))>::value == 1,
+    "remove_traits keeps only the other traits");
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      std::max(galois::substrate::getThreadPool().getMaxThreads(), 2U));
+
+  Graph g;
+  makeHubGraph(g, 5000);
+
+  testDoAll(g, 32, galois::edge_tile<32>(), galois::loopname("tiled"));
+  // The tile loop adds its own steal and chunk size on top of these
+  testDoAll(g, 32, galois::edge_tile<32>(), galois::steal(),
+            galois::chunk_size<8>(), galois::loopname("tiledSteal"));
+  testDoAll(g, 256, galois::edge_tile<>());
+  testDoAll(g, 256);
+  testForEach(g);
+
+  return 0;
+}
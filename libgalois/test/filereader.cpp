@@ -0,0 +1,140 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/FileReader.h"
+#include "galois/graphs/LCGraph.h"
+#include "TestGraphs.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+//! Writes a random graph spanning several read blocks with an odd number of
+//! edges, so the edge data follows padding
+void writeGraph(const std::string& path) {
+  std::mt19937 gen(0);
+  TestAdjacency adj = randomAdjacency(200000, 15, gen);
+  size_t numEdges   = 0;
+  for (auto& edges : adj)
+    numEdges += edges.size();
+  if (numEdges % 2 == 0)
+    adj[0].emplace_back(1, 1);
+
+  galois::graphs::FileGraphWriter w;
+  writeAdjacency<int>(w, adj);
+  w.toFile(path);
+}
+
+void checkReads(const std::string& path, const std::vector<char>& expected,
+                bool ioUring) {
+  galois::graphs::FileReader reader(path);
+  GALOIS_ASSERT(ioUring || !reader.usesIoUring());
+  GALOIS_ASSERT(reader.size() == expected.size());
+
+  std::vector<char> all(expected.size());
+  reader.read(all.data(), 0, all.size());
+  GALOIS_ASSERT(all == expected);
+
+  std::mt19937_64 gen(1);
+  for (int i = 0; i < 20; ++i) {
+    uint64_t offset = gen() % expected.size();
+    uint64_t len    = gen() % (expected.size() - offset + 1);
+    std::vector<char> part(len);
+    reader.read(part.data(), offset, len);
+    GALOIS_ASSERT(std::equal(part.begin(), part.end(),
+                             expected.begin() + offset));
+  }
+}
+
+template <typename EdgeTy, typename Graph>
+void checkGraph(galois::graphs::FileGraph& expected, Graph& g) {
+  GALOIS_ASSERT(g.size() == expected.size());
+  GALOIS_ASSERT(g.sizeEdges() == expected.sizeEdges());
+  for (auto n : expected) {
+    auto e  = expected.edge_begin(n);
+    auto ee = expected.edge_end(n);
+    auto a  = g.edge_begin(n);
+    GALOIS_ASSERT(std::distance(e, ee) == std::distance(a, g.edge_end(n)));
+    for (; e != ee; ++e, ++a) {
+      GALOIS_ASSERT(g.getEdgeDst(a) == expected.getEdgeDst(e));
+      if constexpr (!std::is_void<EdgeTy>::value) {
+        if constexpr (std::is_same<Graph, galois::graphs::FileGraph>::value)
+          GALOIS_ASSERT(g.template getEdgeData<EdgeTy>(a) ==
+                        expected.getEdgeData<EdgeTy>(e));
+        else
+          GALOIS_ASSERT(g.getEdgeData(a) == expected.getEdgeData<EdgeTy>(e));
+      }
+    }
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+
+  char dir[] = "/tmp/filereaderXXXXXX";
+  GALOIS_ASSERT(mkdtemp(dir));
+  std::string gr = std::string(dir) + "/graph.gr";
+  writeGraph(gr);
+
+  std::ifstream in(gr, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+  GALOIS_ASSERT(bytes.size() > 2 * galois::graphs::FileReader::blockSize);
+
+  galois::graphs::FileGraph expected;
+  expected.fromFile(gr);
+
+  for (bool ioUring : {true, false}) {
+    if (!ioUring)
+      setenv("GALOIS_DO_NOT_USE_IO_URING", "1", 1);
+    for (unsigned threads : {1, 3}) {
+      galois::setActiveThreads(threads);
+      checkReads(gr, bytes, ioUring);
+
+      galois::graphs::FileGraph f;
+      f.fromFileInterleaved<int>(gr);
+      checkGraph<int>(expected, f);
+
+      galois::graphs::FileGraph u;
+      u.fromFileInterleaved<void>(gr);
+      checkGraph<void>(expected, u);
+
+      galois::graphs::LC_CSR_Graph<unsigned, int> g;
+      g.readGraphFromGRFile(gr);
+      checkGraph<int>(expected, g);
+
+      galois::graphs::LC_CSR_Graph<unsigned, void> v;
+      v.readGraphFromGRFile(gr);
+      checkGraph<void>(expected, v);
+    }
+  }
+  unsetenv("GALOIS_DO_NOT_USE_IO_URING");
+
+  unlink(gr.c_str());
+  rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/Frontier.h"
+#include "galois/graphs/LC_CSR_CSC_Graph.h"
+#include "galois/graphs/ReadGraph.h"
+#include "TestGraphs.h"
+
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <random>
+#include <vector>
+
+using Graph  = galois::graphs::LC_CSR_CSC_Graph<void, void, false, true, true>;
+using GNode  = Graph::GraphNode;
+using Engine = galois::graphs::FrontierEngine<Graph>;
+using galois::graphs::Frontier;
+
+constexpr static const uint32_t INF = std::numeric_limits<uint32_t>::max();
+
+//! A few hubs with many out edges plus a long path, so that BFS both
+//! switches to pull and back to push
+void makeGraph(Graph& graph, size_t numNodes) {
+  std::mt19937 gen(0);
+  std::vector<std::vector<uint32_t>> adj(numNodes);
+  for (size_t n = 0; n + 1 < numNodes; ++n)
+    adj[n].push_back(n + 1);
+  for (size_t h = 0; h < 4; ++h)
+    for (size_t i = 0; i < numNodes / 4; ++i)
+      adj[h * 10].push_back(gen() % (numNodes / 2));
+  for (size_t i = 0; i < numNodes; ++i)
+    adj[gen() % (numNodes / 2)].push_back(gen() % (numNodes / 2));
+
+  galois::graphs::FileGraphWriter w;
+  writeAdjacency<void>(w, adj);
+
+  galois::graphs::readGraph(graph, w);
+  graph.constructIncomingEdges();
+}
+
+std::vector<uint32_t> serialBFS(Graph& graph, GNode source) {
+  std::vector<uint32_t> dist(graph.size(), INF);
+  std::deque<GNode> queue{source};
+  dist[source] = 0;
+  while (!queue.empty()) {
+    GNode n = queue.front();
+    queue.pop_front();
+    for (auto e : graph.edges(n)) {
+      GNode dst = graph.getEdgeDst(e);
+      if (dist[dst] == INF) {
+        dist[dst] = dist[n] + 1;
+        queue.push_back(dst);
+      }
+    }
+  }
+  return dist;
+}
+
+struct BFSOp {
+  std::vector<std::atomic<uint32_t>>& dist;
+  uint32_t level;
+
+  bool cond(GNode dst) const { return dist[dst] == INF; }
+
+  bool push(GNode, GNode dst) {
+    uint32_t old = INF;
+    return dist[dst].compare_exchange_strong(old, level);
+  }
+
+  bool pull(GNode, GNode dst) {
+    dist[dst] = level;
+    return true;
+  }
+};
+
+void checkBFS(Graph& graph, Engine::Direction d) {
+  std::vector<uint32_t> expected = serialBFS(graph, 0);
+  std::vector<std::atomic<uint32_t>> dist(graph.size());
+  for (auto& x : dist)
+    x = INF;
+  dist[0] = 0;
+
+  Engine engine(graph, true, 15, 18, d);
+  Frontier a(graph.size()), b(graph.size());
+  Frontier *cur = &a, *next = &b;
+  cur->push(0);
+  BFSOp op{dist, 0};
+  size_t pushes = 0;
+  size_t pulls  = 0;
+  while (!cur->empty()) {
+    ++op.level;
+    Engine::Direction used = engine.edgeMap(*cur, *next, op);
+    GALOIS_ASSERT(d == Engine::Auto || used == d);
+    GALOIS_ASSERT(next->isDense() == (used == Engine::Pull));
+    (used == Engine::Pull ? pulls : pushes) += 1;
+    std::swap(cur, next);
+  }
+  if (d == Engine::Auto)
+    GALOIS_ASSERT(pushes > 1 && pulls > 0);
+
+  for (size_t n = 0; n < graph.size(); ++n)
+    GALOIS_ASSERT(dist[n] == expected[n]);
+}
+
+void checkFrontier(size_t numNodes) {
+  Frontier f(numNodes);
+  GALOIS_ASSERT(f.empty() && !f.isDense());
+  galois::do_all(galois::iterate(size_t{0}, numNodes), [&](size_t n) {
+    if (n % 3 == 0)
+      f.push(n);
+    if (n % 6 == 0)
+      f.push(n);
+  });
+  GALOIS_ASSERT(f.size() == (numNodes + 2) / 3);
+
+  f.toDense();
+  GALOIS_ASSERT(f.isDense() && f.contains(3) && !f.contains(4));
+  f.toSparse();
+  std::atomic<size_t> seen(0);
+  f.forEach([&](uint32_t n) {
+    GALOIS_ASSERT(n % 3 == 0);
+    seen += 1;
+  });
+  GALOIS_ASSERT(seen == f.size());
+
+  f.clear(true);
+  GALOIS_ASSERT(f.empty() && f.isDense() && !f.contains(3));
+  f.fill();
+  GALOIS_ASSERT(f.size() == numNodes && f.contains(numNodes - 1));
+  f.clear(false);
+  GALOIS_ASSERT(f.empty() && !f.contains(numNodes - 1));
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+
+  Graph graph;
+  makeGraph(graph, 20000);
+
+  for (unsigned threads : {1, 3}) {
+    galois::setActiveThreads(threads);
+    checkFrontier(1000);
+    for (Engine::Direction d : {Engine::Auto, Engine::Push, Engine::Pull})
+      checkBFS(graph, d);
+  }
+
+  return 0;
+}
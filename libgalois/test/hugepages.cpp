@@ -0,0 +1,102 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/substrate/EnvCheck.h"
+#include "galois/substrate/PageAlloc.h"
+#include "TestGraphs.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+using namespace galois::substrate;
+
+//! True if allocPages should get transparent huge pages on this machine
+static bool expectHugePages() {
+  int mode = 1;
+  EnvCheck("GALOIS_HUGE_PAGES", mode);
+  std::ifstream f("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string enabled;
+  std::getline(f, enabled);
+  return mode > 0 && !enabled.empty() &&
+         enabled.find("[never]") == std::string::npos;
+}
+
+//! Loads a graph and checks that its huge pages end up in the stats file
+static void testGraphReport() {
+  std::string statFile =
+      "/tmp/galois-hugepages-" + std::to_string(getpid()) + ".csv";
+  {
+    galois::SharedMemSys Galois_runtime;
+    galois::runtime::setStatFile(statFile);
+
+    std::mt19937 gen(0);
+    galois::graphs::FileGraphWriter w;
+    writeAdjacency<int>(w, randomAdjacency(1000, 16, gen));
+    galois::graphs::LC_CSR_Graph<int, int> graph;
+    galois::graphs::readGraph(graph, w);
+  }
+
+  std::ifstream f(statFile);
+  std::stringstream stats;
+  stats << f.rdbuf();
+  std::remove(statFile.c_str());
+  for (const char* stat : {"NodeDataHugePages", "EdgeIndexHugePages",
+                           "EdgeDstHugePages", "EdgeDataHugePages"})
+    GALOIS_ASSERT(stats.str().find(stat) != std::string::npos, stat);
+}
+
+int main() {
+  testGraphReport();
+
+  galois::SharedMemSys Galois_runtime;
+
+  GALOIS_ASSERT(allocSizeFor(1) == allocSize());
+  GALOIS_ASSERT(allocSizeFor(allocSize()) == allocSize());
+
+  // Counts must be consistent with the allocation; whether they are nonzero
+  // depends on the machine
+  const size_t numPages = 16;
+  void* ptr             = allocPages(numPages, true);
+  GALOIS_ASSERT(ptr);
+  HugePageMap hugePages;
+  if (expectHugePages())
+    GALOIS_ASSERT(hugePages.count(ptr, numPages * allocSize()) > 0);
+  GALOIS_ASSERT(hugePages.count(ptr, numPages * allocSize()) <= numPages);
+  GALOIS_ASSERT(hugePages.hugeBytes(ptr, numPages * allocSize()) <=
+                numPages * allocSize());
+  GALOIS_ASSERT(hugePages.count(ptr, 0) == 0);
+  freePages(ptr, numPages);
+
+  galois::LargeArray<uint64_t> array;
+  array.allocateLocal(numPages * allocSize() / sizeof(uint64_t));
+  GALOIS_ASSERT(array.numHugePages() <= numPages);
+
+  galois::LargeArray<void> empty;
+  GALOIS_ASSERT(empty.numHugePages() == 0);
+
+  return 0;
+}
@@ -33,7 +33,8 @@ void printMyTopo() {
               << " socket: " << c.socket << " numaNode: " << c.numaNode
               << " cumulativeMaxSocket: " << c.cumulativeMaxSocket
               << " osContext: " << c.osContext
-              << " osNumaNode: " << c.osNumaNode << "\n";
+              << " osNumaNode: " << c.osNumaNode
+              << " coreLeader: " << c.coreLeader << "\n";
   }
 }
 
@@ -0,0 +1,96 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Bag.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/substrate/MemAccounting.h"
+
+using namespace galois::substrate;
+
+int64_t live(MemCategory c) { return getMemUsage(c).live; }
+
+void testLargeArray() {
+  int64_t before = live(MemCategory::LargeArray);
+  {
+    galois::LargeArray<double> array;
+    array.allocateInterleaved(1 << 20);
+    GALOIS_ASSERT(live(MemCategory::LargeArray) - before >=
+                  int64_t(sizeof(double) << 20));
+    GALOIS_ASSERT(getMemUsage(MemCategory::LargeArray).peak >=
+                  live(MemCategory::LargeArray));
+  }
+  GALOIS_ASSERT(live(MemCategory::LargeArray) == before);
+
+  // Per-node counts add up to the total
+  int64_t sum = 0;
+  for (unsigned n = 0; n <= MEM_ACCOUNTING_MAX_NODE; ++n)
+    sum += getMemUsage(MemCategory::LargeArray, n).live;
+  GALOIS_ASSERT(sum == live(MemCategory::LargeArray));
+}
+
+void testGraph() {
+  int64_t arrays = live(MemCategory::LargeArray);
+  int64_t graphs = live(MemCategory::Graph);
+  {
+    galois::graphs::LC_CSR_Graph<int, int> g;
+    g.allocateFrom(1000, 10000);
+    GALOIS_ASSERT(live(MemCategory::Graph) > graphs);
+    GALOIS_ASSERT(live(MemCategory::LargeArray) == arrays);
+  }
+  GALOIS_ASSERT(live(MemCategory::Graph) == graphs);
+}
+
+void testInsertBag() {
+  int64_t before = live(MemCategory::InsertBag);
+  galois::InsertBag<int> bag;
+  galois::do_all(galois::iterate(0, 100000), [&](int i) { bag.push(i); });
+  GALOIS_ASSERT(live(MemCategory::InsertBag) > before);
+  bag.clear();
+  GALOIS_ASSERT(live(MemCategory::InsertBag) == before);
+}
+
+struct Padded {
+  char data[256];
+};
+
+void testPerThreadStorage() {
+  int64_t before = live(MemCategory::PerThreadStorage);
+  {
+    PerThreadStorage<Padded> pts;
+    GALOIS_ASSERT(live(MemCategory::PerThreadStorage) - before ==
+                  int64_t(sizeof(Padded) * getThreadPool().getMaxThreads()));
+  }
+  GALOIS_ASSERT(live(MemCategory::PerThreadStorage) == before);
+}
+
+int main() {
+  setMemAccounting(true);
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      std::max(galois::substrate::getThreadPool().getMaxThreads(), 2U));
+
+  testLargeArray();
+  testGraph();
+  testInsertBag();
+  testPerThreadStorage();
+
+  return 0;
+}
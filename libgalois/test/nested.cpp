@@ -0,0 +1,164 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+
+#include <atomic>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+//! Sum of [0, n)
+static size_t triangle(size_t n) { return n * (n - 1) / 2; }
+
+//! A few items have a large amount of inner work, as hub vertices would
+void testForEach() {
+  std::vector<size_t> sizes(100, 10);
+  sizes[3]  = 100000;
+  sizes[50] = 200000;
+
+  galois::GAccumulator<size_t> sum;
+  galois::for_each(
+      galois::iterate(sizes.begin(), sizes.end()),
+      [&](size_t n, auto&) {
+        galois::do_all(galois::iterate(size_t{0}, n),
+                       [&](size_t i) { sum += i; });
+      },
+      galois::loopname("outer"), galois::no_pushes(),
+      galois::disable_conflict_detection());
+
+  size_t expected = 0;
+  for (size_t n : sizes) {
+    expected += triangle(n);
+  }
+  GALOIS_ASSERT(sum.reduce() == expected);
+}
+
+void testDoAll() {
+  std::vector<size_t> values(1000);
+  std::iota(values.begin(), values.end(), size_t{0});
+
+  galois::GAccumulator<size_t> sum;
+  auto outer = [&](size_t) {
+    // nested twice; the innermost loop runs serially
+    galois::do_all(galois::iterate(values), [&](size_t v) {
+      galois::do_all(galois::iterate(size_t{0}, size_t{2}),
+                     [&](size_t k) { sum += v * k; });
+    });
+  };
+
+  galois::do_all(galois::iterate(size_t{0}, size_t{64}), outer,
+                 galois::steal());
+  GALOIS_ASSERT(sum.reduce() == 64 * triangle(values.size()));
+
+  sum.reset();
+  galois::do_all(galois::iterate(size_t{0}, size_t{64}), outer);
+  GALOIS_ASSERT(sum.reduce() == 64 * triangle(values.size()));
+}
+
+/**
+ * A body that throws on a helper thread cancels the loop, and the exception
+ * is kept for the owner instead of escaping into the helper's own loop.
+ */
+void testHelperThrows() {
+  std::atomic<size_t> count{0};
+  auto body = [](void* c, size_t begin, size_t) {
+    if (begin == 32) {
+      throw std::runtime_error("helper aborts");
+    }
+    ++*static_cast<std::atomic<size_t>*>(c);
+  };
+  galois::runtime::internal::NestedLoop loop(body, &count, 1024, 16);
+
+  GALOIS_ASSERT(loop.help());
+  GALOIS_ASSERT(count == 2);
+  GALOIS_ASSERT(!loop.work(), "loop kept running after a helper threw");
+
+  bool rethrown = false;
+  try {
+    loop.rethrow();
+  } catch (const std::runtime_error&) {
+    rethrown = true;
+  }
+  GALOIS_ASSERT(rethrown);
+}
+
+/**
+ * The owner of a shared nested loop throws on its first iteration. Helpers
+ * may finish the chunk they hold, but must not start the rest of the loop.
+ */
+void testOwnerThrows() {
+  constexpr size_t N     = 1 << 16;
+  constexpr size_t CHUNK = 16;
+  std::vector<std::atomic<unsigned>> hits(N);
+  std::atomic<size_t> count{0};
+  std::atomic<size_t> afterThrow{0};
+  std::atomic<bool> thrown{false};
+
+  galois::for_each(
+      galois::iterate(size_t{0}, size_t{64}),
+      [&](size_t item, auto&) {
+        if (item != 0) {
+          return;
+        }
+        unsigned owner = galois::substrate::ThreadPool::getTID();
+        try {
+          galois::do_all(
+              galois::iterate(size_t{0}, N),
+              [&](size_t i) {
+                if (galois::substrate::ThreadPool::getTID() == owner &&
+                    !thrown.exchange(true)) {
+                  throw std::runtime_error("owner aborts");
+                }
+                if (thrown) {
+                  ++afterThrow;
+                }
+                ++hits[i];
+                ++count;
+              },
+              galois::chunk_size<CHUNK>());
+        } catch (const std::runtime_error&) {
+        }
+      },
+      galois::loopname("outer"), galois::no_pushes(),
+      galois::disable_conflict_detection());
+
+  GALOIS_ASSERT(thrown);
+  GALOIS_ASSERT(afterThrow <= (galois::getActiveThreads() - 1) * CHUNK,
+                "nested loop kept running after its owner threw");
+  GALOIS_ASSERT(count < N);
+  for (auto& h : hits) {
+    GALOIS_ASSERT(h <= 1);
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      std::max(galois::substrate::getThreadPool().getMaxThreads(), 2U));
+
+  testForEach();
+  testDoAll();
+  testOwnerThrows();
+  testHelperThrows();
+
+  return 0;
+}
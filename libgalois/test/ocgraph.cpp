@@ -0,0 +1,97 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/OCGraph.h"
+#include "galois/graphs/ReadGraph.h"
+#include "TestGraphs.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using Graph = galois::graphs::OCImmutableEdgeGraph<void, int, true>;
+using GNode = Graph::GraphNode;
+
+void writeGraph(const std::string& path) {
+  std::mt19937 gen(0);
+  galois::graphs::FileGraphWriter w;
+  writeAdjacency<int>(w, randomAdjacency(5000, 20, gen));
+  w.toFile(path);
+}
+
+//! Streams all segments and checks that every edge is seen exactly once with
+//! the right destination and data
+void checkStream(const std::string& path, galois::graphs::FileGraph& expected,
+                 size_t segmentEdges) {
+  Graph graph;
+  galois::graphs::readGraph(graph, path);
+  auto segments = galois::graphs::makeSegments(graph, segmentEdges);
+  GALOIS_ASSERT(segments.size() > 1);
+
+  std::vector<int> seen(expected.size());
+  GNode next = 0;
+  galois::graphs::forEachSegment(
+      graph, segments.begin(), segments.end(), [&](Graph::segment_type& seg) {
+        GALOIS_ASSERT(seg.loaded());
+        GALOIS_ASSERT(*graph.begin(seg) == next);
+        next = *graph.end(seg);
+        galois::graphs::BindSegmentGraph<Graph> sg(graph, seg);
+        galois::do_all(
+            galois::iterate(graph.begin(seg), graph.end(seg)), [&](GNode n) {
+              auto e = expected.edge_begin(n);
+              for (auto a : sg.edges(n, galois::MethodFlag::UNPROTECTED)) {
+                GALOIS_ASSERT(sg.getEdgeDst(a) == expected.getEdgeDst(e));
+                GALOIS_ASSERT(sg.getEdgeData(a) ==
+                              expected.getEdgeData<int>(e));
+                ++e;
+              }
+              GALOIS_ASSERT(e == expected.edge_end(n));
+              seen[n] += 1;
+            });
+      });
+  GALOIS_ASSERT(next == expected.size());
+  for (int s : seen)
+    GALOIS_ASSERT(s == 1);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+
+  char dir[] = "/tmp/ocgraphXXXXXX";
+  GALOIS_ASSERT(mkdtemp(dir));
+  std::string gr = std::string(dir) + "/graph.gr";
+  writeGraph(gr);
+
+  galois::graphs::FileGraph expected;
+  expected.fromFile(gr);
+
+  for (unsigned threads : {1, 3}) {
+    galois::setActiveThreads(threads);
+    for (size_t segmentEdges : {1, 1000, 20000})
+      checkStream(gr, expected, segmentEdges);
+  }
+
+  unlink(gr.c_str());
+  rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/runtime/Context.h"
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+static const unsigned numCells = 64;
+static const unsigned maxTime  = 200;
+
+struct Cell : public galois::runtime::Lockable {
+  std::vector<unsigned> history;
+};
+
+struct Event {
+  unsigned time;
+  unsigned cell;
+};
+
+struct EventCmp {
+  bool operator()(const Event& a, const Event& b) const {
+    return a.time < b.time;
+  }
+};
+
+static unsigned neighbor(unsigned cell) { return (cell + 1) % numCells; }
+
+//! Each event fires a later event. Firing on the same cell keeps every source
+//! of the dependence graph a source (stable-source algorithm); firing on
+//! another cell does not.
+static bool nextEvent(const Event& e, bool sameCell, Event& next) {
+  next.time = e.time + 1 + (e.cell * 7) % 5;
+  next.cell = sameCell ? e.cell : (e.cell * 3 + 1) % numCells;
+  return next.time < maxTime;
+}
+
+static void fire(std::vector<Cell>& cells, const Event& e) {
+  cells[e.cell].history.push_back(e.time);
+  cells[neighbor(e.cell)].history.push_back(e.time);
+}
+
+static std::vector<Event> initialEvents() {
+  std::vector<Event> events;
+  for (unsigned i = 0; i < numCells; ++i)
+    events.push_back(Event{i % 3, i});
+  return events;
+}
+
+static void serial(std::vector<Cell>& cells, bool sameCell) {
+  auto rcmp = [](const Event& a, const Event& b) { return b.time < a.time; };
+  std::priority_queue<Event, std::vector<Event>, decltype(rcmp)> pq(rcmp);
+  for (const Event& e : initialEvents())
+    pq.push(e);
+  while (!pq.empty()) {
+    Event e = pq.top();
+    pq.pop();
+    fire(cells, e);
+    Event next;
+    if (nextEvent(e, sameCell, next))
+      pq.push(next);
+  }
+}
+
+static void ordered(std::vector<Cell>& cells, bool sameCell) {
+  std::vector<Event> events = initialEvents();
+
+  auto nhFunc = [&](const Event& e) {
+    galois::runtime::acquire(&cells[e.cell], galois::MethodFlag::WRITE);
+    galois::runtime::acquire(&cells[neighbor(e.cell)],
+                             galois::MethodFlag::WRITE);
+  };
+  auto opFunc = [&](const Event& e, galois::UserContext<Event>& ctx) {
+    fire(cells, e);
+    Event next;
+    if (nextEvent(e, sameCell, next))
+      ctx.push(next);
+  };
+
+  if (sameCell)
+    galois::for_each_ordered(events.begin(), events.end(), EventCmp(), nhFunc,
+                             opFunc, "stable");
+  else
+    // Without lookahead information no source is known to be stable, so only
+    // the earliest event of each round may run
+    galois::for_each_ordered(
+        events.begin(), events.end(), EventCmp(), nhFunc, opFunc,
+        [](const Event&) { return false; }, "unstable");
+}
+
+static void check(const std::vector<Cell>& expected,
+                  const std::vector<Cell>& actual) {
+  for (unsigned i = 0; i < numCells; ++i) {
+    const auto& h = actual[i].history;
+    GALOIS_ASSERT(std::is_sorted(h.begin(), h.end()), "cell ", i);
+    GALOIS_ASSERT(h == expected[i].history, "cell ", i);
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(
+      std::max(galois::substrate::getThreadPool().getMaxThreads(), 2U));
+
+  for (bool sameCell : {true, false}) {
+    std::vector<Cell> expected(numCells);
+    serial(expected, sameCell);
+
+    std::vector<Cell> actual(numCells);
+    ordered(actual, sameCell);
+    check(expected, actual);
+  }
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/Reorder.h"
+#include "TestGraphs.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace galois::graphs;
+
+using Graph = LC_CSR_Graph<unsigned, int>::with_no_lockable<true>::type;
+using Edges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+//! Symmetric graph: a randomly labelled path plus a few hubs
+Edges makeEdges(uint32_t numNodes) {
+  std::mt19937 gen(0);
+  std::vector<uint32_t> label(numNodes);
+  for (uint32_t i = 0; i < numNodes; ++i)
+    label[i] = i;
+  std::shuffle(label.begin(), label.end(), gen);
+
+  Edges edges;
+  for (uint32_t i = 0; i + 1 < numNodes; ++i) {
+    edges.emplace_back(label[i], label[i + 1]);
+    edges.emplace_back(label[i + 1], label[i]);
+  }
+  for (uint32_t hub = 0; hub < 3; ++hub) {
+    for (uint32_t i = 0; i < numNodes / 4; ++i) {
+      uint32_t other = gen() % numNodes;
+      if (other == label[hub])
+        continue;
+      edges.emplace_back(label[hub], other);
+      edges.emplace_back(other, label[hub]);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+//! Writes edges into w with src ^ dst as the data of each edge
+void writeEdges(FileGraphWriter& w, uint32_t numNodes, const Edges& edges) {
+  TestAdjacency adj(numNodes);
+  for (auto& e : edges)
+    adj[e.first].emplace_back(e.second, int(e.first ^ e.second));
+  writeAdjacency<int>(w, adj);
+}
+
+void makeGraph(Graph& g, uint32_t numNodes, const Edges& edges) {
+  FileGraphWriter w;
+  writeEdges(w, numNodes, edges);
+  readGraph(g, w);
+}
+
+void checkPermutation(const NodePermutation& p, uint32_t numNodes) {
+  GALOIS_ASSERT(p.size() == numNodes);
+  std::vector<bool> seen(numNodes, false);
+  for (uint32_t n = 0; n < numNodes; ++n) {
+    GALOIS_ASSERT(p.newId(n) < numNodes && !seen[p.newId(n)]);
+    seen[p.newId(n)] = true;
+    GALOIS_ASSERT(p.oldId(p.newId(n)) == n);
+  }
+}
+
+//! The relabelled graph has exactly the edges of g mapped through p
+void checkRelabel(Graph& g, const NodePermutation& p, const Edges& edges) {
+  Graph out;
+  relabelGraph(g, p, out);
+  GALOIS_ASSERT(out.size() == g.size());
+  GALOIS_ASSERT(out.sizeEdges() == g.sizeEdges());
+
+  Edges relabelled;
+  for (auto n : out) {
+    for (auto e : out.edges(n)) {
+      uint32_t src = p.oldId(n);
+      uint32_t dst = p.oldId(out.getEdgeDst(e));
+      GALOIS_ASSERT(out.getEdgeData(e) == int(src ^ dst));
+      relabelled.emplace_back(src, dst);
+    }
+  }
+  std::sort(relabelled.begin(), relabelled.end());
+  GALOIS_ASSERT(relabelled == edges);
+}
+
+//! Largest |p(src) - p(dst)| over all edges
+uint32_t bandwidth(Graph& g, const NodePermutation& p) {
+  uint32_t width = 0;
+  for (auto n : g) {
+    for (auto e : g.edges(n)) {
+      uint32_t a = p.newId(n), b = p.newId(g.getEdgeDst(e));
+      width      = std::max(width, a > b ? a - b : b - a);
+    }
+  }
+  return width;
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  const uint32_t numNodes = 2000;
+  Edges edges             = makeEdges(numNodes);
+  Graph g;
+  makeGraph(g, numNodes, edges);
+
+  NodePermutation identity;
+  GALOIS_ASSERT(identity.empty() && identity.newId(42) == 42);
+
+  NodePermutation degree = reorderNodes(g, ReorderPolicy::Degree);
+  checkPermutation(degree, numNodes);
+  checkRelabel(g, degree, edges);
+  for (uint32_t n = 0; n + 1 < numNodes; ++n)
+    GALOIS_ASSERT(g.getDegree(degree.oldId(n)) >=
+                  g.getDegree(degree.oldId(n + 1)));
+
+  NodePermutation hub = reorderNodes(g, ReorderPolicy::HubSort);
+  checkPermutation(hub, numNodes);
+  checkRelabel(g, hub, edges);
+  // Non-hubs keep their relative order
+  uint64_t average = g.sizeEdges() / numNodes;
+  uint32_t last    = 0;
+  for (uint32_t n = 0; n < numNodes; ++n) {
+    if (g.getDegree(n) > average)
+      continue;
+    GALOIS_ASSERT(hub.newId(n) >= last);
+    last = hub.newId(n);
+  }
+
+  NodePermutation rcm = reorderNodes(g, ReorderPolicy::RCM);
+  checkPermutation(rcm, numNodes);
+  checkRelabel(g, rcm, edges);
+
+  NodePermutation gorder = reorderNodes(g, ReorderPolicy::Gorder);
+  checkPermutation(gorder, numNodes);
+  checkRelabel(g, gorder, edges);
+
+  // Without the hubs, RCM recovers the path
+  Edges path;
+  for (auto& e : edges)
+    if (g.getDegree(e.first) <= 2 && g.getDegree(e.second) <= 2)
+      path.push_back(e);
+  Graph pathGraph;
+  makeGraph(pathGraph, numNodes, path);
+  GALOIS_ASSERT(bandwidth(pathGraph, NodePermutation()) > 100);
+  GALOIS_ASSERT(bandwidth(pathGraph, rcmOrder(pathGraph)) <= 2);
+
+  // Orderings also work directly on file graphs
+  FileGraphWriter w;
+  writeEdges(w, numNodes, edges);
+
+  NodePermutation fileOrder = degreeSortOrder(w);
+  checkPermutation(fileOrder, numNodes);
+  FileGraph permuted;
+  permute<int>(w, fileOrder.forward(), permuted);
+  GALOIS_ASSERT(permuted.sizeEdges() == edges.size());
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * Checks every intersection kernel against std::set_intersection and, as a
+ * microbenchmark, prints the time per intersection of each kernel for a few
+ * list size ratios.
+ */
+
+#include "galois/Galois.h"
+#include "galois/SetIntersection.h"
+#include "galois/Timer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using galois::IntersectKernel;
+
+static const IntersectKernel kernels[] = {
+    IntersectKernel::Auto, IntersectKernel::Merge, IntersectKernel::Galloping,
+    IntersectKernel::AVX2, IntersectKernel::AVX512};
+
+std::vector<uint32_t> randomList(std::mt19937& gen, size_t n,
+                                 uint32_t universe) {
+  std::vector<uint32_t> list;
+  std::uniform_int_distribution<uint32_t> dist(0, universe - 1);
+  while (list.size() < n) {
+    for (size_t i = list.size(); i < n; ++i)
+      list.push_back(dist(gen));
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+  }
+  return list;
+}
+
+void check(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs,
+           IntersectKernel k) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                        std::back_inserter(expected));
+
+  GALOIS_ASSERT(galois::intersectCount(lhs.data(), lhs.size(), rhs.data(),
+                                       rhs.size(), k) == expected.size());
+
+  std::vector<uint32_t> posA(std::min(lhs.size(), rhs.size()));
+  std::vector<uint32_t> posB(posA.size());
+  size_t n =
+      galois::intersectPositions(lhs.data(), lhs.size(), rhs.data(),
+                                 rhs.size(), posA.data(), posB.data(), k);
+  GALOIS_ASSERT(n == expected.size());
+  for (size_t i = 0; i < n; ++i) {
+    GALOIS_ASSERT(lhs[posA[i]] == expected[i]);
+    GALOIS_ASSERT(rhs[posB[i]] == expected[i]);
+  }
+}
+
+void checkBitmap(const std::vector<uint32_t>& hub,
+                 const std::vector<uint32_t>& rhs, uint32_t universe) {
+  galois::IntersectBitmap bitmap;
+  bitmap.resize(universe);
+  bitmap.set(hub.data(), hub.size());
+  GALOIS_ASSERT(bitmap.count(rhs.data(), rhs.size()) ==
+                galois::intersectCount(hub.data(), hub.size(), rhs.data(),
+                                       rhs.size()));
+  bitmap.reset(hub.data(), hub.size());
+  GALOIS_ASSERT(bitmap.count(hub.data(), hub.size()) == 0);
+}
+
+void benchmark(std::mt19937& gen, size_t small, size_t ratio) {
+  const uint32_t universe = 1 << 22;
+  const size_t pairs      = 64;
+  std::vector<std::vector<uint32_t>> as, bs;
+  for (size_t i = 0; i < pairs; ++i) {
+    as.push_back(randomList(gen, small, universe));
+    bs.push_back(randomList(gen, small * ratio, universe));
+  }
+
+  std::printf("%8zu x %-8zu", small, small * ratio);
+  for (IntersectKernel k : kernels) {
+    if (!galois::intersectKernelSupported(k)) {
+      std::printf(" %10s: %8s", galois::intersectKernelName(k), "-");
+      continue;
+    }
+    galois::Timer timer;
+    size_t total = 0;
+    timer.start();
+    for (int rep = 0; rep < 4; ++rep)
+      for (size_t i = 0; i < pairs; ++i)
+        total += galois::intersectCount(as[i].data(), as[i].size(),
+                                        bs[i].data(), bs[i].size(), k);
+    timer.stop();
+    GALOIS_ASSERT(total != size_t(-1));
+    std::printf(" %10s: %8.2f", galois::intersectKernelName(k),
+                timer.get_usec() * 1000.0 / (4 * pairs));
+  }
+  std::printf(" ns/intersection\n");
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  std::mt19937 gen(0);
+
+  for (size_t na : {0, 1, 7, 8, 9, 15, 16, 17, 100, 1000}) {
+    for (size_t nb : {0, 3, 8, 16, 33, 500, 5000}) {
+      for (uint32_t universe : {64u, 1024u, 1u << 20}) {
+        if (na > universe || nb > universe)
+          continue;
+        auto a = randomList(gen, na, universe);
+        auto b = randomList(gen, nb, universe);
+        for (IntersectKernel k : kernels) {
+          if (galois::intersectKernelSupported(k)) {
+            check(a, b, k);
+            check(b, a, k);
+          }
+        }
+        checkBitmap(a, b, universe);
+      }
+    }
+  }
+
+  std::printf("Auto uses %s for 1000 x 1000 and %s for 10 x 1000\n",
+              galois::intersectKernelName(
+                  galois::selectIntersectKernel(1000, 1000)),
+              galois::intersectKernelName(
+                  galois::selectIntersectKernel(10, 1000)));
+  for (size_t ratio : {1, 4, 32, 64, 256})
+    benchmark(gen, 256, ratio);
+
+  return 0;
+}
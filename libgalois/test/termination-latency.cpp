@@ -0,0 +1,97 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/substrate/Termination.h"
+#include "Lonestar/BoilerPlate.h"
+#include "llvm/Support/CommandLine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace cll = llvm::cl;
+
+static cll::opt<int> rounds("rounds", cll::desc("number of rounds"),
+                            cll::init(100));
+static cll::opt<unsigned>
+    threads("threads",
+            cll::desc("largest number of threads (default all usable)"),
+            cll::init(0));
+
+using galois::substrate::TerminationDetection;
+
+//! Time from every thread becoming idle to global termination being
+//! detected, for thread counts doubling up to the largest one
+template <typename Term>
+void runLatency(const char* name) {
+  auto& tp      = galois::substrate::getThreadPool();
+  unsigned maxT = tp.getMaxUsableThreads();
+  if (threads)
+    maxT = std::min<unsigned>(threads, maxT);
+
+  for (unsigned num = 1;; num = std::min(2 * num, maxT)) {
+    galois::setActiveThreads(num);
+
+    // Temporarily install our detector as the system one; only
+    // getSystemTermination may initialize it
+    Term term;
+    TerminationDetection* sys = &galois::substrate::getSystemTermination(num);
+    galois::substrate::internal::setTermDetect(nullptr);
+    galois::substrate::internal::setTermDetect(&term);
+    TerminationDetection& t = galois::substrate::getSystemTermination(num);
+    galois::substrate::Barrier& barrier = galois::runtime::getBarrier(num);
+
+    uint64_t total = 0;
+    for (int r = 0; r < rounds; ++r) {
+      galois::on_each([&](unsigned tid, unsigned) {
+        t.initializeThread();
+        barrier();
+        auto start = std::chrono::steady_clock::now();
+        while (!t.globalTermination())
+          t.localTermination(false);
+        if (tid == 0)
+          total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+      });
+    }
+
+    galois::substrate::internal::setTermDetect(nullptr);
+    galois::substrate::internal::setTermDetect(sys);
+
+    std::cout << name << " threads: " << num << " latency (ns): "
+              << total / std::max(int(rounds), 1) << "\n";
+
+    if (num == maxT)
+      break;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  galois::SharedMemSys Galois_runtime;
+  LonestarStart(argc, argv);
+
+  using namespace galois::substrate::internal;
+  runLatency<LocalTerminationDetection<>>("Ring");
+  runLatency<TreeTerminationDetection<>>("Tree");
+  runLatency<HierarchicalTerminationDetection<>>("Hierarchical");
+
+  return 0;
+}
@@ -42,6 +42,14 @@ static cll::opt<int> trials("trials", cll::desc("number of trials"),
                             cll::init(1));
 static cll::opt<unsigned> threads("threads", cll::desc("number of threads"),
                                   cll::init(2));
+static cll::opt<int>
+    idle("idle",
+         cll::desc("microseconds to sleep between loops when measuring "
+                   "wake-up latency"),
+         cll::init(50));
+static cll::opt<int> latencyRounds("latencyRounds",
+                                   cll::desc("number of wake-up rounds"),
+                                   cll::init(200));
 
 void runDoAllBurn(int num) {
   galois::substrate::getThreadPool().burnPower(galois::getActiveThreads());
@@ -80,6 +88,42 @@ void runExplicitThread(int num) {
   });
 }
 
+//! Time a loop started after the pool has been idle for a while
+template <typename LoopFn>
+void runWakeupLatency(LoopFn loop, std::chrono::microseconds spin,
+                      std::string name) {
+  auto& tp       = galois::substrate::getThreadPool();
+  auto oldSpin   = tp.getIdleSpin();
+  uint64_t total = 0;
+
+  tp.setIdleSpin(spin);
+  for (int r = 0; r < latencyRounds; ++r) {
+    std::this_thread::sleep_for(std::chrono::microseconds(idle));
+    auto start = std::chrono::steady_clock::now();
+    loop();
+    total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+  }
+  tp.setIdleSpin(oldSpin);
+
+  std::cout << name << " spin: " << spin.count()
+            << " us latency (ns): " << total / std::max(int(latencyRounds), 1)
+            << "\n";
+}
+
+void runLatencies(std::chrono::microseconds spin) {
+  runWakeupLatency([]() { galois::on_each([](unsigned, unsigned) {}); }, spin,
+                   "OnEachWakeup");
+  runWakeupLatency(
+      []() {
+        galois::do_all(galois::iterate(0, int(size)), [&](int) {
+          asm volatile("" ::: "memory");
+        });
+      },
+      spin, "DoAllWakeup");
+}
+
 void run(std::function<void(int)> fn, std::string name) {
   galois::Timer t;
   t.start();
@@ -109,6 +153,8 @@ int main(int argc, char* argv[]) {
     run(runDoAll, "DoAll");
     run(runDoAllBurn, "DoAllBurn");
     run(runExplicitThread, "ExplicitThread");
+    runLatencies(std::chrono::microseconds(0));
+    runLatencies(std::chrono::microseconds(2 * idle));
   }
   EXIT = 1;
 
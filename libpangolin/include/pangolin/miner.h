@@ -3,6 +3,7 @@
 #include "pangolin/scan.h"
 #include "pangolin/util.h"
 #include "pangolin/embedding_queue.h"
+#include "galois/SetIntersection.h"
 #include "bliss/uintseqhash.hh"
 #define CHUNK_SIZE 1
 
@@ -188,62 +189,21 @@ protected:
     return std::distance(g->edge_begin(vid), g->edge_end(vid));
   }
   inline unsigned intersect_merge(unsigned src, unsigned dst) {
-    unsigned count = 0;
-    for (auto e : graph.edges(dst)) {
-      GNode dst_dst = graph.getEdgeDst(e);
-      for (auto e1 : graph.edges(src)) {
-        GNode to = graph.getEdgeDst(e1);
-        if (dst_dst == to) {
-          count += 1;
-          break;
-        }
-        if (to > dst_dst)
-          break;
-      }
-    }
-    return count;
+    return galois::intersectCount(
+        graph.getEdgeDstPtr(graph.edge_begin(src)), get_degree(&graph, src),
+        graph.getEdgeDstPtr(graph.edge_begin(dst)), get_degree(&graph, dst));
   }
   inline unsigned intersect_dag_merge(unsigned p, unsigned q) {
-    unsigned count = 0;
-    auto p_start   = graph.edge_begin(p);
-    auto p_end     = graph.edge_end(p);
-    auto q_start   = graph.edge_begin(q);
-    auto q_end     = graph.edge_end(q);
-    auto p_it      = p_start;
-    auto q_it      = q_start;
-    int a;
-    int b;
-    while (p_it < p_end && q_it < q_end) {
-      a     = graph.getEdgeDst(p_it);
-      b     = graph.getEdgeDst(q_it);
-      int d = a - b;
-      if (d <= 0)
-        p_it++;
-      if (d >= 0)
-        q_it++;
-      if (d == 0)
-        count++;
-    }
-    return count;
+    return intersect_merge(p, q);
   }
   inline unsigned intersect_search(unsigned a, unsigned b) {
     if (degrees[a] == 0 || degrees[b] == 0)
       return 0;
-    unsigned count  = 0;
-    unsigned lookup = a;
-    unsigned search = b;
-    if (degrees[a] > degrees[b]) {
-      lookup = b;
-      search = a;
-    }
-    auto begin = graph.edge_begin(search);
-    auto end   = graph.edge_end(search);
-    for (auto e : graph.edges(lookup)) {
-      GNode key = graph.getEdgeDst(e);
-      if (binary_search(key, begin, end))
-        count++;
-    }
-    return count;
+    return galois::intersectCount(graph.getEdgeDstPtr(graph.edge_begin(a)),
+                                  degrees[a],
+                                  graph.getEdgeDstPtr(graph.edge_begin(b)),
+                                  degrees[b],
+                                  galois::IntersectKernel::Galloping);
   }
   inline bool is_all_connected_except(unsigned dst, unsigned pos,
                                       const EmbeddingTy& emb) {
@@ -52,6 +52,9 @@ static cll::opt<unsigned int>
     reportNode("reportNode",
                cll::desc("Node to report distance to (default value 1)"),
                cll::init(1));
+static cll::opt<galois::graphs::ReorderPolicy> reorderPolicy(
+    "reorder", cll::desc("Relabel nodes for locality (default none)"),
+    reorderPolicyValues(), cll::init(galois::graphs::ReorderPolicy::None));
 
 // static cll::opt<unsigned int> stepShiftw("delta",
 // cll::desc("Shift value for the deltastep"),
@@ -59,9 +62,10 @@ static cll::opt<unsigned int>
 
 enum Exec { SERIAL, PARALLEL };
 
-enum Algo { AsyncTile = 0, Async, SyncTile, Sync };
+enum Algo { AsyncTile = 0, Async, AsyncMQ, SyncTile, Sync };
 
-const char* const ALGO_NAMES[] = {"AsyncTile", "Async", "SyncTile", "Sync"};
+const char* const ALGO_NAMES[] = {"AsyncTile", "Async", "AsyncMQ", "SyncTile",
+                                  "Sync"};
 
 static cll::opt<Exec> execution(
     "exec",
@@ -72,6 +76,7 @@ static cll::opt<Exec> execution(
 static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm (default value SyncTile):"),
     cll::values(clEnumVal(AsyncTile, "AsyncTile"), clEnumVal(Async, "Async"),
+                clEnumVal(AsyncMQ, "Async with a MultiQueue ordered by level"),
                 clEnumVal(SyncTile, "SyncTile"), clEnumVal(Sync, "Sync")),
     cll::init(SyncTile));
 
@@ -152,7 +157,8 @@ struct OneTilePushWrap {
   }
 };
 
-template <bool CONCURRENT, typename T, typename P, typename R>
+template <bool CONCURRENT, typename T, bool PRIORITY = false, typename P,
+          typename R>
 void asyncAlgo(Graph& graph, GNode source, const P& pushWrap,
                const R& edgeRange) {
 
@@ -160,7 +166,8 @@ void asyncAlgo(Graph& graph, GNode source, const P& pushWrap,
   // typedef PerSocketChunkFIFO<CHUNK_SIZE> dFIFO;
   using FIFO = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
   using BSWL = gwl::BulkSynchronous<gwl::PerSocketChunkLIFO<CHUNK_SIZE>>;
-  using WL   = FIFO;
+  using MQ   = gwl::MultiQueue<std::less<T>, T>;
+  using WL   = typename std::conditional<PRIORITY, MQ, FIFO>::type;
 
   using Loop =
       typename std::conditional<CONCURRENT, galois::ForEach,
@@ -304,6 +311,10 @@ void runAlgo(Graph& graph, const GNode& source) {
     asyncAlgo<CONCURRENT, UpdateRequest>(graph, source, ReqPushWrap(),
                                          OutEdgeRangeFn{graph});
     break;
+  case AsyncMQ:
+    asyncAlgo<CONCURRENT, UpdateRequest, true>(graph, source, ReqPushWrap(),
+                                               OutEdgeRangeFn{graph});
+    break;
   case SyncTile:
     syncAlgo<CONCURRENT, EdgeTile>(graph, source, EdgeTilePushWrap{graph},
                                    TileRangeFn());
@@ -339,11 +350,13 @@ int main(int argc, char** argv) {
     abort();
   }
 
+  galois::graphs::NodePermutation perm = LonestarReorder(graph, reorderPolicy);
+
   auto it = graph.begin();
-  std::advance(it, startNode.getValue());
+  std::advance(it, perm.newId(startNode));
   source = *it;
   it     = graph.begin();
-  std::advance(it, reportNode.getValue());
+  std::advance(it, perm.newId(reportNode));
   report = *it;
 
   size_t approxNodeData = 4 * (graph.size() + graph.sizeEdges());
@@ -530,62 +530,22 @@ struct EdgeTiledAsyncAlgo {
     galois::graphs::readGraph(graph, inputFile);
   }
 
-  struct EdgeTile {
-    // Node* sData;
-    GNode src;
-    Graph::edge_iterator beg;
-    Graph::edge_iterator end;
-  };
-
-  /*struct EdgeTileMaker {
-      EdgeTile operator() (Node* sdata, Graph::edge_iterator beg,
-  Graph::edge_iterator end) const{ return EdgeTile{sdata, beg, end};
-      }
-  };*/
-
   void operator()(Graph& graph) {
     galois::GAccumulator<size_t> emptyMerges;
 
-    galois::InsertBag<EdgeTile> works;
-
     std::cout << "INFO: Using edge tile size of " << EDGE_TILE_SIZE
               << " and chunk size of " << CHUNK_SIZE << "\n";
     std::cout << "WARNING: Performance varies considerably due to parameter.\n";
     std::cout
         << "WARNING: Do not expect the default to be good for your graph.\n";
 
-    galois::do_all(
-        galois::iterate(graph),
-        [&](const GNode& src) {
-          // Node& sdata=graph.getData(src,
-          // galois::MethodFlag::UNPROTECTED);
-          auto beg = graph.edge_begin(src, galois::MethodFlag::UNPROTECTED);
-          const auto end = graph.edge_end(src, galois::MethodFlag::UNPROTECTED);
-
-          assert(beg <= end);
-          if ((end - beg) > EDGE_TILE_SIZE) {
-            for (; beg + EDGE_TILE_SIZE < end;) {
-              auto ne = beg + EDGE_TILE_SIZE;
-              assert(ne < end);
-              works.push_back(EdgeTile{src, beg, ne});
-              beg = ne;
-            }
-          }
-
-          if ((end - beg) > 0) {
-            works.push_back(EdgeTile{src, beg, end});
-          }
-        },
-        galois::loopname("CC-EdgeTiledAsyncInit"), galois::steal());
-
-    galois::do_all(
-        galois::iterate(works),
-        [&](const EdgeTile& tile) {
-          // Node& sdata = *(tile.sData);
-          GNode src   = tile.src;
+    galois::do_all_edges(
+        graph, galois::iterate(graph),
+        [&](const GNode& src, Graph::edge_iterator beg,
+            Graph::edge_iterator end) {
           Node& sdata = graph.getData(src, galois::MethodFlag::UNPROTECTED);
 
-          for (auto ii = tile.beg; ii != tile.end; ++ii) {
+          for (auto ii = beg; ii != end; ++ii) {
             GNode dst = graph.getEdgeDst(ii);
             if (src >= dst)
               continue;
@@ -596,8 +556,8 @@ struct EdgeTiledAsyncAlgo {
           }
         },
         galois::loopname("CC-edgetiledAsync"), galois::steal(),
-        galois::chunk_size<CHUNK_SIZE>() // 16 -> 1
-    );
+        galois::chunk_size<CHUNK_SIZE>(),
+        galois::edge_tile<>(EDGE_TILE_SIZE));
 
     galois::do_all(
         galois::iterate(graph),
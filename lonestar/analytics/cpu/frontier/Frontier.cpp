@@ -0,0 +1,498 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/AtomicHelpers.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/graphs/Frontier.h"
+#include "galois/graphs/LC_CSR_CSC_Graph.h"
+#include "Lonestar/BoilerPlate.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace cll = llvm::cl;
+
+static const char* name = "Direction-optimizing Frontier Analytics";
+
+static const char* desc =
+    "Runs BFS, connected components, k-core or delta PageRank as rounds over "
+    "a frontier, switching each round between pushing along out edges and "
+    "pulling over in edges";
+
+static const char* url = nullptr;
+
+enum Algo { BFS, CC, KCore, PageRank };
+
+static cll::opt<std::string>
+    inputFile(cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm (default value BFS):"),
+    cll::values(clEnumVal(BFS, "BFS levels from -startNode"),
+                clEnumVal(CC, "Label propagation connected components "
+                              "(symmetric graph)"),
+                clEnumVal(KCore, "k-core with k = -kcore (symmetric graph)"),
+                clEnumVal(PageRank, "Delta PageRank")),
+    cll::init(BFS));
+static cll::opt<unsigned int>
+    startNode("startNode",
+              cll::desc("Node to start search from (default value 0)"),
+              cll::init(0));
+static cll::opt<unsigned int>
+    kcore("kcore", cll::desc("k-core value (default value 2)"), cll::init(2));
+static cll::opt<float> tolerance("tolerance",
+                                 cll::desc("PageRank tolerance (default value "
+                                           "0.001)"),
+                                 cll::init(1.0e-3));
+static cll::opt<unsigned int>
+    maxIterations("maxIterations",
+                  cll::desc("Maximum PageRank rounds (default value 1000)"),
+                  cll::init(1000));
+static cll::opt<unsigned int>
+    alpha("alpha",
+          cll::desc("alpha value to change direction in direction-optimization "
+                    "(default value 15)"),
+          cll::init(15));
+static cll::opt<unsigned int>
+    beta("beta",
+         cll::desc("beta value to change direction in direction-optimization "
+                   "(default value 18)"),
+         cll::init(18));
+
+using Graph  = galois::graphs::LC_CSR_CSC_Graph<void, void, false, true, true>;
+using GNode  = Graph::GraphNode;
+using Engine = galois::graphs::FrontierEngine<Graph>;
+using galois::graphs::Frontier;
+
+static cll::opt<Engine::Direction> direction(
+    "direction", cll::desc("Direction of every round (default value Auto):"),
+    cll::values(clEnumValN(Engine::Auto, "Auto", "Choose per round"),
+                clEnumValN(Engine::Push, "Push", "Always push"),
+                clEnumValN(Engine::Pull, "Pull", "Always pull")),
+    cll::init(Engine::Auto));
+
+constexpr static const float ALPHA         = 0.85;
+constexpr static const float INIT_RESIDUAL = 1 - ALPHA;
+
+uint64_t outDegree(Graph& graph, GNode n) {
+  return std::distance(graph.edge_begin(n, galois::MethodFlag::UNPROTECTED),
+                       graph.edge_end(n, galois::MethodFlag::UNPROTECTED));
+}
+
+//! Runs rounds until the frontier is empty; returns the number of rounds
+template <typename Op>
+unsigned runRounds(Engine& engine, Frontier*& cur, Frontier*& next, Op& op,
+                   const char* loopname) {
+  unsigned rounds = 0;
+  while (!cur->empty()) {
+    op.nextRound();
+    engine.edgeMap(*cur, *next, op, loopname);
+    std::swap(cur, next);
+    ++rounds;
+  }
+  return rounds;
+}
+
+/**
+ * BFS levels. A node is updated once, when it is first reached, so pulling
+ * stops scanning its in edges at the first one from the frontier.
+ */
+struct FrontierBFS {
+  constexpr static const uint32_t DIST_INFINITY =
+      std::numeric_limits<uint32_t>::max() - 1;
+
+  galois::LargeArray<std::atomic<uint32_t>> dist;
+  GNode source;
+  uint32_t level = 0;
+
+  bool cond(GNode dst) const { return dist[dst] == DIST_INFINITY; }
+
+  bool push(GNode, GNode dst) {
+    uint32_t old = DIST_INFINITY;
+    return dist[dst].compare_exchange_strong(old, level);
+  }
+
+  bool pull(GNode, GNode dst) {
+    dist[dst] = level;
+    return true;
+  }
+
+  void nextRound() { ++level; }
+
+  void run(Graph& graph, GNode src) {
+    source = src;
+    dist.create(graph.size());
+    galois::do_all(
+        galois::iterate(graph), [&](GNode n) { dist[n] = DIST_INFINITY; },
+        galois::no_stats(), galois::loopname("BFS_Init"));
+    dist[source] = 0;
+
+    Engine engine(graph, true, alpha, beta, direction);
+    Frontier a(graph.size()), b(graph.size());
+    Frontier *cur = &a, *next = &b;
+    cur->push(source);
+    unsigned rounds = runRounds(engine, cur, next, *this, "BFS");
+    std::cout << "BFS finished in " << rounds << " rounds\n";
+    engine.reportStats("BFS");
+  }
+
+  //! No edge shortcuts a level and the source is at level 0
+  bool verify(Graph& graph) {
+    galois::GAccumulator<uint64_t> bad;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          if (dist[n] == DIST_INFINITY)
+            return;
+          for (auto e : graph.edges(n, galois::MethodFlag::UNPROTECTED))
+            if (dist[graph.getEdgeDst(e)] > dist[n] + 1)
+              bad += 1;
+        },
+        galois::no_stats(), galois::loopname("BFS_Verify"));
+    return dist[source] == 0 && bad.reduce() == 0;
+  }
+
+  void report(Graph& graph) {
+    galois::GAccumulator<uint64_t> reached;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          if (dist[n] != DIST_INFINITY)
+            reached += 1;
+        },
+        galois::no_stats());
+    std::cout << "Number of reached nodes = " << reached.reduce() << "\n";
+  }
+};
+
+/**
+ * Min-label propagation. Every node starts in the frontier; afterwards a
+ * node is active in the round after its label dropped.
+ */
+struct FrontierCC {
+  galois::LargeArray<std::atomic<uint32_t>> comp;
+
+  bool cond(GNode) const { return true; }
+
+  bool push(GNode src, GNode dst) {
+    uint32_t label = comp[src];
+    return galois::atomicMin(comp[dst], label) > label;
+  }
+
+  bool pull(GNode src, GNode dst) {
+    uint32_t label = comp[src];
+    if (label >= comp[dst])
+      return false;
+    comp[dst] = label;
+    return true;
+  }
+
+  void nextRound() {}
+
+  void run(Graph& graph) {
+    comp.create(graph.size());
+    galois::do_all(
+        galois::iterate(graph), [&](GNode n) { comp[n] = n; },
+        galois::no_stats(), galois::loopname("CC_Init"));
+
+    Engine engine(graph, false, alpha, beta, direction);
+    Frontier a(graph.size()), b(graph.size());
+    Frontier *cur = &a, *next = &b;
+    cur->fill();
+    unsigned rounds = runRounds(engine, cur, next, *this, "CC");
+    std::cout << "CC finished in " << rounds << " rounds\n";
+    engine.reportStats("CC");
+  }
+
+  //! Both endpoints of every edge share a component
+  bool verify(Graph& graph) {
+    galois::GAccumulator<uint64_t> bad;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          for (auto e : graph.edges(n, galois::MethodFlag::UNPROTECTED))
+            if (comp[graph.getEdgeDst(e)] != comp[n])
+              bad += 1;
+        },
+        galois::no_stats(), galois::loopname("CC_Verify"));
+    return bad.reduce() == 0;
+  }
+
+  void report(Graph& graph) {
+    galois::GAccumulator<uint64_t> components;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          if (comp[n] == n)
+            components += 1;
+        },
+        galois::no_stats());
+    std::cout << "Number of components = " << components.reduce() << "\n";
+  }
+};
+
+/**
+ * k-core by peeling. The frontier holds the nodes removed in the last
+ * round; each removal decrements the degree of its neighbors, and a node
+ * whose degree drops below k is removed in the next round. Degrees drop many
+ * times, but each node is removed, and enters the frontier, only once, so
+ * the engine treats k-core as monotone.
+ */
+struct FrontierKCore {
+  galois::LargeArray<std::atomic<uint32_t>> degree;
+  uint32_t k;
+
+  bool cond(GNode dst) const { return degree[dst] >= k; }
+
+  bool push(GNode, GNode dst) { return degree[dst].fetch_sub(1) == k; }
+
+  bool pull(GNode, GNode dst) {
+    degree[dst] = degree[dst] - 1;
+    return degree[dst] == k - 1;
+  }
+
+  void nextRound() {}
+
+  void run(Graph& graph, uint32_t coreNum) {
+    k = coreNum;
+    degree.create(graph.size());
+    Frontier a(graph.size()), b(graph.size());
+    Frontier *cur = &a, *next = &b;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          degree[n] = outDegree(graph, n);
+          if (degree[n] < k)
+            cur->push(n);
+        },
+        galois::no_stats(), galois::loopname("KCore_Init"));
+
+    Engine engine(graph, true, alpha, beta, direction);
+    unsigned rounds = runRounds(engine, cur, next, *this, "KCore");
+    std::cout << "KCore finished in " << rounds << " rounds\n";
+    engine.reportStats("KCore");
+  }
+
+  //! Every node left has at least k neighbors left
+  bool verify(Graph& graph) {
+    galois::GAccumulator<uint64_t> bad;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          if (degree[n] < k)
+            return;
+          uint32_t alive = 0;
+          for (auto e : graph.edges(n, galois::MethodFlag::UNPROTECTED))
+            if (degree[graph.getEdgeDst(e)] >= k)
+              alive += 1;
+          if (alive < k)
+            bad += 1;
+        },
+        galois::no_stats(), galois::loopname("KCore_Verify"));
+    return bad.reduce() == 0;
+  }
+
+  void report(Graph& graph) {
+    galois::GAccumulator<uint64_t> alive;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          if (degree[n] >= k)
+            alive += 1;
+        },
+        galois::no_stats());
+    std::cout << "Number of nodes in the " << k << "-core is "
+              << alive.reduce() << "\n";
+  }
+};
+
+/**
+ * Delta PageRank (as in Ligra). A node in the frontier spreads its last
+ * change of rank over its out-neighbors; a node whose accumulated change
+ * exceeds the tolerance adds it to its rank and joins the next frontier,
+ * otherwise the change is kept for later rounds.
+ */
+struct FrontierPageRank {
+  galois::LargeArray<float> value;
+  galois::LargeArray<float> delta;
+  galois::LargeArray<std::atomic<float>> sum;
+  galois::LargeArray<uint32_t> degree;
+
+  bool cond(GNode) const { return true; }
+
+  bool push(GNode src, GNode dst) {
+    galois::atomicAdd(sum[dst], delta[src] / degree[src]);
+    return false;
+  }
+
+  bool pull(GNode src, GNode dst) {
+    sum[dst] = sum[dst] + delta[src] / degree[src];
+    return false;
+  }
+
+  void nextRound() {}
+
+  void run(Graph& graph) {
+    value.create(graph.size());
+    delta.create(graph.size());
+    sum.create(graph.size());
+    degree.create(graph.size());
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          value[n]  = INIT_RESIDUAL;
+          delta[n]  = INIT_RESIDUAL;
+          sum[n]    = 0;
+          degree[n] = outDegree(graph, n);
+        },
+        galois::no_stats(), galois::loopname("PageRank_Init"));
+
+    Engine engine(graph, false, alpha, beta, direction);
+    Frontier a(graph.size()), b(graph.size());
+    Frontier *cur = &a, *next = &b;
+    cur->fill();
+    unsigned rounds = 0;
+    while (!cur->empty() && rounds < maxIterations) {
+      // only frontier nodes pass their delta on; the rest accumulate it
+      engine.edgeMap(*cur, *next, *this, "PageRank");
+      galois::do_all(
+          galois::iterate(graph),
+          [&](GNode n) {
+            float d  = (cur->contains(n) ? 0 : delta[n]) + ALPHA * sum[n];
+            sum[n]   = 0;
+            delta[n] = d;
+            if (d > tolerance) {
+              value[n] += d;
+              next->push(n);
+            }
+          },
+          galois::no_stats(), galois::loopname("PageRank_Update"));
+      std::swap(cur, next);
+      ++rounds;
+    }
+    std::cout << "PageRank finished in " << rounds << " rounds\n";
+    engine.reportStats("PageRank");
+  }
+
+  //! Converged: no delta is left above the tolerance
+  bool verify(Graph& graph) {
+    galois::GAccumulator<uint64_t> bad;
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          if (delta[n] > tolerance || value[n] < 0)
+            bad += 1;
+        },
+        galois::no_stats(), galois::loopname("PageRank_Verify"));
+    return bad.reduce() == 0;
+  }
+
+  void report(Graph& graph) {
+    galois::GAccumulator<double> total;
+    galois::do_all(
+        galois::iterate(graph), [&](GNode n) { total += value[n]; },
+        galois::no_stats());
+    std::cout << "Sum of ranks = " << total.reduce() << "\n";
+  }
+};
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if ((algo == CC || algo == KCore) && !symmetricGraph) {
+    GALOIS_DIE("This application requires a symmetric graph input;"
+               " please use the -symmetricGraph flag "
+               " to indicate the input is a symmetric graph.");
+  }
+
+  Graph graph;
+  galois::StatTimer graphTime("TimerConstructGraph");
+  graphTime.start();
+  graph.readAndConstructBiGraphFromGRFile(inputFile);
+  graphTime.stop();
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges\n";
+
+  if (startNode >= graph.size()) {
+    std::cerr << "failed to set source: " << startNode << "\n";
+    abort();
+  }
+
+  FrontierBFS bfs;
+  FrontierCC cc;
+  FrontierKCore core;
+  FrontierPageRank pr;
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  switch (algo) {
+  case BFS:
+    bfs.run(graph, startNode);
+    break;
+  case CC:
+    cc.run(graph);
+    break;
+  case KCore:
+    core.run(graph, kcore);
+    break;
+  case PageRank:
+    pr.run(graph);
+    break;
+  }
+  execTime.stop();
+
+  bool ok = true;
+  switch (algo) {
+  case BFS:
+    bfs.report(graph);
+    ok = skipVerify || bfs.verify(graph);
+    break;
+  case CC:
+    cc.report(graph);
+    ok = skipVerify || cc.verify(graph);
+    break;
+  case KCore:
+    core.report(graph);
+    ok = skipVerify || core.verify(graph);
+    break;
+  case PageRank:
+    pr.report(graph);
+    ok = skipVerify || pr.verify(graph);
+    break;
+  }
+
+  if (!ok)
+    GALOIS_DIE("verification failed");
+  if (!skipVerify)
+    std::cout << "Verification successful.\n";
+
+  totalTime.stop();
+
+  return 0;
+}
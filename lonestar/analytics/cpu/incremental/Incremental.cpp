@@ -0,0 +1,546 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/AtomicHelpers.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/UnionFind.h"
+#include "galois/graphs/DeltaGraph.h"
+#include "galois/graphs/ReadGraph.h"
+#include "Lonestar/BoilerPlate.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cll = llvm::cl;
+
+static const char* name = "Incremental Analytics";
+
+static const char* desc =
+    "Replays a stream of edge insertions in batches and keeps connected "
+    "components, BFS levels and PageRank up to date after every batch";
+
+static const char* url = nullptr;
+
+enum Algo { CC, BFS, PageRank, All };
+
+static cll::opt<std::string>
+    inputFile(cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<std::string> streamFile(
+    "stream",
+    cll::desc("Text file of inserted edges, one \"src dst [timestamp]\" per "
+              "line; without timestamps the line number is used"),
+    cll::Required);
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm (default value All):"),
+    cll::values(clEnumVal(CC, "Weakly connected components"),
+                clEnumVal(BFS, "BFS levels from -startNode"),
+                clEnumVal(PageRank, "PageRank"),
+                clEnumVal(All, "All of the above")),
+    cll::init(All));
+static cll::opt<unsigned int>
+    batchSize("batchSize",
+              cll::desc("Number of stream edges per batch (default value "
+                        "10000); ignored if -batchTime is given"),
+              cll::init(10000));
+static cll::opt<uint64_t>
+    batchTime("batchTime",
+              cll::desc("Length of the timestamp window of each batch "
+                        "(default value 0: use -batchSize)"),
+              cll::init(0));
+static cll::opt<unsigned int>
+    startNode("startNode",
+              cll::desc("Node to start search from (default value 0)"),
+              cll::init(0));
+static cll::opt<float> tolerance("tolerance",
+                                 cll::desc("PageRank tolerance (default value "
+                                           "0.001)"),
+                                 cll::init(1.0e-3));
+static cll::opt<double> compactionRatio(
+    "compactionRatio",
+    cll::desc("Compact the graph once the logged updates exceed this fraction "
+              "of the base edges (default value 0.25; 0 disables)"),
+    cll::init(0.25));
+
+using Graph    = galois::graphs::DeltaGraph<void, void>;
+using Snapshot = Graph::Snapshot;
+using GNode    = Graph::GraphNode;
+
+constexpr static const unsigned CHUNK_SIZE = 64;
+
+struct StreamEdge {
+  GNode src;
+  GNode dst;
+  uint64_t time;
+};
+
+typedef std::vector<StreamEdge>::const_iterator StreamIter;
+
+/**
+ * Union-find over the nodes. An inserted edge only merges the components of
+ * its endpoints, so a batch costs a few finds per edge.
+ */
+struct IncrementalCC {
+  struct Node : public galois::UnionFindNode<Node> {
+    Node() : galois::UnionFindNode<Node>(this) {}
+  };
+
+  galois::LargeArray<Node> nodes;
+  uint64_t numComponents = 0;
+
+  void init(const Snapshot& graph) {
+    nodes.create(graph.size());
+    numComponents = graph.size() - merge(graph, graph.begin(), graph.end());
+  }
+
+  template <typename Iter>
+  uint64_t merge(const Snapshot& graph, Iter begin, Iter end) {
+    galois::GAccumulator<uint64_t> merges;
+    galois::do_all(
+        galois::iterate(begin, end),
+        [&](GNode src) {
+          for (auto e : graph.edges(src))
+            if (nodes[src].merge(&nodes[graph.getEdgeDst(e)]))
+              merges += 1;
+        },
+        galois::steal(), galois::no_stats(), galois::loopname("CC_Init"));
+    return merges.reduce();
+  }
+
+  void update(const Snapshot&, const Snapshot&, StreamIter begin,
+              StreamIter end) {
+    galois::GAccumulator<uint64_t> merges;
+    galois::do_all(
+        galois::iterate(begin, end),
+        [&](const StreamEdge& e) {
+          if (nodes[e.src].merge(&nodes[e.dst]))
+            merges += 1;
+        },
+        galois::no_stats(), galois::loopname("CC_Update"));
+    numComponents -= merges.reduce();
+  }
+
+  //! Same partition as a recomputation: every edge lies inside one of our
+  //! components and the number of components matches
+  bool verify(const Snapshot& graph) {
+    IncrementalCC ref;
+    ref.init(graph);
+    galois::GAccumulator<uint64_t> split;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode src) {
+          for (auto e : graph.edges(src))
+            if (nodes[src].find() != nodes[graph.getEdgeDst(e)].find())
+              split += 1;
+        },
+        galois::steal(), galois::no_stats(), galois::loopname("CC_Verify"));
+    return split.reduce() == 0 && ref.numComponents == numComponents;
+  }
+
+  void report() const {
+    std::cout << "Number of components is " << numComponents << "\n";
+  }
+};
+
+/**
+ * BFS levels from the source. An inserted edge can only shorten distances,
+ * so a batch relaxes the heads of edges that improved and propagates from
+ * there; untouched parts of the graph are not visited.
+ */
+struct IncrementalBFS {
+  constexpr static const uint32_t DIST_INFINITY =
+      std::numeric_limits<uint32_t>::max() - 1;
+
+  galois::LargeArray<std::atomic<uint32_t>> dist;
+  GNode source = 0;
+
+  template <typename Range>
+  void relax(const Snapshot& graph, const Range& active) {
+    typedef galois::worklists::PerSocketChunkFIFO<CHUNK_SIZE> WL;
+    galois::for_each(
+        active,
+        [&](GNode src, auto& ctx) {
+          uint32_t newDist = dist[src] + 1;
+          for (auto e : graph.edges(src)) {
+            GNode dst = graph.getEdgeDst(e);
+            if (galois::atomicMin(dist[dst], newDist) > newDist)
+              ctx.push(dst);
+          }
+        },
+        galois::wl<WL>(), galois::disable_conflict_detection(),
+        galois::no_stats(), galois::loopname("BFS_Relax"));
+  }
+
+  void init(const Snapshot& graph, GNode s) {
+    source = s;
+    dist.create(graph.size(), DIST_INFINITY);
+    dist[source] = 0;
+    relax(graph, galois::iterate({source}));
+  }
+
+  void update(const Snapshot&, const Snapshot& next, StreamIter begin,
+              StreamIter end) {
+    galois::InsertBag<GNode> active;
+    galois::do_all(
+        galois::iterate(begin, end),
+        [&](const StreamEdge& e) {
+          uint32_t srcDist = dist[e.src];
+          if (srcDist != DIST_INFINITY &&
+              galois::atomicMin(dist[e.dst], srcDist + 1) > srcDist + 1)
+            active.push(e.dst);
+        },
+        galois::no_stats(), galois::loopname("BFS_Update"));
+    relax(next, galois::iterate(active));
+  }
+
+  bool verify(const Snapshot& graph) {
+    IncrementalBFS ref;
+    ref.init(graph, source);
+    galois::GAccumulator<uint64_t> wrong;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) {
+          if (dist[n] != ref.dist[n])
+            wrong += 1;
+        },
+        galois::no_stats(), galois::loopname("BFS_Verify"));
+    return wrong.reduce() == 0;
+  }
+
+  void report() const {
+    uint64_t reached = 0;
+    uint32_t maxDist = 0;
+    for (size_t n = 0; n < dist.size(); ++n) {
+      if (dist[n] != DIST_INFINITY) {
+        ++reached;
+        maxDist = std::max<uint32_t>(maxDist, dist[n]);
+      }
+    }
+    std::cout << "BFS reached " << reached << " nodes, max distance "
+              << maxDist << "\n";
+  }
+};
+
+/**
+ * Residual-push PageRank (Whang et al., Europar 2015) that keeps the
+ * invariant value + residual = (1 - alpha) + alpha * sum of value/outdegree
+ * over in-neighbors. Changing the out-edges of a node only breaks the
+ * invariant at its old and new neighbors, so a batch adjusts their residuals
+ * and pushes from the nodes whose residual exceeds the tolerance. Residuals
+ * may become negative.
+ */
+struct IncrementalPageRank {
+  typedef float PRTy;
+  constexpr static const PRTy ALPHA         = 0.85;
+  constexpr static const PRTy INIT_RESIDUAL = 1 - ALPHA;
+
+  galois::LargeArray<std::atomic<PRTy>> value;
+  galois::LargeArray<std::atomic<PRTy>> residual;
+
+  template <typename Range>
+  void push(const Snapshot& graph, const Range& active) {
+    typedef galois::worklists::PerSocketChunkFIFO<CHUNK_SIZE> WL;
+    galois::for_each(
+        active,
+        [&](GNode src, auto& ctx) {
+          if (std::fabs(residual[src].load()) <= tolerance)
+            return;
+          PRTy r = residual[src].exchange(0.0);
+          galois::atomicAdd(value[src], r);
+          uint64_t degree = graph.getDegree(src);
+          if (degree == 0)
+            return;
+          PRTy delta = r * ALPHA / degree;
+          for (auto e : graph.edges(src)) {
+            GNode dst = graph.getEdgeDst(e);
+            PRTy old  = galois::atomicAdd(residual[dst], delta);
+            if (std::fabs(old) <= tolerance &&
+                std::fabs(old + delta) > tolerance)
+              ctx.push(dst);
+          }
+        },
+        galois::wl<WL>(), galois::disable_conflict_detection(),
+        galois::no_stats(), galois::loopname("PageRank_Push"));
+  }
+
+  void init(const Snapshot& graph) {
+    value.create(graph.size(), 0.0);
+    residual.create(graph.size(), INIT_RESIDUAL);
+    push(graph, galois::iterate(graph.begin(), graph.end()));
+  }
+
+  void update(const Snapshot& prev, const Snapshot& next, StreamIter begin,
+              StreamIter end) {
+    std::vector<GNode> sources;
+    sources.reserve(std::distance(begin, end));
+    for (StreamIter ii = begin; ii != end; ++ii)
+      sources.push_back(ii->src);
+    galois::ParallelSTL::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+    galois::InsertBag<GNode> active;
+    auto adjust = [&](GNode dst, PRTy delta) {
+      PRTy old = galois::atomicAdd(residual[dst], delta);
+      if (std::fabs(old) <= tolerance && std::fabs(old + delta) > tolerance)
+        active.push(dst);
+    };
+
+    // Move the contribution of each source from its old to its new out-edges
+    galois::do_all(
+        galois::iterate(sources),
+        [&](GNode src) {
+          PRTy x = value[src];
+          if (x == 0)
+            return;
+          if (uint64_t degree = prev.getDegree(src)) {
+            for (auto e : prev.edges(src))
+              adjust(prev.getEdgeDst(e), -x * ALPHA / degree);
+          }
+          if (uint64_t degree = next.getDegree(src)) {
+            for (auto e : next.edges(src))
+              adjust(next.getEdgeDst(e), x * ALPHA / degree);
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("PageRank_Update"));
+    push(next, galois::iterate(active));
+  }
+
+  //! Values are within a few tolerances of a recomputation
+  bool verify(const Snapshot& graph) {
+    IncrementalPageRank ref;
+    ref.init(graph);
+    galois::GReduceMax<PRTy> maxError;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) { maxError.update(std::fabs(value[n] - ref.value[n])); },
+        galois::no_stats(), galois::loopname("PageRank_Verify"));
+    PRTy error = maxError.reduce();
+    std::cout << "PageRank max difference from recomputation is " << error
+              << "\n";
+    return error <= 10 * tolerance / (1 - ALPHA);
+  }
+
+  void report() const {
+    GNode top = 0;
+    for (size_t n = 1; n < value.size(); ++n)
+      if (value[n] > value[top])
+        top = n;
+    if (value.size())
+      std::cout << "Highest PageRank is node " << top << " with "
+                << value[top] << "\n";
+  }
+};
+
+std::vector<StreamEdge> readStream(const std::string& filename,
+                                   size_t numNodes) {
+  std::ifstream in(filename);
+  if (!in)
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+  std::vector<StreamEdge> stream;
+  std::string line;
+  for (uint64_t lineNo = 1; std::getline(in, line); ++lineNo) {
+    if (line.empty() || line[0] == '#' || line[0] == '%')
+      continue;
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream fields(line);
+    uint64_t src, dst, time;
+    if (!(fields >> src >> dst))
+      GALOIS_DIE("malformed stream line ", lineNo, " in ", filename);
+    if (!(fields >> time))
+      time = lineNo;
+    if (src >= numNodes || dst >= numNodes)
+      GALOIS_DIE("stream edge on line ", lineNo, " is out of range");
+    stream.push_back(StreamEdge{GNode(src), GNode(dst), time});
+  }
+
+  std::stable_sort(
+      stream.begin(), stream.end(),
+      [](const StreamEdge& a, const StreamEdge& b) { return a.time < b.time; });
+  return stream;
+}
+
+//! Start offsets of the batches in the stream, followed by its size
+std::vector<size_t> splitBatches(const std::vector<StreamEdge>& stream) {
+  std::vector<size_t> bounds;
+  for (size_t i = 0; i < stream.size();) {
+    bounds.push_back(i);
+    if (batchTime) {
+      uint64_t last = stream[i].time + batchTime;
+      while (i < stream.size() && stream[i].time < last)
+        ++i;
+    } else {
+      i = std::min<size_t>(i + std::max(1u, unsigned(batchSize)),
+                           stream.size());
+    }
+  }
+  bounds.push_back(stream.size());
+  return bounds;
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  Graph graph;
+  galois::graphs::readGraph(graph, inputFile);
+  graph.setCompactionRatio(compactionRatio);
+  Snapshot current = graph.snapshot();
+  std::cout << "Read " << current.size() << " nodes, " << current.sizeEdges()
+            << " edges\n";
+
+  if (startNode >= current.size()) {
+    std::cerr << "failed to set source: " << startNode << "\n";
+    abort();
+  }
+
+  std::vector<StreamEdge> stream = readStream(streamFile, current.size());
+  std::vector<size_t> bounds     = splitBatches(stream);
+  std::cout << "Replaying " << stream.size() << " edges in "
+            << bounds.size() - 1 << " batches\n";
+
+  bool runCC       = algo == CC || algo == All;
+  bool runBFS      = algo == BFS || algo == All;
+  bool runPageRank = algo == PageRank || algo == All;
+
+  IncrementalCC cc;
+  IncrementalBFS bfs;
+  IncrementalPageRank pageRank;
+
+  galois::StatTimer initTime("TimerInit");
+  initTime.start();
+  if (runCC)
+    cc.init(current);
+  if (runBFS)
+    bfs.init(current, startNode);
+  if (runPageRank)
+    pageRank.init(current);
+  initTime.stop();
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+
+  uint64_t maxLatency   = 0;
+  uint64_t totalLatency = 0;
+  for (size_t b = 0; b + 1 < bounds.size(); ++b) {
+    StreamIter begin = stream.begin() + bounds[b];
+    StreamIter end   = stream.begin() + bounds[b + 1];
+
+    galois::Timer batchTimer, applyTimer, ccTimer, bfsTimer, prTimer;
+    batchTimer.start();
+
+    applyTimer.start();
+    galois::do_all(
+        galois::iterate(begin, end),
+        [&](const StreamEdge& e) { graph.insertEdge(e.src, e.dst); },
+        galois::no_stats(), galois::loopname("QueueInserts"));
+    graph.applyUpdates();
+    Snapshot next = graph.snapshot();
+    applyTimer.stop();
+
+    if (runCC) {
+      ccTimer.start();
+      cc.update(current, next, begin, end);
+      ccTimer.stop();
+    }
+    if (runBFS) {
+      bfsTimer.start();
+      bfs.update(current, next, begin, end);
+      bfsTimer.stop();
+    }
+    if (runPageRank) {
+      prTimer.start();
+      pageRank.update(current, next, begin, end);
+      prTimer.stop();
+    }
+    current = next;
+
+    batchTimer.stop();
+    maxLatency = std::max(maxLatency, batchTimer.get_usec());
+    totalLatency += batchTimer.get_usec();
+
+    std::cout << "Batch " << b << ": " << std::distance(begin, end)
+              << " edges, latency " << batchTimer.get_usec() / 1000.0
+              << " ms (apply " << applyTimer.get_usec() / 1000.0;
+    if (runCC)
+      std::cout << ", cc " << ccTimer.get_usec() / 1000.0;
+    if (runBFS)
+      std::cout << ", bfs " << bfsTimer.get_usec() / 1000.0;
+    if (runPageRank)
+      std::cout << ", pagerank " << prTimer.get_usec() / 1000.0;
+    std::cout << ")\n";
+  }
+
+  execTime.stop();
+
+  size_t numBatches = bounds.size() - 1;
+  galois::runtime::reportStat_Single("Incremental", "Batches", numBatches);
+  galois::runtime::reportStat_Single("Incremental", "BatchLatencyMaxUsec",
+                                     maxLatency);
+  galois::runtime::reportStat_Single(
+      "Incremental", "BatchLatencyAvgUsec",
+      numBatches ? totalLatency / numBatches : 0);
+
+  if (runCC)
+    cc.report();
+  if (runBFS)
+    bfs.report();
+  if (runPageRank)
+    pageRank.report();
+
+  if (!skipVerify) {
+    bool ok = true;
+    if (runCC && !cc.verify(current)) {
+      std::cerr << "Components differ from recomputation\n";
+      ok = false;
+    }
+    if (runBFS && !bfs.verify(current)) {
+      std::cerr << "BFS levels differ from recomputation\n";
+      ok = false;
+    }
+    if (runPageRank && !pageRank.verify(current)) {
+      std::cerr << "PageRank differs from recomputation\n";
+      ok = false;
+    }
+    if (!ok)
+      GALOIS_DIE("verification failed");
+    std::cout << "Verification successful.\n";
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -19,11 +19,13 @@
 
 #include "galois/Galois.h"
 #include "galois/Reduction.h"
+#include "galois/SetIntersection.h"
 #include "galois/Bag.h"
 #include "galois/Timer.h"
 #include "galois/graphs/Graph.h"
 #include "galois/graphs/TypeTraits.h"
 #include "galois/runtime/Statistics.h"
+#include "galois/substrate/PerThreadStorage.h"
 #include "Lonestar/BoilerPlate.h"
 
 #include "llvm/Support/CommandLine.h"
@@ -81,6 +83,14 @@ using PerIterAlloc = typename galois::PerIterAllocTy::rebind<T>::other;
 static const uint32_t valid   = 0x0;
 static const uint32_t removed = 0x1;
 
+//! Scratch space for the positions of common neighbors in each edge list
+struct CommonPositions {
+  std::vector<uint32_t> src;
+  std::vector<uint32_t> dst;
+};
+
+using PerThreadPositions = galois::substrate::PerThreadStorage<CommonPositions>;
+
 #if 0 ///< Deprecated codes.
 ///< TODO We can restore the asynchronous ktruss.
 
@@ -341,42 +351,43 @@ bool isValidDegreeNoLessThanJ(Graph& g, GNode n, unsigned int j) {
  * @param src the source node
  * @param dst the destination node
  * @param j the number of the target triangles
+ * @param pos scratch space for the calling thread
  *
  * @return true if the src and the dst are included in more than j triangles
  */
-bool isSupportNoLessThanJ(Graph& g, GNode src, GNode dst, unsigned int j) {
-  size_t numValidEqual = 0;
-  auto srcI            = g.edge_begin(src, galois::MethodFlag::UNPROTECTED),
-       srcE            = g.edge_end(src, galois::MethodFlag::UNPROTECTED),
-       dstI            = g.edge_begin(dst, galois::MethodFlag::UNPROTECTED),
-       dstE            = g.edge_end(dst, galois::MethodFlag::UNPROTECTED);
-
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.getEdgeData(srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.getEdgeData(dstI) & removed)) {
-      ++dstI;
-    }
+bool isSupportNoLessThanJ(Graph& g, GNode src, GNode dst, unsigned int j,
+                          CommonPositions& pos) {
+  auto srcI = g.edge_begin(src, galois::MethodFlag::UNPROTECTED),
+       srcE = g.edge_end(src, galois::MethodFlag::UNPROTECTED),
+       dstI = g.edge_begin(dst, galois::MethodFlag::UNPROTECTED),
+       dstE = g.edge_end(dst, galois::MethodFlag::UNPROTECTED);
+  size_t srcDegree = std::distance(srcI, srcE);
+  size_t dstDegree = std::distance(dstI, dstE);
+  if (std::min(srcDegree, dstDegree) < j) {
+    return false;
+  }
 
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
+  //! Intersect all neighbors, then drop common ones where either edge is
+  //! removed.
+  if (pos.src.size() < std::min(srcDegree, dstDegree)) {
+    pos.src.resize(std::min(srcDegree, dstDegree));
+    pos.dst.resize(std::min(srcDegree, dstDegree));
+  }
+  size_t numEqual = galois::intersectPositions(
+      g.getEdgeDstPtr(srcI), srcDegree, g.getEdgeDstPtr(dstI), dstDegree,
+      pos.src.data(), pos.dst.data());
+  if (numEqual < j) {
+    return false;
+  }
 
-    //! Check for intersection.
-    auto sN = g.getEdgeDst(srcI), dN = g.getEdgeDst(dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
+  size_t numValidEqual = 0;
+  for (size_t i = 0; i < numEqual; ++i) {
+    if (!(g.getEdgeData(srcI + pos.src[i]) & removed) &&
+        !(g.getEdgeData(dstI + pos.dst[i]) & removed)) {
       numValidEqual += 1;
       if (numValidEqual >= j) {
         return true;
       }
-      ++srcI;
-      ++dstI;
     }
   }
 
@@ -399,12 +410,17 @@ struct BSPTrussJacobiAlgo {
     unsigned int j;
     EdgeVec& r; ///< unsupported
     EdgeVec& s; ///< next
+    PerThreadPositions& positions;
 
-    PickUnsupportedEdges(Graph& g, unsigned int j, EdgeVec& r, EdgeVec& s)
-        : g(g), j(j), r(r), s(s) {}
+    PickUnsupportedEdges(Graph& g, unsigned int j, EdgeVec& r, EdgeVec& s,
+                         PerThreadPositions& positions)
+        : g(g), j(j), r(r), s(s), positions(positions) {}
 
     void operator()(Edge e) {
-      EdgeVec& w = isSupportNoLessThanJ(g, e.first, e.second, j) ? s : r;
+      EdgeVec& w = isSupportNoLessThanJ(g, e.first, e.second, j,
+                                        *positions.getLocal())
+                       ? s
+                       : r;
       w.push_back(e);
     }
   };
@@ -416,6 +432,7 @@ struct BSPTrussJacobiAlgo {
 
     EdgeVec unsupported, work[2];
     EdgeVec *cur = &work[0], *next = &work[1];
+    PerThreadPositions positions;
 
     //! Symmetry breaking:
     //! Consider only edges (i, j) where i < j.
@@ -433,7 +450,8 @@ struct BSPTrussJacobiAlgo {
 
     while (true) {
       galois::do_all(galois::iterate(*cur),
-                     PickUnsupportedEdges{g, k - 2, unsupported, *next},
+                     PickUnsupportedEdges{g, k - 2, unsupported, *next,
+                                          positions},
                      galois::steal());
 
       if (std::distance(unsupported.begin(), unsupported.end()) == 0) {
@@ -469,12 +487,15 @@ struct BSPTrussAlgo {
     Graph& g;
     unsigned int j;
     EdgeVec& s;
+    PerThreadPositions& positions;
 
-    KeepSupportedEdges(Graph& g, unsigned int j, EdgeVec& s)
-        : g(g), j(j), s(s) {}
+    KeepSupportedEdges(Graph& g, unsigned int j, EdgeVec& s,
+                       PerThreadPositions& positions)
+        : g(g), j(j), s(s), positions(positions) {}
 
     void operator()(Edge e) {
-      if (isSupportNoLessThanJ(g, e.first, e.second, j)) {
+      if (isSupportNoLessThanJ(g, e.first, e.second, j,
+                               *positions.getLocal())) {
         s.push_back(e);
       } else {
         g.getEdgeData(g.findEdgeSortedByDst(e.first, e.second)) = removed;
@@ -491,6 +512,7 @@ struct BSPTrussAlgo {
     EdgeVec work[2];
     EdgeVec *cur = &work[0], *next = &work[1];
     size_t curSize, nextSize;
+    PerThreadPositions positions;
 
     //! Symmetry breaking:
     //! Consider only edges (i, j) where i < j.
@@ -509,7 +531,8 @@ struct BSPTrussAlgo {
 
     //! Remove unsupported edges until no more edges can be removed.
     while (true) {
-      galois::do_all(galois::iterate(*cur), KeepSupportedEdges{g, k - 2, *next},
+      galois::do_all(galois::iterate(*cur),
+                     KeepSupportedEdges{g, k - 2, *next, positions},
                      galois::steal());
       nextSize = std::distance(next->begin(), next->end());
 
@@ -0,0 +1,525 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/AtomicHelpers.h"
+#include "galois/DynamicBitset.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/graphs/OCGraph.h"
+#include "galois/graphs/ReadGraph.h"
+#include "Lonestar/BoilerPlate.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace cll = llvm::cl;
+
+static const char* name = "Out-of-core Analytics";
+
+static const char* desc =
+    "Runs BFS, connected components or PageRank on a graph whose edges stay "
+    "on disk: node data is kept in memory and edges are streamed in "
+    "segments, skipping segments without active nodes";
+
+static const char* url = nullptr;
+
+enum Algo { BFS, CC, PageRank };
+
+static cll::opt<std::string>
+    inputFile(cll::Positional, cll::desc("<input file>"), cll::Required);
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm (default value BFS):"),
+    cll::values(clEnumVal(BFS, "BFS levels from -startNode"),
+                clEnumVal(CC, "Connected components (symmetric graph)"),
+                clEnumVal(PageRank, "Residual PageRank")),
+    cll::init(BFS));
+static cll::opt<uint64_t> segmentEdges(
+    "segmentEdges",
+    cll::desc("Approximate number of edges per segment; two segments are in "
+              "memory at a time (default value 2^25)"),
+    cll::init(uint64_t(1) << 25));
+static cll::opt<unsigned int>
+    startNode("startNode",
+              cll::desc("Node to start search from (default value 0)"),
+              cll::init(0));
+static cll::opt<float> tolerance("tolerance",
+                                 cll::desc("PageRank tolerance (default value "
+                                           "0.001)"),
+                                 cll::init(1.0e-3));
+static cll::opt<unsigned int>
+    maxIterations("maxIterations",
+                  cll::desc("Maximum PageRank rounds (default value 1000)"),
+                  cll::init(1000));
+
+using Graph   = galois::graphs::OCImmutableEdgeGraph<void, void, true>;
+using Segment = Graph::segment_type;
+using GNode   = Graph::GraphNode;
+using SegmentGraph = galois::graphs::BindSegmentGraph<Graph>;
+
+constexpr static const float ALPHA         = 0.85;
+constexpr static const float INIT_RESIDUAL = 1 - ALPHA;
+
+/**
+ * Segment-aware round scheduling. Algorithms mark the segments that hold
+ * nodes with work for the next round; a round streams only the marked
+ * segments, in file order, so the reads stay sequential and segments
+ * without work are never read.
+ */
+class SegmentScheduler {
+  Graph& graph;
+  std::vector<Segment> segments;
+  //! First node of each segment
+  std::vector<GNode> starts;
+  galois::DynamicBitSet next;
+  uint64_t loads   = 0;
+  uint64_t skipped = 0;
+  uint64_t rounds  = 0;
+
+public:
+  SegmentScheduler(Graph& g, size_t edges)
+      : graph(g), segments(galois::graphs::makeSegments(g, edges)) {
+    for (auto& s : segments)
+      starts.push_back(*graph.begin(s));
+    next.resize(segments.size());
+  }
+
+  size_t size() const { return segments.size(); }
+
+  size_t segmentOf(GNode n) const {
+    return std::upper_bound(starts.begin(), starts.end(), n) - starts.begin() -
+           1;
+  }
+
+  //! Schedules the segment holding n for the next round; thread safe
+  void activate(GNode n) {
+    size_t s = segmentOf(n);
+    if (!next.test(s))
+      next.set(s);
+  }
+
+  void activateAll() {
+    for (size_t s = 0; s < segments.size(); ++s)
+      next.set(s);
+  }
+
+  /**
+   * Runs one round: calls fn(segmentGraph, node range) on every scheduled
+   * segment while it is loaded. Returns false if nothing was scheduled.
+   */
+  template <typename Fn>
+  bool round(Fn fn) {
+    std::vector<Segment> active;
+    for (size_t s = 0; s < segments.size(); ++s)
+      if (next.test(s))
+        active.push_back(segments[s]);
+    next.reset();
+    if (active.empty())
+      return false;
+
+    ++rounds;
+    loads += active.size();
+    skipped += segments.size() - active.size();
+    galois::graphs::forEachSegment(
+        graph, active.begin(), active.end(), [&](Segment& seg) {
+          SegmentGraph sg(graph, seg);
+          fn(sg, galois::iterate(graph.begin(seg), graph.end(seg)));
+        });
+    return true;
+  }
+
+  //! Streams every segment once, e.g. for verification
+  template <typename Fn>
+  void all(Fn fn) {
+    galois::graphs::forEachSegment(
+        graph, segments.begin(), segments.end(), [&](Segment& seg) {
+          SegmentGraph sg(graph, seg);
+          fn(sg, galois::iterate(graph.begin(seg), graph.end(seg)));
+        });
+  }
+
+  void report(const char* region) const {
+    galois::runtime::reportStat_Single(region, "Rounds", rounds);
+    galois::runtime::reportStat_Single(region, "SegmentLoads", loads);
+    galois::runtime::reportStat_Single(region, "SegmentsSkipped", skipped);
+    std::cout << rounds << " rounds loaded " << loads << " segments and "
+              << "skipped " << skipped << "\n";
+  }
+};
+
+/**
+ * Level-synchronous push BFS. Round k expands the nodes at level k, so only
+ * segments that contain the current frontier are read.
+ */
+struct OutOfCoreBFS {
+  constexpr static const uint32_t DIST_INFINITY =
+      std::numeric_limits<uint32_t>::max() - 1;
+
+  galois::LargeArray<std::atomic<uint32_t>> dist;
+  GNode source;
+
+  void run(Graph& graph, SegmentScheduler& sched, GNode src) {
+    source = src;
+    dist.create(graph.size());
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) { dist[n] = DIST_INFINITY; }, galois::no_stats(),
+        galois::loopname("BFS_Init"));
+    dist[source] = 0;
+    sched.activate(source);
+
+    for (uint32_t level = 0;; ++level) {
+      bool any = sched.round([&](SegmentGraph& sg, auto nodes) {
+        galois::do_all(
+            nodes,
+            [&](GNode n) {
+              if (dist[n] != level)
+                return;
+              for (auto e : sg.edges(n, galois::MethodFlag::UNPROTECTED)) {
+                GNode dst = sg.getEdgeDst(e);
+                if (galois::atomicMin(dist[dst], level + 1) > level + 1)
+                  sched.activate(dst);
+              }
+            },
+            galois::steal(), galois::no_stats(), galois::loopname("BFS"));
+      });
+      if (!any)
+        break;
+    }
+  }
+
+  //! No edge shortcuts a level and the source is at level 0
+  bool verify(SegmentScheduler& sched) {
+    galois::GAccumulator<uint64_t> bad;
+    sched.all([&](SegmentGraph& sg, auto nodes) {
+      galois::do_all(
+          nodes,
+          [&](GNode n) {
+            if (dist[n] == DIST_INFINITY)
+              return;
+            for (auto e : sg.edges(n, galois::MethodFlag::UNPROTECTED))
+              if (dist[sg.getEdgeDst(e)] > dist[n] + 1)
+                bad += 1;
+          },
+          galois::no_stats(), galois::loopname("BFS_Verify"));
+    });
+    return dist[source] == 0 && bad.reduce() == 0;
+  }
+
+  void report(Graph& graph) {
+    galois::GAccumulator<uint64_t> reached;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) {
+          if (dist[n] != DIST_INFINITY)
+            reached += 1;
+        },
+        galois::no_stats());
+    std::cout << "Number of reached nodes = " << reached.reduce() << "\n";
+  }
+};
+
+/**
+ * Min-label propagation. A node pushes its label to its neighbors only in
+ * the round after its label dropped.
+ */
+struct OutOfCoreCC {
+  galois::LargeArray<std::atomic<uint32_t>> comp;
+  galois::DynamicBitSet changed;
+  galois::DynamicBitSet nextChanged;
+
+  void run(Graph& graph, SegmentScheduler& sched) {
+    comp.create(graph.size());
+    changed.resize(graph.size());
+    nextChanged.resize(graph.size());
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) {
+          comp[n] = n;
+          changed.set(n);
+        },
+        galois::no_stats(), galois::loopname("CC_Init"));
+    sched.activateAll();
+
+    while (true) {
+      bool any = sched.round([&](SegmentGraph& sg, auto nodes) {
+        galois::do_all(
+            nodes,
+            [&](GNode n) {
+              if (!changed.test(n))
+                return;
+              uint32_t label = comp[n];
+              for (auto e : sg.edges(n, galois::MethodFlag::UNPROTECTED)) {
+                GNode dst = sg.getEdgeDst(e);
+                if (galois::atomicMin(comp[dst], label) > label) {
+                  nextChanged.set(dst);
+                  sched.activate(dst);
+                }
+              }
+            },
+            galois::steal(), galois::no_stats(), galois::loopname("CC"));
+      });
+      if (!any)
+        break;
+      std::swap(changed, nextChanged);
+      nextChanged.reset();
+    }
+  }
+
+  //! Both endpoints of every edge share a component
+  bool verify(SegmentScheduler& sched) {
+    galois::GAccumulator<uint64_t> bad;
+    sched.all([&](SegmentGraph& sg, auto nodes) {
+      galois::do_all(
+          nodes,
+          [&](GNode n) {
+            for (auto e : sg.edges(n, galois::MethodFlag::UNPROTECTED))
+              if (comp[sg.getEdgeDst(e)] != comp[n])
+                bad += 1;
+          },
+          galois::no_stats(), galois::loopname("CC_Verify"));
+    });
+    return bad.reduce() == 0;
+  }
+
+  void report(Graph& graph) {
+    galois::GAccumulator<uint64_t> components;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) {
+          if (comp[n] == n)
+            components += 1;
+        },
+        galois::no_stats());
+    std::cout << "Number of components = " << components.reduce() << "\n";
+  }
+};
+
+/**
+ * Residual push PageRank (as in PageRank-push). A node whose residual
+ * exceeds the tolerance folds it into its rank and spreads it over its
+ * out-neighbors; a segment is read again only once one of its residuals
+ * crosses the tolerance.
+ */
+struct OutOfCorePageRank {
+  galois::LargeArray<float> value;
+  galois::LargeArray<std::atomic<float>> residual;
+
+  void run(Graph& graph, SegmentScheduler& sched) {
+    value.create(graph.size());
+    residual.create(graph.size());
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) {
+          value[n]    = 0;
+          residual[n] = INIT_RESIDUAL;
+        },
+        galois::no_stats(), galois::loopname("PageRank_Init"));
+    if (INIT_RESIDUAL > tolerance)
+      sched.activateAll();
+
+    for (unsigned i = 0; i < maxIterations; ++i) {
+      bool any = sched.round([&](SegmentGraph& sg, auto nodes) {
+        galois::do_all(
+            nodes,
+            [&](GNode n) {
+              if (residual[n] <= tolerance)
+                return;
+              float r = residual[n].exchange(0);
+              value[n] += r;
+              auto begin = sg.edge_begin(n, galois::MethodFlag::UNPROTECTED);
+              auto end   = sg.edge_end(n, galois::MethodFlag::UNPROTECTED);
+              if (begin == end)
+                return;
+              float delta = r * ALPHA / std::distance(begin, end);
+              for (auto e = begin; e != end; ++e) {
+                GNode dst = sg.getEdgeDst(e);
+                float old = galois::atomicAdd(residual[dst], delta);
+                if (old <= tolerance && old + delta > tolerance)
+                  sched.activate(dst);
+              }
+            },
+            galois::steal(), galois::no_stats(), galois::loopname("PageRank"));
+      });
+      if (!any)
+        break;
+    }
+  }
+
+  /**
+   * Checks the ranks against a double precision power iteration that streams
+   * the segments. The exact ranks are value + (I - ALPHA P)^-1 residual, so
+   * their L1 distance from value is at most |residual|_1 / (1 - ALPHA); the
+   * reference runs until its own error is well below the float slack
+   * allowed on top of that.
+   */
+  bool verify(Graph& graph, SegmentScheduler& sched) {
+    galois::GAccumulator<uint64_t> bad;
+    galois::GAccumulator<double> left;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) {
+          if (residual[n] > tolerance || value[n] < 0)
+            bad += 1;
+          left += residual[n];
+        },
+        galois::no_stats(), galois::loopname("PageRank_Verify"));
+    if (bad.reduce())
+      return false;
+
+    galois::LargeArray<double> cur;
+    galois::LargeArray<std::atomic<double>> next;
+    cur.create(graph.size(), double(INIT_RESIDUAL));
+    next.create(graph.size());
+    const double slack = 1e-4 * graph.size();
+    galois::GAccumulator<double> change;
+    for (unsigned i = 0; i < maxIterations; ++i) {
+      galois::do_all(
+          galois::iterate(graph.begin(), graph.end()),
+          [&](GNode n) { next[n] = INIT_RESIDUAL; }, galois::no_stats());
+      sched.all([&](SegmentGraph& sg, auto nodes) {
+        galois::do_all(
+            nodes,
+            [&](GNode n) {
+              auto begin = sg.edge_begin(n, galois::MethodFlag::UNPROTECTED);
+              auto end   = sg.edge_end(n, galois::MethodFlag::UNPROTECTED);
+              if (begin == end)
+                return;
+              double share = ALPHA * cur[n] / std::distance(begin, end);
+              for (auto e = begin; e != end; ++e)
+                galois::atomicAdd(next[sg.getEdgeDst(e)], share);
+            },
+            galois::steal(), galois::no_stats(),
+            galois::loopname("PageRank_Reference"));
+      });
+      change.reset();
+      galois::do_all(
+          galois::iterate(graph.begin(), graph.end()),
+          [&](GNode n) {
+            change += std::fabs(next[n] - cur[n]);
+            cur[n] = next[n];
+          },
+          galois::no_stats());
+      if (change.reduce() * ALPHA / (1 - ALPHA) <= slack / 10)
+        break;
+    }
+
+    galois::GAccumulator<double> error;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) { error += std::fabs(value[n] - cur[n]); },
+        galois::no_stats());
+    double bound = left.reduce() / (1 - ALPHA) + slack;
+    std::cout << "L1 error = " << error.reduce() << " (bound " << bound
+              << ")\n";
+    return error.reduce() <= bound;
+  }
+
+  void report(Graph& graph) {
+    galois::GAccumulator<double> sum;
+    galois::do_all(
+        galois::iterate(graph.begin(), graph.end()),
+        [&](GNode n) { sum += value[n]; }, galois::no_stats());
+    std::cout << "Sum of ranks = " << sum.reduce() << "\n";
+  }
+};
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (algo == CC && !symmetricGraph) {
+    GALOIS_DIE("This application requires a symmetric graph input;"
+               " please use the -symmetricGraph flag "
+               " to indicate the input is a symmetric graph.");
+  }
+
+  Graph graph;
+  galois::graphs::readGraph(graph, inputFile);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges\n";
+
+  if (startNode >= graph.size()) {
+    std::cerr << "failed to set source: " << startNode << "\n";
+    abort();
+  }
+
+  SegmentScheduler sched(graph, segmentEdges);
+  std::cout << "Streaming edges in " << sched.size() << " segments\n";
+
+  OutOfCoreBFS bfs;
+  OutOfCoreCC cc;
+  OutOfCorePageRank pageRank;
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  switch (algo) {
+  case BFS:
+    bfs.run(graph, sched, startNode);
+    break;
+  case CC:
+    cc.run(graph, sched);
+    break;
+  case PageRank:
+    pageRank.run(graph, sched);
+    break;
+  default:
+    std::abort();
+  }
+  execTime.stop();
+
+  sched.report("OutOfCore");
+
+  bool ok = true;
+  switch (algo) {
+  case BFS:
+    bfs.report(graph);
+    ok = skipVerify || bfs.verify(sched);
+    break;
+  case CC:
+    cc.report(graph);
+    ok = skipVerify || cc.verify(sched);
+    break;
+  case PageRank:
+    pageRank.report(graph);
+    ok = skipVerify || pageRank.verify(graph, sched);
+    break;
+  default:
+    std::abort();
+  }
+  if (!ok)
+    GALOIS_DIE("verification failed");
+  if (!skipVerify)
+    std::cout << "Verification successful.\n";
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -20,7 +20,14 @@
 #ifndef LONESTAR_PAGERANK_CONSTANTS_H
 #define LONESTAR_PAGERANK_CONSTANTS_H
 
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 #define DEBUG 0
 
@@ -37,6 +44,9 @@ constexpr static const unsigned MAX_ITER = 1000;
 
 constexpr static const unsigned PRINT_TOP = 20;
 
+//! -convergence compares against ranks computed to this L1 change.
+constexpr static const double REFERENCE_TOLERANCE = 1.0e-10;
+
 namespace cll = llvm::cl;
 
 static cll::opt<std::string>
@@ -47,6 +57,12 @@ static cll::opt<unsigned int> maxIterations(
     "maxIterations",
     cll::desc("Maximum iterations, applies round-based versions only"),
     cll::init(MAX_ITER));
+static cll::opt<bool> convergence(
+    "convergence",
+    cll::desc("Also run every algorithm to tolerances 0.1, 0.01, ... down to "
+              "-tolerance and print its time against the L1 error of its "
+              "ranks (default false)"),
+    cll::init(false));
 
 //! Type definitions.
 typedef float PRTy;
@@ -67,16 +83,22 @@ struct TopPair {
 
 //! Helper functions.
 
-PRTy atomicAdd(std::atomic<PRTy>& v, PRTy delta) {
-  PRTy old;
+template <typename T>
+T atomicAdd(std::atomic<T>& v, T delta) {
+  T old;
   do {
     old = v;
   } while (!v.compare_exchange_strong(old, old + delta));
   return old;
 }
 
+//! Prints the highest ranked nodes; perm maps ids back to the input order
+//! when the graph was reordered.
 template <typename Graph>
-void printTop(Graph& graph, unsigned topn = PRINT_TOP) {
+void printTop(Graph& graph,
+              const galois::graphs::NodePermutation& perm =
+                  galois::graphs::NodePermutation(),
+              unsigned topn = PRINT_TOP) {
 
   using GNode = typename Graph::GraphNode;
   typedef TopPair<GNode> Pair;
@@ -88,7 +110,7 @@ void printTop(Graph& graph, unsigned topn = PRINT_TOP) {
     GNode src  = *ii;
     auto& n    = graph.getData(src);
     PRTy value = n.value;
-    Pair key(value, src);
+    Pair key(value, perm.oldId(src));
 
     if (top.size() < topn) {
       top.insert(std::make_pair(key, src));
@@ -108,6 +130,145 @@ void printTop(Graph& graph, unsigned topn = PRINT_TOP) {
   }
 }
 
+/**
+ * Computes the PageRank of every node to REFERENCE_TOLERANCE in double
+ * precision, normalized so that the ranks of a graph without sinks sum to 1.
+ * The ranks of the residual algorithms are the same fixed point scaled by the
+ * number of nodes. Set transposed when graph holds the in-edges of the input.
+ * Given a source, computes the PageRank personalized to it instead, which
+ * teleports to the source only and sums to 1 without sinks.
+ */
+template <typename Graph>
+galois::LargeArray<double> referencePageRank(Graph& graph, bool transposed,
+                                             int64_t source = -1) {
+  using GNode                       = typename Graph::GraphNode;
+  constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  galois::LargeArray<std::atomic<uint32_t>> nout;
+  galois::LargeArray<std::atomic<double>> next;
+  galois::LargeArray<double> cur;
+  nout.allocateInterleaved(graph.size());
+  next.allocateInterleaved(graph.size());
+  cur.allocateInterleaved(graph.size());
+
+  auto base = [&](const GNode& n) {
+    if (source < 0)
+      return (1.0 - ALPHA) / graph.size();
+    return n == GNode(source) ? 1.0 - ALPHA : 0.0;
+  };
+  galois::do_all(
+      galois::iterate(graph),
+      [&](const GNode& src) {
+        nout.constructAt(src, transposed ? 0u
+                                         : std::distance(
+                                               graph.edge_begin(src, flag),
+                                               graph.edge_end(src, flag)));
+        next.constructAt(src, 0.0);
+        cur[src] = 1.0 / graph.size();
+      },
+      galois::no_stats());
+  if (transposed) {
+    galois::do_all(
+        galois::iterate(graph),
+        [&](const GNode& src) {
+          for (auto e : graph.edges(src, flag))
+            nout[graph.getEdgeDst(e)].fetch_add(1u);
+        },
+        galois::steal(), galois::no_stats());
+  }
+
+  galois::GAccumulator<double> change;
+  for (unsigned iter = 0; iter < MAX_ITER; ++iter) {
+    if (transposed) {
+      galois::do_all(
+          galois::iterate(graph),
+          [&](const GNode& src) {
+            double sum = 0;
+            for (auto e : graph.edges(src, flag)) {
+              GNode dst = graph.getEdgeDst(e);
+              sum += cur[dst] / nout[dst];
+            }
+            next[src] = base(src) + ALPHA * sum;
+          },
+          galois::steal(), galois::no_stats());
+    } else {
+      galois::do_all(
+          galois::iterate(graph),
+          [&](const GNode& src) { next[src] = base(src); }, galois::no_stats());
+      galois::do_all(
+          galois::iterate(graph),
+          [&](const GNode& src) {
+            if (nout[src] == 0)
+              return;
+            double share = ALPHA * cur[src] / nout[src];
+            for (auto e : graph.edges(src, flag))
+              atomicAdd(next[graph.getEdgeDst(e)], share);
+          },
+          galois::steal(), galois::no_stats());
+    }
+
+    change.reset();
+    galois::do_all(
+        galois::iterate(graph),
+        [&](const GNode& src) {
+          change += std::fabs(next[src] - cur[src]);
+          cur[src] = next[src];
+        },
+        galois::no_stats());
+    if (change.reduce() <= REFERENCE_TOLERANCE)
+      break;
+  }
+  return cur;
+}
+
+//! L1 distance between the ranks of graph, multiplied by scale, and ref.
+template <typename Graph>
+double l1Error(Graph& graph, const galois::LargeArray<double>& ref,
+               double scale) {
+  galois::GAccumulator<double> error;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](const typename Graph::GraphNode& src) {
+        PRTy value = graph.getData(src, galois::MethodFlag::UNPROTECTED).value;
+        error += std::fabs(scale * value - ref[src]);
+      },
+      galois::no_stats());
+  return error.reduce();
+}
+
+/**
+ * Runs each algorithm to the -convergence tolerances and prints one line per
+ * run, so that the lines of an algorithm trace its time against L1 error
+ * curve. run(algo, timer) resets the ranks, runs algo to the current
+ * tolerance under timer and returns the factor that normalizes its ranks (see
+ * referencePageRank); names[algo] labels its lines.
+ */
+template <typename Graph, typename Algo, typename RunFn>
+void printConvergence(Graph& graph, bool transposed,
+                      const std::vector<Algo>& algos,
+                      const char* const names[], RunFn run) {
+  galois::LargeArray<double> ref = referencePageRank(graph, transposed);
+
+  std::vector<float> tolerances;
+  for (float t = 0.1; t > tolerance; t /= 10)
+    tolerances.push_back(t);
+  tolerances.push_back(tolerance);
+
+  const float target = tolerance;
+  std::cout << "CONVERGENCE, Algo, Tolerance, TimeMs, L1Error\n";
+  for (Algo a : algos) {
+    for (float t : tolerances) {
+      tolerance = t;
+      galois::Timer timer;
+      double scale = run(a, timer);
+      std::cout << "CONVERGENCE, " << names[a] << ", " << t << ", "
+                << timer.get_usec() / 1000.0 << ", "
+                << l1Error(graph, ref, scale) << "\n";
+    }
+  }
+  tolerance = target;
+}
+
 #if DEBUG
 template <typename Graph>
 void printPageRank(Graph& graph) {
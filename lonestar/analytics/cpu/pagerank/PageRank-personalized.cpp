@@ -0,0 +1,510 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "Lonestar/BoilerPlate.h"
+#include "PageRank-constants.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/SimpleLock.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+/**
+ * Personalized PageRank (PPR) of a batch of sources at once, by forward push
+ * optionally followed by Monte-Carlo walks from the residual left over, as in
+ *
+ * Sibo Wang, Renchi Yang, Xiaokui Xiao, Zhewei Wei, Yin Yang. FORA: Simple
+ * and Effective Approximate Single-Source Personalized PageRank. KDD 2017.
+ *
+ * The push is the residual push of PageRank-push.cpp with a residual and an
+ * estimate per source: every node holds one lane per source of the batch, so
+ * a node is visited and its edges are read once for all the sources whose
+ * residual at the node is above the threshold, and the lanes are updated by
+ * vector loops. Only the top-k entries of each vector are kept.
+ */
+
+const char* desc = "Computes personalized page ranks of many sources in "
+                   "batches with forward push and Monte-Carlo walks.";
+
+constexpr static const unsigned CHUNK_SIZE = 16;
+
+enum Algo { Push, PushMC };
+
+const char* const ALGO_NAMES[] = {"Push", "PushMC"};
+
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(clEnumVal(Push, "Push: forward push to the tolerance"),
+                clEnumVal(PushMC, "PushMC: forward push, then random walks "
+                                  "from the residual left over (FORA)")),
+    cll::init(Push));
+
+static cll::opt<std::string>
+    sourcesToUse("sourcesToUse",
+                 cll::desc("Whitespace separated list of sources in a file "
+                           "(default nodes 0, 1, ...)"),
+                 cll::init(""));
+static cll::opt<unsigned int>
+    numOfSources("numOfSources",
+                 cll::desc("Number of sources (default 64, 0 for all)"),
+                 cll::init(64));
+static cll::opt<unsigned int>
+    batchWidth("batchWidth",
+               cll::desc("Sources per traversal: 1, 2, 4, 8, 16, 32 or 64 "
+                         "(default 16)"),
+               cll::init(16));
+static cll::opt<unsigned int>
+    topK("topK", cll::desc("Entries kept per source (default 100)"),
+         cll::init(100));
+static cll::opt<double> walksPerUnit(
+    "walks",
+    cll::desc("PushMC: walks per unit of left over residual (default 1000)"),
+    cll::init(1000));
+static cll::opt<unsigned int>
+    seed("seed", cll::desc("PushMC: random seed (default 0)"), cll::init(0));
+static cll::opt<std::string>
+    outName("o", cll::desc("output file for the top-k entries, one "
+                           "\"source node value\" line per entry"));
+
+//! Nodes are locked while their lanes are updated; queued is set while the
+//! node is on the worklist.
+struct LNode {
+  galois::substrate::SimpleLock lock;
+  std::atomic<bool> queued;
+};
+
+typedef galois::graphs::LC_CSR_Graph<LNode, void>::with_numa_alloc<
+    true>::type ::with_no_lockable<true>::type Graph;
+typedef typename Graph::GraphNode GNode;
+
+//! One value per source of a batch.
+template <unsigned K>
+struct Lanes {
+  PRTy v[K];
+};
+
+template <unsigned K>
+using LaneArray = galois::LargeArray<Lanes<K>>;
+
+/**
+ * Top-k entries of the PPR vectors of the sources, stored like CSR: the
+ * entries of sources[i] are [offsets[i], offsets[i + 1]) of nodes and values,
+ * by decreasing value.
+ */
+struct TopKVectors {
+  std::vector<GNode> sources;
+  std::vector<uint64_t> offsets{0};
+  std::vector<GNode> nodes;
+  std::vector<PRTy> values;
+};
+
+uint32_t outDegree(Graph& graph, GNode n) {
+  constexpr const galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+  return std::distance(graph.edge_begin(n, flag), graph.edge_end(n, flag));
+}
+
+//! The residual of a lane at n is pushed once it exceeds this.
+PRTy pushThreshold(uint32_t nout) {
+  return tolerance * std::max(nout, uint32_t(1));
+}
+
+/**
+ * Forward push of every lane until no residual is above its node's
+ * threshold. A node takes the residual of all its lanes above the threshold
+ * at once; a node whose lane rises above the threshold is pushed on the
+ * worklist unless it is already on it. Only the range of lanes that were
+ * taken is added to the neighbors, which saves most of the memory traffic
+ * while the sources of a batch are still spreading through different parts
+ * of the graph.
+ */
+template <unsigned K>
+void forwardPush(Graph& graph, LaneArray<K>& residual, LaneArray<K>& estimate,
+                 const std::vector<GNode>& batch) {
+  typedef galois::worklists::PerSocketChunkFIFO<CHUNK_SIZE> WL;
+  constexpr const galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  for (GNode s : batch)
+    graph.getData(s, flag).queued = true;
+
+  galois::for_each(
+      galois::iterate(batch),
+      [&](GNode src, auto& ctx) {
+        LNode& sdata = graph.getData(src, flag);
+        sdata.queued = false;
+
+        uint32_t nout = outDegree(graph, src);
+        PRTy thr      = pushThreshold(nout);
+        Lanes<K> take;
+        //! Lanes [lo, hi) hold all the residual taken.
+        unsigned lo = K;
+        unsigned hi = 0;
+
+        sdata.lock.lock();
+        Lanes<K>& res = residual[src];
+        Lanes<K>& est = estimate[src];
+        for (unsigned k = 0; k < K; ++k) {
+          bool on   = res.v[k] > thr;
+          take.v[k] = on ? res.v[k] : 0;
+          res.v[k]  = on ? 0 : res.v[k];
+          est.v[k] += (1 - ALPHA) * take.v[k];
+          if (on) {
+            lo = std::min(lo, k);
+            hi = k + 1;
+          }
+        }
+        sdata.lock.unlock();
+
+        if (lo >= hi || nout == 0)
+          return;
+
+        for (unsigned k = lo; k < hi; ++k)
+          take.v[k] *= ALPHA / nout;
+
+        for (auto jj : graph.edges(src, flag)) {
+          GNode dst    = graph.getEdgeDst(jj);
+          LNode& ddata = graph.getData(dst, flag);
+          PRTy dthr    = pushThreshold(outDegree(graph, dst));
+          bool over    = false;
+
+          ddata.lock.lock();
+          Lanes<K>& dres = residual[dst];
+          for (unsigned k = lo; k < hi; ++k) {
+            dres.v[k] += take.v[k];
+            over |= dres.v[k] > dthr;
+          }
+          ddata.lock.unlock();
+
+          if (over && !ddata.queued && !ddata.queued.exchange(true))
+            ctx.push(dst);
+        }
+      },
+      galois::loopname("PPRPush"), galois::disable_conflict_detection(),
+      galois::no_stats(), galois::wl<WL>());
+}
+
+/**
+ * Spends the residual left over by the push on random walks: each lane of a
+ * node starts ceil(residual * walksPerUnit) walks that each carry an equal
+ * share of it. A walk stops with probability 1 - ALPHA at every step and adds
+ * its share to the estimate of the node it stops at; like the push, it loses
+ * its share at a node without out edges.
+ */
+template <unsigned K>
+uint64_t monteCarlo(Graph& graph, LaneArray<K>& residual,
+                    LaneArray<K>& estimate,
+                    galois::substrate::PerThreadStorage<std::mt19937>& gen) {
+  constexpr const galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+  galois::GAccumulator<uint64_t> walks;
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode start) {
+        std::mt19937& rng = *gen.getLocal();
+        std::uniform_real_distribution<PRTy> coin(0, 1);
+
+        for (unsigned k = 0; k < K; ++k) {
+          PRTy r = residual[start].v[k];
+          if (r <= 0)
+            continue;
+          residual[start].v[k] = 0;
+
+          uint64_t n = std::ceil(r * walksPerUnit);
+          PRTy share = r / n;
+          walks += n;
+          for (uint64_t w = 0; w < n; ++w) {
+            GNode cur = start;
+            bool lost = false;
+            while (coin(rng) < ALPHA) {
+              uint32_t nout = outDegree(graph, cur);
+              if (nout == 0) {
+                lost = true;
+                break;
+              }
+              std::uniform_int_distribution<uint32_t> pick(0, nout - 1);
+              cur = graph.getEdgeDst(graph.edge_begin(cur, flag) + pick(rng));
+            }
+            if (lost)
+              continue;
+
+            LNode& cdata = graph.getData(cur, flag);
+            cdata.lock.lock();
+            estimate[cur].v[k] += share;
+            cdata.lock.unlock();
+          }
+        }
+      },
+      galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+      galois::loopname("PPRWalks"), galois::no_stats());
+
+  return walks.reduce();
+}
+
+//! Appends the top-k entries of the first batch.size() lanes to out.
+template <unsigned K>
+void collectTopK(Graph& graph, LaneArray<K>& estimate,
+                 const std::vector<GNode>& batch, TopKVectors& out) {
+  typedef TopPair<GNode> Pair;
+  //! Min-heap order, so that the front is the entry to evict.
+  auto heapCmp = [](const Pair& lhs, const Pair& rhs) { return rhs < lhs; };
+  auto insert  = [&](std::vector<Pair>& heap, const Pair& p) {
+    if (heap.size() < topK) {
+      heap.push_back(p);
+      std::push_heap(heap.begin(), heap.end(), heapCmp);
+    } else if (heap.front() < p) {
+      std::pop_heap(heap.begin(), heap.end(), heapCmp);
+      heap.back() = p;
+      std::push_heap(heap.begin(), heap.end(), heapCmp);
+    }
+  };
+
+  const size_t lanes = batch.size();
+  galois::substrate::PerThreadStorage<std::vector<std::vector<Pair>>> heaps;
+  galois::on_each([&](unsigned, unsigned) { heaps.getLocal()->resize(lanes); });
+
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) {
+        auto& local = *heaps.getLocal();
+        for (size_t k = 0; k < lanes; ++k) {
+          PRTy value = estimate[n].v[k];
+          if (value > 0)
+            insert(local[k], Pair(value, n));
+        }
+      },
+      galois::no_stats(), galois::loopname("PPRTopK"));
+
+  for (size_t k = 0; k < lanes; ++k) {
+    std::vector<Pair> merged;
+    for (unsigned t = 0; t < galois::getActiveThreads(); ++t)
+      for (const Pair& p : (*heaps.getRemote(t))[k])
+        insert(merged, p);
+    std::sort_heap(merged.begin(), merged.end(), heapCmp);
+
+    out.sources.push_back(batch[k]);
+    for (const Pair& p : merged) {
+      out.nodes.push_back(p.id);
+      out.values.push_back(p.value);
+    }
+    out.offsets.push_back(out.nodes.size());
+  }
+}
+
+/**
+ * Checks the estimate of the first lane against the exact PPR of its source.
+ * A push leaves the L1 error at most the residual left over, since the exact
+ * vector is the estimate plus the PPR of the residual; the walks only bound
+ * it in expectation, so their error is reported but not checked.
+ */
+template <unsigned K>
+void verifyFirstLane(Graph& graph, LaneArray<K>& estimate, GNode source,
+                     PRTy leftOver) {
+  galois::LargeArray<double> ref = referencePageRank(graph, false, source);
+  galois::GAccumulator<double> error;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](GNode n) { error += std::fabs(estimate[n].v[0] - ref[n]); },
+      galois::no_stats());
+
+  double l1 = error.reduce();
+  galois::gInfo("L1 error of source ", source, " is ", l1, " (left over ",
+                leftOver, ")");
+  galois::runtime::reportStat_Single("PPR", "FirstSourceL1Error", l1);
+  //! float accumulation adds an error of about 1e-6 per unit of mass
+  if (algo == Push && l1 > leftOver + 1.0e-4)
+    GALOIS_DIE("PPR error ", l1, " exceeds the residual left over ", leftOver);
+}
+
+//! Computes the sources K at a time; execTime is paused while verifying.
+template <unsigned K>
+void runBatches(Graph& graph, const std::vector<GNode>& sources,
+                TopKVectors& out, galois::StatTimer& execTime) {
+  LaneArray<K> residual;
+  LaneArray<K> estimate;
+  residual.allocateInterleaved(graph.size());
+  estimate.allocateInterleaved(graph.size());
+
+  galois::substrate::PerThreadStorage<std::mt19937> gen;
+  galois::on_each(
+      [&](unsigned tid, unsigned) { gen.getLocal()->seed(seed + tid); });
+
+  uint64_t walks = 0;
+  for (size_t first = 0; first < sources.size(); first += K) {
+    std::vector<GNode> batch(sources.begin() + first,
+                             sources.begin() +
+                                 std::min(first + K, sources.size()));
+
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          graph.getData(n).queued = false;
+          for (unsigned k = 0; k < K; ++k) {
+            residual[n].v[k] = 0;
+            estimate[n].v[k] = 0;
+          }
+        },
+        galois::no_stats(), galois::loopname("PPRInit"));
+    for (size_t k = 0; k < batch.size(); ++k)
+      residual[batch[k]].v[k] = 1;
+
+    forwardPush(graph, residual, estimate, batch);
+
+    PRTy leftOver = 0;
+    if (first == 0 && !skipVerify) {
+      //! the sum is cheap next to the push, so it is left in the timing
+      galois::GAccumulator<PRTy> sum;
+      galois::do_all(
+          galois::iterate(graph), [&](GNode n) { sum += residual[n].v[0]; },
+          galois::no_stats());
+      leftOver = sum.reduce();
+    }
+
+    if (algo == PushMC)
+      walks += monteCarlo(graph, residual, estimate, gen);
+
+    if (first == 0 && !skipVerify) {
+      execTime.stop();
+      verifyFirstLane(graph, estimate, batch[0], leftOver);
+      execTime.start();
+    }
+
+    collectTopK(graph, estimate, batch, out);
+  }
+
+  galois::runtime::reportStat_Single("PPR", "Batches",
+                                     (sources.size() + K - 1) / K);
+  if (algo == PushMC)
+    galois::runtime::reportStat_Single("PPR", "Walks", walks);
+}
+
+void writeTopK(const TopKVectors& out) {
+  if (outName.empty())
+    return;
+
+  std::ofstream of(outName);
+  if (!of.is_open()) {
+    std::cerr << "Cannot open " << outName << " for output.\n";
+    return;
+  }
+  for (size_t i = 0; i < out.sources.size(); ++i)
+    for (uint64_t j = out.offsets[i]; j < out.offsets[i + 1]; ++j)
+      of << out.sources[i] << " " << out.nodes[j] << " " << out.values[j]
+         << "\n";
+  of.close();
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  if (topK == 0)
+    GALOIS_DIE("-topK must be at least 1");
+
+  galois::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  Graph graph;
+  galois::graphs::readGraph(graph, inputFile);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges\n";
+
+  if (convergence)
+    galois::gWarn("-convergence only applies to the global PageRank apps");
+
+  std::vector<GNode> sources;
+  if (sourcesToUse != "") {
+    std::ifstream sourceFile(sourcesToUse);
+    std::vector<uint64_t> t(std::istream_iterator<uint64_t>{sourceFile},
+                            std::istream_iterator<uint64_t>{});
+    for (uint64_t s : t) {
+      if (s >= graph.size())
+        GALOIS_DIE("source ", s, " is not a node of the graph");
+      sources.push_back(s);
+    }
+  } else {
+    for (GNode n = 0; n < graph.size(); ++n)
+      sources.push_back(n);
+  }
+  if (numOfSources && numOfSources < sources.size())
+    sources.resize(numOfSources);
+  if (sources.empty())
+    GALOIS_DIE("no sources to compute personalized page ranks of");
+
+  std::cout << "Running " << ALGO_NAMES[algo] << " for " << sources.size()
+            << " sources, " << batchWidth << " per batch, tolerance:"
+            << tolerance << "\n";
+
+  galois::preAlloc(5 * numThreads +
+                   (5 * graph.size() * sizeof(typename Graph::node_data_type)) /
+                       galois::runtime::pagePoolSize());
+  galois::reportPageAlloc("MeminfoPre");
+
+  TopKVectors out;
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  switch (batchWidth) {
+  case 1:
+    runBatches<1>(graph, sources, out, execTime);
+    break;
+  case 2:
+    runBatches<2>(graph, sources, out, execTime);
+    break;
+  case 4:
+    runBatches<4>(graph, sources, out, execTime);
+    break;
+  case 8:
+    runBatches<8>(graph, sources, out, execTime);
+    break;
+  case 16:
+    runBatches<16>(graph, sources, out, execTime);
+    break;
+  case 32:
+    runBatches<32>(graph, sources, out, execTime);
+    break;
+  case 64:
+    runBatches<64>(graph, sources, out, execTime);
+    break;
+  default:
+    GALOIS_DIE("unsupported -batchWidth ", batchWidth);
+  }
+  execTime.stop();
+
+  galois::reportPageAlloc("MeminfoPost");
+
+  if (!skipVerify) {
+    std::cout << "Rank PPR Id, source " << out.sources[0] << "\n";
+    for (uint64_t j = 0; j < std::min<uint64_t>(out.offsets[1], PRINT_TOP);
+         ++j)
+      std::cout << j + 1 << ": " << out.values[j] << " " << out.nodes[j]
+                << "\n";
+  }
+  writeTopK(out);
+
+  totalTime.stop();
+
+  return 0;
+}
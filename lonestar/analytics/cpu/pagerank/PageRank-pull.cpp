@@ -29,12 +29,17 @@
 const char* desc =
     "Computes page ranks a la Page and Brin. This is a pull-style algorithm.";
 
-enum Algo { Topo = 0, Residual };
+enum Algo { Topo = 0, Residual, GaussSeidel };
 
-static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
-                           cll::values(clEnumVal(Topo, "Topological"),
-                                       clEnumVal(Residual, "Residual")),
-                           cll::init(Residual));
+const char* const ALGO_NAMES[] = {"Topo", "Residual", "GaussSeidel"};
+
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(clEnumVal(Topo, "Topological"),
+                clEnumVal(Residual, "Residual"),
+                clEnumVal(GaussSeidel, "GaussSeidel: Topological that "
+                                       "updates the ranks in place")),
+    cll::init(Residual));
 
 //! Flag that forces user to be aware that they should be passing in a
 //! transposed graph.
@@ -43,6 +48,10 @@ static cll::opt<bool>
                     cll::desc("Specify that the input graph is transposed"),
                     cll::init(false));
 
+static cll::opt<galois::graphs::ReorderPolicy> reorderPolicy(
+    "reorder", cll::desc("Relabel nodes for locality (default none)"),
+    reorderPolicyValues(), cll::init(galois::graphs::ReorderPolicy::None));
+
 constexpr static const unsigned CHUNK_SIZE = 32;
 
 struct LNode {
@@ -54,8 +63,9 @@ typedef galois::graphs::LC_CSR_Graph<LNode, void>::with_no_lockable<
     true>::type ::with_numa_alloc<true>::type Graph;
 typedef typename Graph::GraphNode GNode;
 
-using DeltaArray    = galois::LargeArray<PRTy>;
-using ResidualArray = galois::LargeArray<PRTy>;
+using DeltaArray        = galois::LargeArray<PRTy>;
+using ResidualArray     = galois::LargeArray<PRTy>;
+using ContributionArray = galois::LargeArray<PRTy>;
 
 //! Initialize nodes for the topological algorithm.
 void initNodeDataTopological(Graph& g) {
@@ -85,6 +95,19 @@ void initNodeDataResidual(Graph& g, DeltaArray& delta,
       galois::no_stats(), galois::loopname("initNodeData"));
 }
 
+//! Initialize nodes for the Gauss-Seidel algorithm; needs the outdegrees.
+void initNodeDataGaussSeidel(Graph& g, ContributionArray& contrib) {
+  PRTy init_value = 1.0f / g.size();
+  galois::do_all(
+      galois::iterate(g),
+      [&](const GNode& n) {
+        auto& sdata = g.getData(n, galois::MethodFlag::UNPROTECTED);
+        sdata.value = init_value;
+        contrib[n]  = sdata.nout > 0 ? init_value / sdata.nout : 0;
+      },
+      galois::no_stats(), galois::loopname("initNodeData"));
+}
+
 //! Computing outdegrees in the tranpose graph is equivalent to computing the
 //! indegrees in the original graph.
 void computeOutDeg(Graph& graph) {
@@ -250,6 +273,58 @@ void computePRTopological(Graph& graph) {
   }
 }
 
+/**
+ * PageRank pull Gauss-Seidel.
+ * Computes the same in-place iteration as the topological algorithm, where a
+ * new rank is read by the nodes computed after it in the same round, but
+ * keeps rank/outdegree of each node in its own array so that the pull reads
+ * one value per edge instead of a rank and an outdegree and a division.
+ * Work is not stolen: each thread sweeps, in order, the range of nodes it
+ * constructed when the graph was read, which is on its NUMA node, and first
+ * touches the same range of the contribution array.
+ */
+void computePRGaussSeidel(Graph& graph, ContributionArray& contrib) {
+  unsigned int iteration = 0;
+  galois::GAccumulator<float> accum;
+
+  float base_score = (1.0f - ALPHA) / graph.size();
+  while (true) {
+    galois::do_all(
+        galois::iterate(graph),
+        [&](const GNode& src) {
+          constexpr const galois::MethodFlag flag =
+              galois::MethodFlag::UNPROTECTED;
+
+          LNode& sdata = graph.getData(src, flag);
+          float sum    = 0.0;
+          for (auto jj : graph.edges(src, flag)) {
+            sum += contrib[graph.getEdgeDst(jj)];
+          }
+
+          float value = sum * ALPHA + base_score;
+          accum += std::fabs(value - sdata.value);
+          sdata.value = value;
+          if (sdata.nout > 0) {
+            contrib[src] = value / sdata.nout;
+          }
+        },
+        galois::no_stats(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("PageRankGaussSeidel"));
+
+    iteration += 1;
+    if (accum.reduce() <= tolerance || iteration >= maxIterations) {
+      break;
+    }
+    accum.reset();
+  }
+
+  galois::runtime::reportStat_Single("PageRank", "Rounds", iteration);
+  if (iteration >= maxIterations) {
+    std::cerr << "ERROR: failed to converge in " << iteration
+              << " iterations\n";
+  }
+}
+
 void prTopological(Graph& graph) {
   initNodeDataTopological(graph);
   computeOutDeg(graph);
@@ -275,6 +350,58 @@ void prResidual(Graph& graph) {
   execTime.stop();
 }
 
+void prGaussSeidel(Graph& graph) {
+  ContributionArray contrib;
+  contrib.allocateFloating(graph.size());
+
+  computeOutDeg(graph);
+  initNodeDataGaussSeidel(graph, contrib);
+
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  computePRGaussSeidel(graph, contrib);
+  execTime.stop();
+}
+
+//! Runs a to the current tolerance for -convergence, timing only the
+//! computation, and returns the factor that normalizes its ranks.
+double convergencePageRank(Graph& graph, Algo a, galois::Timer& timer) {
+  switch (a) {
+  case Topo: {
+    initNodeDataTopological(graph);
+    computeOutDeg(graph);
+    timer.start();
+    computePRTopological(graph);
+    timer.stop();
+    return 1.0;
+  }
+  case Residual: {
+    DeltaArray delta;
+    delta.allocateInterleaved(graph.size());
+    ResidualArray residual;
+    residual.allocateInterleaved(graph.size());
+    initNodeDataResidual(graph, delta, residual);
+    computeOutDeg(graph);
+    timer.start();
+    computePRResidual(graph, delta, residual);
+    timer.stop();
+    return 1.0 / graph.size();
+  }
+  case GaussSeidel: {
+    ContributionArray contrib;
+    contrib.allocateFloating(graph.size());
+    computeOutDeg(graph);
+    initNodeDataGaussSeidel(graph, contrib);
+    timer.start();
+    computePRGaussSeidel(graph, contrib);
+    timer.stop();
+    return 1.0;
+  }
+  default:
+    std::abort();
+  }
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, url, &inputFile);
@@ -298,6 +425,9 @@ int main(int argc, char** argv) {
   std::cout << "Read " << transposeGraph.size() << " nodes, "
             << transposeGraph.sizeEdges() << " edges\n";
 
+  galois::graphs::NodePermutation perm =
+      LonestarReorder(transposeGraph, reorderPolicy);
+
   galois::preAlloc(2 * numThreads + (3 * transposeGraph.size() *
                                      sizeof(typename Graph::node_data_type)) /
                                         galois::runtime::pagePoolSize());
@@ -314,6 +444,11 @@ int main(int argc, char** argv) {
               << ", maxIterations:" << maxIterations << "\n";
     prResidual(transposeGraph);
     break;
+  case GaussSeidel:
+    std::cout << "Running Pull Gauss-Seidel version, tolerance:" << tolerance
+              << ", maxIterations:" << maxIterations << "\n";
+    prGaussSeidel(transposeGraph);
+    break;
   default:
     std::abort();
   }
@@ -349,13 +484,21 @@ int main(int argc, char** argv) {
   galois::gInfo("Sum is ", rSum);
 
   if (!skipVerify) {
-    printTop(transposeGraph);
+    printTop(transposeGraph, perm);
   }
 
 #if DEBUG
   printPageRank(transposeGraph);
 #endif
 
+  if (convergence) {
+    std::vector<Algo> algos{Topo, Residual, GaussSeidel};
+    printConvergence(transposeGraph, true, algos, ALGO_NAMES,
+                     [&](Algo a, galois::Timer& timer) {
+                       return convergencePageRank(transposeGraph, a, timer);
+                     });
+  }
+
   totalTime.stop();
 
   return 0;
@@ -25,6 +25,9 @@
 #include "galois/graphs/LCGraph.h"
 #include "galois/graphs/TypeTraits.h"
 
+#include <algorithm>
+#include <cmath>
+
 /**
  * These implementations are based on the Push-based PageRank computation
  * (Algorithm 4) as described in the PageRank Europar 2015 paper.
@@ -39,12 +42,23 @@ const char* desc =
 
 constexpr static const unsigned CHUNK_SIZE = 16;
 
-enum Algo { Async, Sync }; ///< Async has better asbolute performance.
+enum Algo { Async, Sync, Priority }; ///< Async has better asbolute performance.
+
+const char* const ALGO_NAMES[] = {"Async", "Sync", "Priority"};
+
+static cll::opt<Algo>
+    algo("algo", cll::desc("Choose an algorithm:"),
+         cll::values(clEnumVal(Async, "Async"), clEnumVal(Sync, "Sync"),
+                     clEnumVal(Priority, "Priority: Async that processes the "
+                                         "largest residuals first")),
+         cll::init(Async));
 
-static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
-                           cll::values(clEnumVal(Async, "Async"),
-                                       clEnumVal(Sync, "Sync")),
-                           cll::init(Async));
+//! Priority buckets a residual r by ilogb(r / tolerance) >> PRIORITY_SHIFT,
+//! so each level spans a factor of 2^(2^PRIORITY_SHIFT) = 4 above the
+//! tolerance. Levels MAX_PRIORITY and above (r >= 2^32 tolerance) share the
+//! first bucket. A node is pushed again each time it moves up a level.
+constexpr static const int PRIORITY_SHIFT = 1;
+constexpr static const int MAX_PRIORITY   = 16;
 
 struct LNode {
   PRTy value;
@@ -100,6 +114,73 @@ void asyncPageRank(Graph& graph) {
       galois::wl<WL>());
 }
 
+//! Maps a node to its bucket for the Priority scheduler; a node is scheduled
+//! at its residual when it is pushed, and pushed again only when its level
+//! rises, so the level is capped where the buckets end.
+struct ResidualIndexer {
+  Graph& graph;
+
+  static int level(PRTy residual) {
+    return std::min(std::ilogb(residual / tolerance) >> PRIORITY_SHIFT,
+                    MAX_PRIORITY);
+  }
+
+  unsigned int operator()(const GNode& n) const {
+    PRTy residual =
+        graph.getData(n, galois::MethodFlag::UNPROTECTED).residual;
+    return MAX_PRIORITY - std::max(level(residual), 0);
+  }
+};
+
+/**
+ * Residual push that schedules the nodes with the largest residuals first,
+ * as in the prioritized variant of the Europar 2015 paper. OBIM orders the
+ * nodes by their quantized residual; a node is pushed again when its residual
+ * crosses the tolerance or moves up a bucket, and entries of nodes whose
+ * residual has been consumed are skipped.
+ */
+void priorityPageRank(Graph& graph) {
+  typedef galois::worklists::PerSocketChunkFIFO<CHUNK_SIZE> PSchunk;
+  typedef galois::worklists::OrderedByIntegerMetric<ResidualIndexer, PSchunk>
+      OBIM;
+
+  galois::for_each(
+      galois::iterate(graph),
+      [&](GNode src, auto& ctx) {
+        constexpr const galois::MethodFlag flag =
+            galois::MethodFlag::UNPROTECTED;
+        LNode& sdata = graph.getData(src, flag);
+
+        if (sdata.residual < tolerance)
+          return;
+
+        PRTy oldResidual = sdata.residual.exchange(0.0);
+        sdata.value += oldResidual;
+        int src_nout = std::distance(graph.edge_begin(src, flag),
+                                     graph.edge_end(src, flag));
+        if (src_nout == 0)
+          return;
+
+        PRTy delta = oldResidual * ALPHA / src_nout;
+        if (delta <= 0)
+          return;
+        for (auto jj : graph.edges(src, flag)) {
+          GNode dst    = graph.getEdgeDst(jj);
+          LNode& ddata = graph.getData(dst, flag);
+          PRTy old     = atomicAdd(ddata.residual, delta);
+          PRTy cur     = old + delta;
+          if (cur >= tolerance &&
+              (old < tolerance || ResidualIndexer::level(cur) >
+                                      ResidualIndexer::level(old))) {
+            ctx.push(dst);
+          }
+        }
+      },
+      galois::loopname("PushResidualPriority"),
+      galois::disable_conflict_detection(), galois::no_stats(),
+      galois::wl<OBIM>(ResidualIndexer{graph}));
+}
+
 void syncPageRank(Graph& graph) {
   struct Update {
     PRTy delta;
@@ -187,6 +268,22 @@ void syncPageRank(Graph& graph) {
   }
 }
 
+void runPageRank(Graph& graph, Algo a) {
+  switch (a) {
+  case Async:
+    asyncPageRank(graph);
+    break;
+  case Sync:
+    syncPageRank(graph);
+    break;
+  case Priority:
+    priorityPageRank(graph);
+    break;
+  default:
+    std::abort();
+  }
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, url, &inputFile);
@@ -214,20 +311,8 @@ int main(int argc, char** argv) {
   galois::StatTimer execTime("Timer_0");
   execTime.start();
 
-  switch (algo) {
-  case Async:
-    std::cout << "Running Edge Async push version,";
-    asyncPageRank(graph);
-    break;
-
-  case Sync:
-    std::cout << "Running Edge Sync push version,";
-    syncPageRank(graph);
-    break;
-
-  default:
-    std::abort();
-  }
+  std::cout << "Running Edge " << ALGO_NAMES[algo] << " push version\n";
+  runPageRank(graph, algo);
 
   execTime.stop();
 
@@ -241,6 +326,21 @@ int main(int argc, char** argv) {
   printPageRank(graph);
 #endif
 
+  if (convergence) {
+    std::vector<Algo> algos{Async, Sync, Priority};
+    printConvergence(graph, false, algos, ALGO_NAMES,
+                     [&](Algo a, galois::Timer& timer) {
+                       galois::do_all(
+                           galois::iterate(graph),
+                           [&graph](GNode n) { graph.getData(n).init(); },
+                           galois::no_stats());
+                       timer.start();
+                       runPageRank(graph, a);
+                       timer.stop();
+                       return 1.0 / graph.size();
+                     });
+  }
+
   totalTime.stop();
 
   return 0;
@@ -48,6 +48,11 @@ static cll::opt<uint32_t> sinkId("sinkNode", cll::desc("Sink node"),
 static cll::opt<bool> useHLOrder("useHLOrder",
                                  cll::desc("Use HL ordering heuristic"),
                                  cll::init(false));
+static cll::opt<bool>
+    useDeque("useDeque",
+             cll::desc("Schedule nodes depth first with per-thread "
+                       "work-stealing deques (ignored with useHLOrder)"),
+             cll::init(false));
 static cll::opt<bool>
     useUnitCapacity("useUnitCapacity",
                     cll::desc("Assume all capacities are unit"),
@@ -509,6 +514,7 @@ struct PreflowPush {
     typedef galois::worklists::OrderedByIntegerMetric<decltype(obimIndexer),
                                                       Chunk>
         OBIM;
+    typedef galois::worklists::ChaseLev<GNode> Deque;
 
     galois::InsertBag<GNode> initial;
     initializePreflow(initial);
@@ -521,6 +527,8 @@ struct PreflowPush {
       case nondet:
         if (useHLOrder) {
           nonDetDischarge(initial, counter, galois::wl<OBIM>(obimIndexer));
+        } else if (useDeque) {
+          nonDetDischarge(initial, counter, galois::wl<Deque>());
         } else {
           nonDetDischarge(initial, counter, galois::wl<Chunk>());
         }
@@ -30,7 +30,13 @@
 
 #include "llvm/Support/CommandLine.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace cll = llvm::cl;
 
@@ -50,10 +56,18 @@ static cll::opt<unsigned int>
     reportNode("reportNode",
                cll::desc("Node to report distance to(default value 1)"),
                cll::init(1));
-static cll::opt<unsigned int>
-    stepShift("delta",
-              cll::desc("Shift value for the deltastep (default value 13)"),
-              cll::init(13));
+static cll::opt<galois::graphs::ReorderPolicy> reorderPolicy(
+    "reorder", cll::desc("Relabel nodes for locality (default none)"),
+    reorderPolicyValues(), cll::init(galois::graphs::ReorderPolicy::None));
+static cll::opt<std::string>
+    deltaOpt("delta",
+             cll::desc("Shift value for the deltastep, or auto to choose it "
+                       "from sampled edge weights and degrees (default "
+                       "value 13)"),
+             cll::init("13"));
+
+//! Shift of the deltastep, from -delta
+static unsigned int stepShift;
 
 enum Algo {
   deltaTile = 0,
@@ -65,13 +79,17 @@ enum Algo {
   dijkstra,
   topo,
   topoTile,
+  multiQueueTile,
+  multiQueue,
+  deltaStepAdaptive,
   AutoAlgo
 };
 
 const char* const ALGO_NAMES[] = {
-    "deltaTile", "deltaStep",    "deltaStepBarrier", "serDeltaTile",
-    "serDelta",  "dijkstraTile", "dijkstra",         "topo",
-    "topoTile",  "Auto"};
+    "deltaTile", "deltaStep",      "deltaStepBarrier", "serDeltaTile",
+    "serDelta",  "dijkstraTile",   "dijkstra",         "topo",
+    "topoTile",  "multiQueueTile", "multiQueue",       "deltaStepAdaptive",
+    "Auto"};
 
 static cll::opt<Algo> algo(
     "algo", cll::desc("Choose an algorithm (default value auto):"),
@@ -83,6 +101,11 @@ static cll::opt<Algo> algo(
                 clEnumVal(dijkstraTile, "dijkstraTile"),
                 clEnumVal(dijkstra, "dijkstra"), clEnumVal(topo, "topo"),
                 clEnumVal(topoTile, "topoTile"),
+                clEnumVal(multiQueueTile, "multiQueueTile"),
+                clEnumVal(multiQueue, "multiQueue"),
+                clEnumVal(deltaStepAdaptive,
+                          "deltaStepAdaptive: bulk-synchronous deltaStep that "
+                          "retunes delta between buckets"),
                 clEnumVal(AutoAlgo,
                           "auto: choose among the algorithms automatically")),
     cll::init(AutoAlgo));
@@ -97,6 +120,25 @@ constexpr static const bool TRACK_WORK          = false;
 constexpr static const unsigned CHUNK_SIZE      = 64U;
 constexpr static const ptrdiff_t EDGE_TILE_SIZE = 512;
 
+//! Nodes whose out edges are sampled by -delta=auto
+constexpr static const size_t DELTA_SAMPLE_NODES = 4096;
+//! Edges per sampled node whose weights are kept
+constexpr static const size_t DELTA_SAMPLE_EDGES = 64;
+//! -delta=auto picks delta = DELTA_SCALE * heavy weight / mean out-degree,
+//! where the heavy weight is this quantile of the sampled weights
+constexpr static const double DELTA_WEIGHT_QUANTILE = 0.9;
+constexpr static const double DELTA_SCALE           = 2;
+//! deltaStepAdaptive halves delta when more than this fraction of the work
+//! in a bucket was wasted
+constexpr static const double MAX_WASTED_WORK = 0.25;
+//! deltaStepAdaptive doubles delta when a bucket had fewer items than this
+//! per thread and wasted less than MAX_WASTED_WORK / 4
+constexpr static const size_t MIN_BUCKET_WORK = 64;
+//! Largest delta shift accepted by -delta and chosen by -delta=auto and
+//! deltaStepAdaptive; with 32-bit distances larger shifts leave only a
+//! couple of buckets
+constexpr static const unsigned MAX_SHIFT = 30;
+
 using SSSP                 = BFS_SSSP<Graph, uint32_t, true, EDGE_TILE_SIZE>;
 using Dist                 = SSSP::Dist;
 using UpdateRequest        = SSSP::UpdateRequest;
@@ -114,10 +156,13 @@ using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
 using OBIM_Barrier =
     gwl::OrderedByIntegerMetric<UpdateRequestIndexer,
                                 PSchunk>::with_barrier<true>::type;
+template <typename T>
+using MQ = gwl::MultiQueue<std::less<T>, T>;
 
-template <typename T, typename OBIMTy = OBIM, typename P, typename R>
+template <typename T, typename WLTy = OBIM, typename P, typename R,
+          typename... WLArgs>
 void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
-                   const R& edgeRange) {
+                   const R& edgeRange, WLArgs&&... wlArgs) {
 
   //! [reducible for self-defined stats]
   galois::GAccumulator<size_t> BadWork;
@@ -160,7 +205,7 @@ void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
           }
         }
       },
-      galois::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
+      galois::wl<WLTy>(std::forward<WLArgs>(wlArgs)...),
       galois::disable_conflict_detection(), galois::loopname("SSSP"));
 
   if (TRACK_WORK) {
@@ -352,6 +397,164 @@ void topoTileAlgo(Graph& graph, const GNode& source) {
   galois::runtime::reportStat_Single("SSSP-topo", "rounds", rounds);
 }
 
+/**
+ * Bulk-synchronous delta-stepping with near and far piles, as in
+ *
+ * Andrew Davidson, Sean Baxter, Michael Garland, John D. Owens. Work-Efficient
+ * Parallel GPU Methods for Single-Source Shortest Paths. IPDPS 2014.
+ *
+ * Requests below the end of the current bucket go to the near pile and are
+ * relaxed in rounds until it is empty; the others wait in the far pile, which
+ * is split again once the bucket is done. Since each bucket starts at the
+ * smallest distance in the far pile, delta can change between buckets: it is
+ * halved when too many of a bucket's requests were stale (their node was
+ * lowered again before they ran) and doubled when buckets are too small to
+ * keep the threads busy.
+ */
+void deltaStepAdaptiveAlgo(Graph& graph, const GNode& source) {
+  using Bag                         = galois::InsertBag<UpdateRequest>;
+  constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  Bag farPiles[2];
+  Bag nearPiles[2];
+  Bag* far     = &farPiles[0];
+  Bag* nextFar = &farPiles[1];
+
+  unsigned shift = stepShift;
+  const uint64_t minWork =
+      uint64_t(MIN_BUCKET_WORK) * galois::getActiveThreads();
+  uint64_t buckets      = 0;
+  uint64_t shiftChanges = 0;
+  uint64_t totalWork    = 0;
+  uint64_t totalWasted  = 0;
+
+  galois::GReduceMin<Dist> farMin;
+  graph.getData(source) = 0;
+  far->push(UpdateRequest(source, 0));
+  farMin.update(0);
+
+  while (!far->empty()) {
+    uint64_t bucketEnd = ((uint64_t(farMin.reduce()) >> shift) + 1) << shift;
+    farMin.reset();
+
+    Bag* cur  = &nearPiles[0];
+    Bag* next = &nearPiles[1];
+    galois::do_all(
+        galois::iterate(*far),
+        [&](const UpdateRequest& req) {
+          if (graph.getData(req.src, flag) < req.dist)
+            return;
+          if (req.dist < bucketEnd) {
+            cur->push(req);
+          } else {
+            nextFar->push(req);
+            farMin.update(req.dist);
+          }
+        },
+        galois::steal(), galois::no_stats(), galois::loopname("SplitFar"));
+    far->clear();
+    std::swap(far, nextFar);
+
+    galois::GAccumulator<uint64_t> work;
+    galois::GAccumulator<uint64_t> wasted;
+    while (!cur->empty()) {
+      galois::do_all(
+          galois::iterate(*cur),
+          [&](const UpdateRequest& req) {
+            work += 1;
+            const Dist sdata = graph.getData(req.src, flag);
+            if (sdata < req.dist) {
+              wasted += 1;
+              return;
+            }
+            for (auto e : graph.edges(req.src, flag)) {
+              GNode dst          = graph.getEdgeDst(e);
+              const Dist newDist = sdata + graph.getEdgeData(e, flag);
+              Dist oldDist       = galois::atomicMin<uint32_t>(
+                  graph.getData(dst, flag), newDist);
+              if (newDist < oldDist) {
+                if (newDist < bucketEnd) {
+                  next->push(UpdateRequest(dst, newDist));
+                } else {
+                  far->push(UpdateRequest(dst, newDist));
+                  farMin.update(newDist);
+                }
+              }
+            }
+          },
+          galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+          galois::loopname("SSSP"));
+      cur->clear();
+      std::swap(cur, next);
+    }
+
+    ++buckets;
+    uint64_t w = work.reduce();
+    uint64_t x = wasted.reduce();
+    totalWork += w;
+    totalWasted += x;
+    if (x > MAX_WASTED_WORK * w && shift > 0) {
+      --shift;
+      ++shiftChanges;
+    } else if (w < minWork && 4 * x <= MAX_WASTED_WORK * w &&
+               shift < MAX_SHIFT) {
+      ++shift;
+      ++shiftChanges;
+    }
+  }
+
+  galois::runtime::reportStat_Single("SSSP-Adaptive", "Buckets", buckets);
+  galois::runtime::reportStat_Single("SSSP-Adaptive", "ShiftChanges",
+                                     shiftChanges);
+  galois::runtime::reportStat_Single("SSSP-Adaptive", "FinalShift", shift);
+  galois::runtime::reportStat_Single("SSSP-Adaptive", "Work", totalWork);
+  galois::runtime::reportStat_Single("SSSP-Adaptive", "WastedWork",
+                                     totalWasted);
+}
+
+/**
+ * Picks the delta shift for -delta=auto from the out edges of up to
+ * DELTA_SAMPLE_NODES evenly spaced nodes. Meyer and Sanders show that
+ * delta = max weight / degree keeps the work of delta-stepping linear for
+ * random weights; a high quantile stands in for the maximum so that a few
+ * outliers do not blow up the buckets.
+ */
+unsigned int chooseDeltaShift(Graph& graph) {
+  constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  size_t numSampled = std::min(graph.size(), DELTA_SAMPLE_NODES);
+  if (numSampled == 0)
+    return 0;
+  size_t step = graph.size() / numSampled;
+
+  uint64_t edges = 0;
+  std::vector<Dist> weights;
+  for (size_t i = 0; i < numSampled; ++i) {
+    size_t kept = 0;
+    for (auto e : graph.edges(i * step, flag)) {
+      ++edges;
+      if (kept++ < DELTA_SAMPLE_EDGES)
+        weights.push_back(graph.getEdgeData(e, flag));
+    }
+  }
+  if (weights.empty())
+    return 0;
+
+  auto heavy = weights.begin() + size_t(DELTA_WEIGHT_QUANTILE *
+                                        (weights.size() - 1));
+  std::nth_element(weights.begin(), heavy, weights.end());
+  double meanDegree = double(edges) / numSampled;
+  double delta      = DELTA_SCALE * *heavy / std::max(meanDegree, 1.0);
+  unsigned shift =
+      delta < 2 ? 0 : std::min(unsigned(std::log2(delta)), MAX_SHIFT);
+
+  galois::runtime::reportStat_Single("SSSP", "SampledHeavyWeight", *heavy);
+  galois::runtime::reportStat_Single("SSSP", "SampledMeanDegree", meanDegree);
+  galois::gInfo("Sampled heavy edge weight ", *heavy, " and mean out-degree ",
+                meanDegree, "; choosing delta shift ", shift);
+  return shift;
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, url, &inputFile);
@@ -375,11 +578,29 @@ int main(int argc, char** argv) {
     abort();
   }
 
+  galois::graphs::NodePermutation perm = LonestarReorder(graph, reorderPolicy);
+
+  if (deltaOpt == "auto") {
+    stepShift = chooseDeltaShift(graph);
+  } else {
+    // strtoul would accept a sign and leading spaces, wrapping -1 around
+    char* end;
+    unsigned long shift = std::strtoul(deltaOpt.c_str(), &end, 10);
+    if (deltaOpt.empty() || !std::isdigit((unsigned char)deltaOpt[0]) ||
+        *end != '\0')
+      GALOIS_DIE("-delta takes a shift value or auto, not ", deltaOpt);
+    if (shift > MAX_SHIFT)
+      GALOIS_DIE("-delta shift ", deltaOpt, " is above the maximum of ",
+                 MAX_SHIFT);
+    stepShift = shift;
+  }
+  galois::runtime::reportStat_Single("SSSP", "DeltaShift", stepShift);
+
   auto it = graph.begin();
-  std::advance(it, startNode.getValue());
+  std::advance(it, perm.newId(startNode));
   source = *it;
   it     = graph.begin();
-  std::advance(it, reportNode.getValue());
+  std::advance(it, perm.newId(reportNode));
   report = *it;
 
   size_t approxNodeData = graph.size() * 64;
@@ -388,12 +609,14 @@ int main(int argc, char** argv) {
   galois::reportPageAlloc("MeminfoPre");
 
   if (algo == deltaStep || algo == deltaTile || algo == serDelta ||
-      algo == serDeltaTile) {
+      algo == serDeltaTile || algo == deltaStepAdaptive) {
     std::cout << "INFO: Using delta-step of " << (1 << stepShift) << "\n";
-    std::cout
-        << "WARNING: Performance varies considerably due to delta parameter.\n";
-    std::cout
-        << "WARNING: Do not expect the default to be good for your graph.\n";
+    if (deltaOpt != "auto") {
+      std::cout << "WARNING: Performance varies considerably due to delta "
+                   "parameter.\n";
+      std::cout
+          << "WARNING: Do not expect the default to be good for your graph.\n";
+    }
   }
 
   galois::do_all(galois::iterate(graph),
@@ -421,11 +644,12 @@ int main(int argc, char** argv) {
   switch (algo) {
   case deltaTile:
     deltaStepAlgo<SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
-                               TileRangeFn());
+                               TileRangeFn(), UpdateRequestIndexer{stepShift});
     break;
   case deltaStep:
     deltaStepAlgo<UpdateRequest>(graph, source, ReqPushWrap(),
-                                 OutEdgeRangeFn{graph});
+                                 OutEdgeRangeFn{graph},
+                                 UpdateRequestIndexer{stepShift});
     break;
   case serDeltaTile:
     serDeltaAlgo<SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
@@ -452,7 +676,20 @@ int main(int argc, char** argv) {
 
   case deltaStepBarrier:
     deltaStepAlgo<UpdateRequest, OBIM_Barrier>(graph, source, ReqPushWrap(),
-                                               OutEdgeRangeFn{graph});
+                                               OutEdgeRangeFn{graph},
+                                               UpdateRequestIndexer{stepShift});
+    break;
+
+  case multiQueueTile:
+    deltaStepAlgo<SrcEdgeTile, MQ<SrcEdgeTile>>(
+        graph, source, SrcEdgeTilePushWrap{graph}, TileRangeFn());
+    break;
+  case multiQueue:
+    deltaStepAlgo<UpdateRequest, MQ<UpdateRequest>>(
+        graph, source, ReqPushWrap(), OutEdgeRangeFn{graph});
+    break;
+  case deltaStepAdaptive:
+    deltaStepAdaptiveAlgo(graph, source);
     break;
 
   default:
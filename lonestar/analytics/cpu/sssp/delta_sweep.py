@@ -0,0 +1,96 @@
+#!/usr/bin/env python
+#
+# Compares sssp-cpu -delta=auto with the best hand-tuned delta: for every
+# input, runs each fixed shift and auto, and reports the best shift, its
+# time, the shift auto chose and its time.
+#
+# Example:
+#   delta_sweep.py -b <BUILD>/lonestar/analytics/cpu/sssp/sssp-cpu \
+#     -i <BUILD>/inputs -t 40 -s 4:20
+
+from __future__ import print_function
+import glob
+import optparse
+import os
+import re
+import subprocess
+import sys
+
+STAT_RE = re.compile(r"^STAT, ([^,]+), ([^,]+), [A-Z]+, (\S+)$")
+
+
+def run(binary, graph, delta, options):
+  """Returns (Timer_0 in ms, delta shift) of the fastest of options.runs runs"""
+  cmd = [binary, graph, "-delta=%s" % delta, "-t=%d" % options.threads,
+         "-algo=%s" % options.algo, "-noverify"]
+  best = None
+  shift = None
+  for _ in range(options.runs):
+    try:
+      out = subprocess.check_output(cmd, stderr=subprocess.STDOUT)
+    except subprocess.CalledProcessError:
+      # e.g., too many buckets for very small shifts
+      return float("inf"), shift
+    for line in out.decode().splitlines():
+      m = STAT_RE.match(line.strip())
+      if not m:
+        continue
+      if m.group(2) == "Timer_0":
+        t = float(m.group(3))
+        best = t if best is None else min(best, t)
+      elif m.group(1) == "SSSP" and m.group(2) == "DeltaShift":
+        shift = int(m.group(3))
+  return best, shift
+
+
+def parse_shifts(s):
+  parts = [int(x) for x in s.split(":")]
+  if len(parts) == 1:
+    return parts
+  step = parts[2] if len(parts) > 2 else 1
+  return list(range(parts[0], parts[1] + 1, step))
+
+
+def main():
+  parser = optparse.OptionParser(usage="usage: %prog [options] [graphs]")
+  parser.add_option("-b", "--binary", dest="binary", default="./sssp-cpu",
+                    help="sssp-cpu binary")
+  parser.add_option("-i", "--inputs", dest="inputs", default="inputs",
+                    help="directory searched for weighted .gr graphs when no "
+                    "graphs are given")
+  parser.add_option("-t", "--threads", dest="threads", type="int", default=1)
+  parser.add_option("-s", "--shifts", dest="shifts", default="4:20",
+                    help="hand-tuned shifts to try, N, N:M or N:M:step")
+  parser.add_option("-a", "--algo", dest="algo", default="deltaStep")
+  parser.add_option("-r", "--runs", dest="runs", type="int", default=3,
+                    help="runs per setting; the fastest is kept")
+  (options, graphs) = parser.parse_args()
+
+  if not graphs:
+    graphs = sorted(glob.glob(os.path.join(options.inputs, "**", "*.gr"),
+                              recursive=True))
+    # transposes hold the same weights as their graphs
+    graphs = [g for g in graphs if not g.endswith(".tgr")]
+  if not graphs:
+    sys.stderr.write("no inputs found\n")
+    sys.exit(1)
+
+  print("%-40s %6s %10s %6s %10s %8s" %
+        ("input", "best", "best ms", "auto", "auto ms", "slowdown"))
+  for graph in graphs:
+    times = {}
+    for shift in parse_shifts(options.shifts):
+      times[shift], _ = run(options.binary, graph, shift, options)
+    best = min(times, key=times.get)
+    autoTime, autoShift = run(options.binary, graph, "auto", options)
+    if autoShift is None:
+      # the auto run failed before reporting its choice
+      autoShift = -1
+    print("%-40s %6d %10.0f %6d %10.0f %8.2f" %
+          (os.path.basename(graph), best, times[best], autoShift, autoTime,
+           autoTime / max(times[best], 1)))
+    sys.stdout.flush()
+
+
+if __name__ == "__main__":
+  main()
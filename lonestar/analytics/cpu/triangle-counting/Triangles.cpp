@@ -21,9 +21,11 @@
 #include "galois/Bag.h"
 #include "galois/ParallelSTL.h"
 #include "galois/Reduction.h"
+#include "galois/SetIntersection.h"
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/graphs/BufferedGraph.h"
+#include "galois/substrate/PerThreadStorage.h"
 #include "galois/runtime/Profile.h"
 #include "llvm/Support/CommandLine.h"
 #include "Lonestar/Utils.h"
@@ -31,6 +33,7 @@
 
 #include <boost/iterator/transform_iterator.hpp>
 
+#include <atomic>
 #include <utility>
 #include <vector>
 #include <algorithm>
@@ -41,6 +44,8 @@ const char* name = "Triangles";
 const char* desc = "Counts the triangles in a graph";
 
 constexpr static const unsigned CHUNK_SIZE = 64U;
+//! Smaller-neighbor count from which orderedCount intersects via a bitmap
+constexpr static const size_t HUB_DEGREE = 1024;
 enum Algo { nodeiterator, edgeiterator, orderedCount };
 
 namespace cll = llvm::cl;
@@ -101,21 +106,8 @@ template <typename G>
 size_t countEqual(G& g, typename G::edge_iterator aa,
                   typename G::edge_iterator ea, typename G::edge_iterator bb,
                   typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::GraphNode a = g.getEdgeDst(aa);
-    typename G::GraphNode b = g.getEdgeDst(bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
+  return galois::intersectCount(g.getEdgeDstPtr(aa), std::distance(aa, ea),
+                                g.getEdgeDstPtr(bb), std::distance(bb, eb));
 }
 
 template <typename G>
@@ -237,37 +229,61 @@ void nodeIteratingAlgo(Graph& graph) {
 }
 
 /**
- * Lambda function to count triangles
+ * Number of neighbors of n with smaller ids; edges are sorted, so these come
+ * first.
+ */
+size_t lowerDegree(Graph& graph, GNode n) {
+  Graph::edge_iterator first =
+      graph.edge_begin(n, galois::MethodFlag::UNPROTECTED);
+  Graph::edge_iterator last =
+      graph.edge_end(n, galois::MethodFlag::UNPROTECTED);
+  return std::distance(first,
+                       lowerBound(first, last, LessThan<Graph>(graph, n)));
+}
+
+/**
+ * Lambda function to count triangles: for each neighbor v < n, intersects
+ * the neighbors of v below v with the neighbors of n below v. If n has at
+ * least HUB_DEGREE smaller neighbors, they are put into the thread's bitmap
+ * once and each intersection is a bit test per neighbor of v instead. A
+ * thread allocates its bitmap at its first hub, taking one of bitmapsLeft;
+ * once none are left, hubs are intersected like other nodes.
  */
-void orderedCountFunc(Graph& graph, GNode n,
+void orderedCountFunc(Graph& graph, GNode n, galois::IntersectBitmap& bitmap,
+                      std::atomic<size_t>& bitmapsLeft,
                       galois::GAccumulator<size_t>& numTriangles) {
   size_t numTriangles_local = 0;
-  for (auto it_v : graph.edges(n)) {
-    auto v = graph.getEdgeDst(it_v);
-    if (v >= n)
-      break;
-    Graph::edge_iterator it_n =
-        graph.edge_begin(n, galois::MethodFlag::UNPROTECTED);
-
-    for (auto it_vv : graph.edges(v)) {
-      auto vv = graph.getEdgeDst(it_vv);
-      if (vv >= v)
-        break;
-      while (graph.getEdgeDst(it_n) < vv)
-        it_n++;
-      if (vv == graph.getEdgeDst(it_n)) {
-
-        Graph::edge_iterator multi_it_n = it_n;
-
-        while (multi_it_n !=
-                   graph.edge_end(n, galois::MethodFlag::UNPROTECTED) &&
-               graph.getEdgeDst(multi_it_n) == vv) {
-          numTriangles_local += 1;
-          multi_it_n++;
-        }
-      }
-    }
+  Graph::edge_iterator first =
+      graph.edge_begin(n, galois::MethodFlag::UNPROTECTED);
+  const uint32_t* nbrs = graph.getEdgeDstPtr(first);
+  size_t degree        = lowerDegree(graph, n);
+
+  bool hub = degree >= HUB_DEGREE;
+  if (hub && bitmap.empty()) {
+    size_t left = bitmapsLeft.load(std::memory_order_relaxed);
+    while (left && !bitmapsLeft.compare_exchange_weak(left, left - 1))
+      ;
+    hub = left != 0;
+    if (hub)
+      bitmap.resize(graph.size());
   }
+  if (hub)
+    bitmap.set(nbrs, degree);
+
+  for (size_t i = 0; i < degree; ++i) {
+    GNode v = nbrs[i];
+    const uint32_t* vNbrs = graph.getEdgeDstPtr(
+        graph.edge_begin(v, galois::MethodFlag::UNPROTECTED));
+    size_t vDegree = lowerDegree(graph, v);
+    // neighbors of n below v are exactly nbrs[0, i)
+    if (hub)
+      numTriangles_local += bitmap.count(vNbrs, vDegree);
+    else
+      numTriangles_local += galois::intersectCount(vNbrs, vDegree, nbrs, i);
+  }
+
+  if (hub)
+    bitmap.reset(nbrs, degree);
   numTriangles += numTriangles_local;
 }
 
@@ -276,9 +292,18 @@ void orderedCountFunc(Graph& graph, GNode n,
  */
 void orderedCountAlgo(Graph& graph) {
   galois::GAccumulator<size_t> numTriangles;
+  galois::substrate::PerThreadStorage<galois::IntersectBitmap> bitmaps;
+  // Bitmaps together take at most as much memory as the edge destinations,
+  // instead of a bitmap of the whole graph per thread
+  size_t bitmapBytes = (graph.size() / 64 + 1) * sizeof(uint64_t);
+  std::atomic<size_t> bitmapsLeft(
+      std::max<size_t>(1, graph.sizeEdges() * sizeof(uint32_t) / bitmapBytes));
   galois::do_all(
       galois::iterate(graph),
-      [&](const GNode& n) { orderedCountFunc(graph, n, numTriangles); },
+      [&](const GNode& n) {
+        orderedCountFunc(graph, n, *bitmaps.getLocal(), bitmapsLeft,
+                         numTriangles);
+      },
       galois::chunk_size<CHUNK_SIZE>(), galois::steal(),
       galois::loopname("orderedCountAlgo"));
 
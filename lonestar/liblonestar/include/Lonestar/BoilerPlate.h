@@ -22,6 +22,7 @@
 
 #include "galois/Galois.h"
 #include "galois/Version.h"
+#include "galois/graphs/Reorder.h"
 #include "llvm/Support/CommandLine.h"
 
 //! standard global options to the benchmarks
@@ -34,4 +35,38 @@ extern llvm::cl::opt<bool> symmetricGraph;
 void LonestarStart(int argc, char** argv, const char* app, const char* desc,
                    const char* url, llvm::cl::opt<std::string>* input);
 void LonestarStart(int argc, char** argv);
+
+/**
+ * Values of the -reorder option. Only apps that call LonestarReorder define
+ * the option, so other apps reject it instead of silently ignoring it:
+ *
+ *   static cll::opt<galois::graphs::ReorderPolicy> reorderPolicy(
+ *       "reorder", cll::desc("Relabel nodes for locality (default none)"),
+ *       reorderPolicyValues(), cll::init(galois::graphs::ReorderPolicy::None));
+ */
+llvm::cl::ValuesClass reorderPolicyValues();
+
+/**
+ * Relabels the nodes of graph with the given ordering. Returns the
+ * permutation so that node ids given on the command line and printed in
+ * results can be translated between the original and new ids; with policy
+ * None the graph is untouched and the permutation is the identity.
+ */
+template <typename Graph>
+galois::graphs::NodePermutation
+LonestarReorder(Graph& graph, galois::graphs::ReorderPolicy reorderPolicy) {
+  if (reorderPolicy == galois::graphs::ReorderPolicy::None)
+    return galois::graphs::NodePermutation();
+
+  galois::StatTimer reorderTime("TimerReorder");
+  reorderTime.start();
+  galois::graphs::NodePermutation perm =
+      galois::graphs::reorderNodes(graph, reorderPolicy);
+  Graph relabelled;
+  galois::graphs::relabelGraph(graph, perm, relabelled);
+  swap(graph, relabelled);
+  reorderTime.stop();
+
+  return perm;
+}
 #endif
@@ -41,6 +41,20 @@ llvm::cl::opt<bool>
                    llvm::cl::desc("Specify that the input graph is symmetric"),
                    llvm::cl::init(false));
 
+llvm::cl::ValuesClass reorderPolicyValues() {
+  return llvm::cl::values(
+      clEnumValN(galois::graphs::ReorderPolicy::None, "none",
+                 "Keep the input order"),
+      clEnumValN(galois::graphs::ReorderPolicy::Degree, "degree",
+                 "Sort by decreasing degree"),
+      clEnumValN(galois::graphs::ReorderPolicy::HubSort, "hubsort",
+                 "Move nodes of above-average degree to the front"),
+      clEnumValN(galois::graphs::ReorderPolicy::RCM, "rcm",
+                 "Reverse Cuthill-McKee"),
+      clEnumValN(galois::graphs::ReorderPolicy::Gorder, "gorder",
+                 "Gorder greedy window ordering"));
+}
+
 static void LonestarPrintVersion(llvm::raw_ostream& out) {
   out << "LoneStar Benchmark Suite v" << galois::getVersion() << " ("
       << galois::getRevision() << ")\n";
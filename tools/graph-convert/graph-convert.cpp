@@ -19,7 +19,10 @@
 
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
+#include "galois/graphs/EdgeListReader.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/LC_Compressed_Graph.h"
+#include "galois/graphs/ReadGraph.h"
 
 #include <llvm/Support/CommandLine.h>
 
@@ -50,6 +53,7 @@ enum ConvertMode {
   gr2binarypbbs64,
   gr2bsml,
   gr2cgr,
+  gr2compressedgr,
   gr2dimacs,
   gr2adjacencylist,
   gr2edgelist,
@@ -138,6 +142,8 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2bsml, "Convert binary gr to binary sparse MATLAB matrix"),
         clEnumVal(gr2cgr,
                   "Clean up binary gr: remove self edges and multi-edges"),
+        clEnumVal(gr2compressedgr, "Convert binary gr to delta/varint "
+                                   "compressed graph (LC_Compressed_Graph)"),
         clEnumVal(gr2dimacs, "Convert binary gr to dimacs"),
         clEnumVal(gr2adjacencylist, "Convert binary gr to adjacency list"),
         clEnumVal(gr2edgelist, "Convert binary gr to edgelist"),
@@ -200,6 +206,10 @@ static cll::opt<int>
              cll::init(1));
 static cll::opt<int> maxDegree("maxDegree", cll::desc("maximum degree to keep"),
                                cll::init(2 * 1024));
+static cll::opt<int>
+    numThreads("t", cll::desc("Number of threads for parallel conversions "
+                              "(default value 1)"),
+               cll::init(1));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -344,193 +354,22 @@ void skipLine(std::ifstream& infile) {
  * ...
  *
  * If delim is set, this function expects that each entry is separated by delim
- * surrounded by optional whitespace.
+ * surrounded by optional whitespace. The file is parsed in parallel with -t
+ * threads; edges of each node are written sorted by destination.
  */
 template <typename EdgeTy>
 void convertEdgelist(const std::string& infilename,
                      const std::string& outfilename, const bool skipFirstLine,
-                     std::optional<char> delim) {
-  typedef galois::graphs::FileGraphWriter Writer;
-
-  Writer p;
-  std::ifstream infile(infilename.c_str());
-
-  size_t numNodes   = 0;
-  size_t numEdges   = 0;
-  size_t lineNumber = 0;
-
+                     char delim = 0) {
   if (skipFirstLine) {
     galois::gWarn(
         "first line is assumed to contain labels and will be ignored\n");
-    skipLine(infile);
-    ++lineNumber;
-  }
-
-  const bool hasDelim = static_cast<bool>(delim);
-  std::optional<size_t> skippedLine;
-  std::string line;
-  char readDelim;
-
-  for (; std::getline(infile, line); ++lineNumber) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      skippedLine = lineNumber;
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      skippedLine = lineNumber;
-      continue;
-    }
-
-    if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          skippedLine = lineNumber;
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        skippedLine = lineNumber;
-        continue;
-      }
-    }
-
-    if (infile) {
-      ++numEdges;
-      if (src > numNodes)
-        numNodes = src;
-      if (dst > numNodes)
-        numNodes = dst;
-    }
   }
 
-  if (skippedLine) {
-    galois::gWarn("ignored at least one line (line ", *skippedLine,
-                  ") because it did not match the expected format\n");
-  }
-
-  numNodes++;
-  p.setNumNodes(numNodes);
-  p.setNumEdges<EdgeTy>(numEdges);
-
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase1();
-
-  if (skipFirstLine) {
-    skipLine(infile);
-  }
-
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
-
-    if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        continue;
-      }
-    }
-
-    if (infile) {
-      p.incrementDegree(src);
-    }
-  }
-
-  infile.clear();
-  infile.seekg(0, std::ios::beg);
-  p.phase2();
-
-  if (skipFirstLine) {
-    skipLine(infile);
-  }
-
-  while (std::getline(infile, line)) {
-    std::stringstream iss(line);
-
-    size_t src;
-    if (!(iss >> src)) {
-      continue;
-    }
-
-    if (hasDelim) {
-      if (!(iss >> readDelim) || readDelim != delim) {
-        continue;
-      }
-    }
-
-    size_t dst;
-    if (!(iss >> dst)) {
-      continue;
-    }
-
-    if constexpr (!std::is_void<EdgeTy>::value) {
-      EdgeTy data{};
-      if (hasDelim) {
-        if (!(iss >> readDelim) || readDelim != delim) {
-          continue;
-        }
-      }
-
-      if (!(iss >> data)) {
-        continue;
-      }
-
-      if (infile) {
-        p.addNeighbor<EdgeTy>(src, dst, data);
-      }
-    } else {
-      if (infile) {
-        p.addNeighbor(src, dst);
-      }
-    }
-  }
-
-  p.finish();
-
+  galois::graphs::FileGraphWriter p;
+  galois::graphs::readEdgeList<EdgeTy>(p, infilename, skipFirstLine, delim);
   p.toFile(outfilename);
-  printStatus(numNodes, numEdges);
-}
-
-template <typename EdgeTy>
-void convertEdgelist(const std::string& infilename,
-                     const std::string& outfilename, const bool skipFirstLine) {
-  convertEdgelist<EdgeTy>(infilename, outfilename, skipFirstLine,
-                          std::optional<char>());
+  printStatus(p.size(), p.sizeEdges());
 }
 
 /**
@@ -2696,6 +2535,30 @@ struct Gr2Metis : public HasOnlyVoidSpecialization {
   }
 };
 
+/**
+ * GR to the compressed adjacency format read by LC_Compressed_Graph.
+ * Neighbors are sorted and delta/varint encoded; see
+ * LC_Compressed_Graph::toFile for the layout.
+ */
+struct Gr2Compressed : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::graphs::LC_Compressed_Graph<void, EdgeTy> Graph;
+
+    galois::graphs::FileGraph fileGraph;
+    fileGraph.fromFile(infilename);
+
+    Graph graph;
+    galois::graphs::readGraph(graph, fileGraph);
+    graph.toFile(outfilename);
+
+    std::cout << "Compressed " << graph.sizeEdges() * sizeof(uint32_t)
+              << " bytes of destinations into " << graph.sizeEdgeBytes()
+              << " bytes\n";
+    printStatus(graph.size(), graph.sizeEdges());
+  }
+};
+
 /**
  * GR to Binary Sparse MATLAB matrix.
  * [i, j, v] = find(A);
@@ -2889,6 +2752,7 @@ struct Svmlight2Gr : public HasNoVoidSpecialization {
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  galois::setActiveThreads(numThreads);
   std::ios_base::sync_with_stdio(false);
   switch (convertMode) {
   case bipartitegr2bigpetsc:
@@ -2924,6 +2788,9 @@ int main(int argc, char** argv) {
   case gr2cgr:
     convert<Cleanup>();
     break;
+  case gr2compressedgr:
+    convert<Gr2Compressed>();
+    break;
   case gr2dimacs:
     convert<Gr2Dimacs>();
     break;